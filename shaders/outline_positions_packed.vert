@@ -0,0 +1,48 @@
+#version 450
+
+layout (location = 0) in vec4 packedPosition;
+layout (location = 1) in vec2 packedNormal;
+
+
+struct PointLight
+{
+    vec4 position;
+    vec4 color;
+};
+
+layout(set = 0, binding = 0) uniform GlobalUbo{
+    mat4 projection;
+    mat4 view;
+    mat4 invView;
+    vec4 ambientLightColor;
+    PointLight pointLights[10];
+    float outlineWidth;
+    int numLights;
+}ubo;
+
+layout (push_constant) uniform Push
+{
+    mat4 modelMatrix;
+    mat4 normalMatrix;
+}push;
+
+// octahedral normal back to a unit vector
+vec3 decodeNormal(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+    {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
+void main()
+{
+    // normalMatrix[3] carries the model's dequantization: offset in xyz, uniform scale in w
+    vec3 position = push.normalMatrix[3].xyz + packedPosition.xyz * push.normalMatrix[3].w;
+    vec3 normal = decodeNormal(packedNormal);
+    vec3 fragNormalWorld = normalize(mat3(push.normalMatrix) * normal);
+    vec4 pos = push.modelMatrix * vec4(position.xyz + fragNormalWorld * ubo.outlineWidth, 1.f);
+    gl_Position = ubo.projection * ubo.view * pos;
+}
\ No newline at end of file
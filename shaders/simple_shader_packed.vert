@@ -0,0 +1,58 @@
+#version 450
+
+layout (location = 0) in vec4 packedPosition;
+layout (location = 1) in vec4 packedColor;
+layout (location = 2) in vec2 packedNormal;
+layout (location = 3) in vec2 packedUv;
+
+layout (location = 0) out vec3 fragColor;
+layout (location = 1) out vec3 fragPosWorld;
+layout (location = 2) out vec3 fragNormalWorld;
+layout (location = 3) out vec2 fragTexCoord;
+
+struct PointLight
+{
+    vec4 position;
+    vec4 color;
+};
+
+layout(set = 0, binding = 0) uniform GlobalUbo{
+    mat4 projection;
+    mat4 view;
+    mat4 invView;
+    vec4 ambientLightColor;
+    PointLight pointLights[10];
+    float outlineWidth;
+    int numLights;
+}ubo;
+
+layout (push_constant) uniform Push
+{
+    mat4 modelMatrix;
+    mat4 normalMatrix;
+}push;
+
+// octahedral normal back to a unit vector
+vec3 decodeNormal(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+    {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
+void main()
+{
+    // normalMatrix[3] carries the model's dequantization: offset in xyz, uniform scale in w
+    vec3 position = push.normalMatrix[3].xyz + packedPosition.xyz * push.normalMatrix[3].w;
+    vec3 normal = decodeNormal(packedNormal);
+    vec4 positionWorld = push.modelMatrix * vec4(position, 1.0f);
+    gl_Position = ubo.projection * ubo.view * positionWorld;
+
+    fragNormalWorld = normalize(mat3(push.normalMatrix) * normal);
+    fragPosWorld = positionWorld.xyz;
+    fragColor = packedColor.rgb;
+    fragTexCoord = packedUv;
+}
\ No newline at end of file
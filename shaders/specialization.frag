@@ -7,7 +7,10 @@ layout (location = 1) in vec3 fragPosWorld;
 layout (location = 2) in vec3 fragNormalWorld;
 layout (location = 3) in vec2 fragTexCoord;
 
-layout (binding = 1) uniform sampler2D texSampler;
+layout (constant_id = 8) const int TEXTURE_COUNT = 1;
+// the set holds only the object's texture where the device can't index sampler arrays dynamically
+layout (constant_id = 9) const bool PER_OBJECT_TEXTURES = false;
+layout (set = 1, binding = 0) uniform sampler2D textures[TEXTURE_COUNT];
 
 struct PointLight
 {
@@ -28,6 +31,7 @@ layout(set = 0, binding = 0) uniform GlobalUbo{
 layout (push_constant) uniform Push
 {
     mat4 modelMatrix;
+    // normalMatrix[2][3] holds the texture index
     mat4 normalMatrix;
 }push;
 
@@ -125,7 +129,9 @@ void main()
                 blinnTerm = pow(blinnTerm, 512.0);
                 specularLight += intensity * blinnTerm;
             }
-            vec3 textureColor = texture(texSampler, fragTexCoord).xyz;
+            int textureIndex = int(push.normalMatrix[2][3]);
+            vec3 textureColor = PER_OBJECT_TEXTURES ? texture(textures[0], fragTexCoord).xyz
+                                                    : texture(textures[textureIndex], fragTexCoord).xyz;
             outColor = vec4(diffuseLight * textureColor + specularLight * textureColor, 1.0);
         }
     }
@@ -7,7 +7,6 @@ layout (location = 1) in vec3 fragPosWorld;
 layout (location = 2) in vec3 fragNormalWorld;
 layout (location = 3) in vec2 fragTexCoord;
 
-layout (binding = 1) uniform sampler2D texSampler;
 
 struct PointLight
 {
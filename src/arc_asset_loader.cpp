@@ -0,0 +1,176 @@
+#include "arc_asset_loader.hpp"
+
+// std
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace arc
+{
+    ArcAssetLoader::ArcAssetLoader(ArcDevice &device, ArcGeometryArena &arena, uint32_t workerThreads)
+        : arcDevice{device}, geometryArena{arena}
+    {
+        // leave a core to the render thread
+        if (workerThreads == 0)
+        {
+            workerThreads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+        }
+
+        workers.reserve(workerThreads);
+        for (uint32_t i = 0; i < workerThreads; ++i)
+        {
+            workers.emplace_back(&ArcAssetLoader::workerLoop, this);
+        }
+    }
+
+    ArcAssetLoader::~ArcAssetLoader()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            stopping = true;
+            parseQueue.clear();
+        }
+        workAvailable.notify_all();
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+
+        // staging memory may still be in use by the GPU
+        retireUploads(true);
+    }
+
+    std::shared_ptr<ArcModel> ArcAssetLoader::loadModelAsync(const std::string &filepath, ArcModel::Builder builder)
+    {
+        std::shared_ptr<ArcModel> model{new ArcModel{arcDevice, geometryArena}};
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            parseQueue.push_back({model, filepath, std::move(builder), std::chrono::high_resolution_clock::now()});
+        }
+        workAvailable.notify_one();
+        return model;
+    }
+
+    void ArcAssetLoader::update()
+    {
+        retireUploads(false);
+        submitParsed();
+    }
+
+    void ArcAssetLoader::waitIdle()
+    {
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            workDone.wait(lock, [&]()
+                          { return parseQueue.empty() && parsing == 0; });
+        }
+        submitParsed();
+        retireUploads(true);
+    }
+
+    size_t ArcAssetLoader::pendingCount() const
+    {
+        size_t count = 0;
+        for (const auto &upload : uploads)
+        {
+            count += upload.jobs.size();
+        }
+
+        std::lock_guard<std::mutex> lock{mutex};
+        return count + parseQueue.size() + parsing + parsed.size();
+    }
+
+    void ArcAssetLoader::workerLoop()
+    {
+        while (true)
+        {
+            LoadJob job{};
+            {
+                std::unique_lock<std::mutex> lock{mutex};
+                workAvailable.wait(lock, [&]()
+                                   { return stopping || !parseQueue.empty(); });
+                if (stopping)
+                    return;
+
+                job = std::move(parseQueue.front());
+                parseQueue.pop_front();
+                parsing++;
+            }
+
+            // a model that fails to load stays not ready, the rest of the scene keeps going
+            bool loaded = true;
+            try
+            {
+                job.builder.loadModel(job.filepath);
+            }
+            catch (const std::exception &e)
+            {
+                std::cout << "Failed to load " << job.filepath << ": " << e.what() << '\n';
+                job.model->failed = true;
+                loaded = false;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                parsing--;
+                if (loaded)
+                {
+                    parsed.push_back(std::move(job));
+                }
+            }
+            workDone.notify_all();
+        }
+    }
+
+    void ArcAssetLoader::submitParsed()
+    {
+        std::vector<LoadJob> jobs{};
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            jobs.swap(parsed);
+        }
+        if (jobs.empty())
+            return;
+
+        // every model parsed since the last frame goes into one upload batch
+        Upload upload{};
+        upload.batch = std::make_unique<ArcUploadBatch>(arcDevice);
+        for (auto &job : jobs)
+        {
+            job.model->recordUpload(job.builder, *upload.batch);
+            // the geometry lives on the GPU from here on
+            job.builder = ArcModel::Builder{};
+        }
+        upload.batch->submit();
+
+        upload.jobs = std::move(jobs);
+        uploads.push_back(std::move(upload));
+    }
+
+    void ArcAssetLoader::retireUploads(bool wait)
+    {
+        for (auto it = uploads.begin(); it != uploads.end();)
+        {
+            if (wait)
+            {
+                it->batch->wait();
+            }
+            else if (!it->batch->isComplete())
+            {
+                ++it;
+                continue;
+            }
+
+            auto now = std::chrono::high_resolution_clock::now();
+            for (auto &job : it->jobs)
+            {
+                job.model->ready = true;
+                std::cout << "Model " << job.filepath << " ready "
+                          << std::chrono::duration<double, std::milli>(now - job.requestTime).count()
+                          << " ms after request\n";
+            }
+
+            it = uploads.erase(it);
+        }
+    }
+}
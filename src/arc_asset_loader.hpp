@@ -0,0 +1,85 @@
+#ifndef __ARC_ASSET_LOADER_H__
+#define __ARC_ASSET_LOADER_H__
+
+#include "arc_device.hpp"
+#include "arc_model.hpp"
+#include "arc_upload_batch.hpp"
+
+// std
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace arc
+{
+    // Loads models in the background
+    // worker threads parse the files, update() on the render thread batches the finished ones
+    // into one upload per frame and hands a model over once that upload's fence signaled
+    class ArcAssetLoader
+    {
+    public:
+        // workerThreads 0 picks one less than the hardware concurrency
+        // models are suballocated from arena, which has to outlive them
+        ArcAssetLoader(ArcDevice &device, ArcGeometryArena &arena, uint32_t workerThreads = 0);
+        ~ArcAssetLoader();
+
+        ArcAssetLoader(const ArcAssetLoader &) = delete;
+        ArcAssetLoader &operator=(const ArcAssetLoader &) = delete;
+
+        // returns right away, the model is drawable once isReady() turns true
+        // builder carries the load options, its geometry is filled in by the worker
+        std::shared_ptr<ArcModel> loadModelAsync(const std::string &filepath, ArcModel::Builder builder = {});
+
+        // call once per frame from the thread that submits to the graphics queue
+        void update();
+
+        // blocks until every requested model is ready or failed
+        void waitIdle();
+
+        // models requested but not ready yet
+        size_t pendingCount() const;
+
+    private:
+        struct LoadJob
+        {
+            std::shared_ptr<ArcModel> model;
+            std::string filepath;
+            ArcModel::Builder builder;
+            std::chrono::high_resolution_clock::time_point requestTime;
+        };
+
+        struct Upload
+        {
+            std::vector<LoadJob> jobs{};
+            std::unique_ptr<ArcUploadBatch> batch{};
+        };
+
+        void workerLoop();
+        void submitParsed();
+        void retireUploads(bool wait);
+
+        ArcDevice &arcDevice;
+        ArcGeometryArena &geometryArena;
+
+        std::vector<std::thread> workers{};
+        mutable std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable workDone;
+        bool stopping = false;
+
+        // guarded by mutex
+        std::deque<LoadJob> parseQueue{};
+        std::vector<LoadJob> parsed{};
+        size_t parsing = 0;
+
+        // render thread only
+        std::vector<Upload> uploads{};
+    };
+}
+
+#endif // __ARC_ASSET_LOADER_H__
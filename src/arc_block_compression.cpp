@@ -0,0 +1,710 @@
+#include "arc_block_compression.hpp"
+
+// std
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ARC_BLOCK_COMPRESSION_SSE
+#include <emmintrin.h>
+#endif
+
+namespace arc
+{
+    namespace
+    {
+        // one 4x4 block as structure of arrays, so four texels of a channel fill one SSE register
+        struct BlockTexels
+        {
+            alignas(16) float channels[4][16];
+        };
+
+        // palette entries in the same channel order, at most the 16 of BC7 mode 6
+        struct Palette
+        {
+            float colors[16][4];
+            int size;
+        };
+
+        // BC7 4-bit index interpolation weights, out of 64
+        constexpr int BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        class BitWriter
+        {
+        public:
+            explicit BitWriter(uint8_t *out) : out{out} {}
+
+            void write(uint32_t value, int bits)
+            {
+                for (int i = 0; i < bits; ++i, ++position)
+                {
+                    out[position >> 3] |= static_cast<uint8_t>(((value >> i) & 1u) << (position & 7));
+                }
+            }
+
+        private:
+            uint8_t *out;
+            int position = 0;
+        };
+
+        class BitReader
+        {
+        public:
+            explicit BitReader(const uint8_t *in) : in{in} {}
+
+            uint32_t read(int bits)
+            {
+                uint32_t value = 0;
+                for (int i = 0; i < bits; ++i, ++position)
+                {
+                    value |= static_cast<uint32_t>((in[position >> 3] >> (position & 7)) & 1u) << i;
+                }
+                return value;
+            }
+
+        private:
+            const uint8_t *in;
+            int position = 0;
+        };
+
+        void gatherBlock(const uint8_t *rgba, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY,
+                         BlockTexels &block)
+        {
+            for (uint32_t y = 0; y < 4; ++y)
+            {
+                uint32_t row = std::min(blockY * 4 + y, height - 1);
+                for (uint32_t x = 0; x < 4; ++x)
+                {
+                    uint32_t column = std::min(blockX * 4 + x, width - 1);
+                    const uint8_t *texel = rgba + (static_cast<size_t>(row) * width + column) * 4;
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        block.channels[c][y * 4 + x] = texel[c];
+                    }
+                }
+            }
+        }
+
+        // nearest palette entry of every texel over the first channelCount channels, returns the summed squared error
+        float selectIndices(const BlockTexels &block, const Palette &palette, int channelCount, uint8_t indices[16])
+        {
+            float total = 0.0f;
+#ifdef ARC_BLOCK_COMPRESSION_SSE
+            for (int t = 0; t < 16; t += 4)
+            {
+                __m128 best = _mm_set1_ps(FLT_MAX);
+                __m128i bestIndex = _mm_setzero_si128();
+                for (int k = 0; k < palette.size; ++k)
+                {
+                    __m128 error = _mm_setzero_ps();
+                    for (int c = 0; c < channelCount; ++c)
+                    {
+                        __m128 d = _mm_sub_ps(_mm_load_ps(&block.channels[c][t]), _mm_set1_ps(palette.colors[k][c]));
+                        error = _mm_add_ps(error, _mm_mul_ps(d, d));
+                    }
+                    __m128i closer = _mm_castps_si128(_mm_cmplt_ps(error, best));
+                    best = _mm_min_ps(error, best);
+                    bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(k)), _mm_andnot_si128(closer, bestIndex));
+                }
+
+                alignas(16) int32_t lanes[4];
+                alignas(16) float errors[4];
+                _mm_store_si128(reinterpret_cast<__m128i *>(lanes), bestIndex);
+                _mm_store_ps(errors, best);
+                for (int i = 0; i < 4; ++i)
+                {
+                    indices[t + i] = static_cast<uint8_t>(lanes[i]);
+                    total += errors[i];
+                }
+            }
+#else
+            for (int t = 0; t < 16; ++t)
+            {
+                float best = FLT_MAX;
+                for (int k = 0; k < palette.size; ++k)
+                {
+                    float error = 0.0f;
+                    for (int c = 0; c < channelCount; ++c)
+                    {
+                        float d = block.channels[c][t] - palette.colors[k][c];
+                        error += d * d;
+                    }
+                    if (error < best)
+                    {
+                        best = error;
+                        indices[t] = static_cast<uint8_t>(k);
+                    }
+                }
+                total += best;
+            }
+#endif
+            return total;
+        }
+
+        // end points of the block's principal axis, found by power iteration on the covariance matrix
+        void fitEndpoints(const BlockTexels &block, int channelCount, float low[4], float high[4])
+        {
+            float mean[4] = {};
+            for (int c = 0; c < channelCount; ++c)
+            {
+                for (int t = 0; t < 16; ++t)
+                {
+                    mean[c] += block.channels[c][t];
+                }
+                mean[c] /= 16.0f;
+            }
+
+            float covariance[4][4] = {};
+            for (int t = 0; t < 16; ++t)
+            {
+                for (int i = 0; i < channelCount; ++i)
+                {
+                    for (int j = i; j < channelCount; ++j)
+                    {
+                        covariance[i][j] += (block.channels[i][t] - mean[i]) * (block.channels[j][t] - mean[j]);
+                    }
+                }
+            }
+            for (int i = 0; i < channelCount; ++i)
+            {
+                for (int j = 0; j < i; ++j)
+                {
+                    covariance[i][j] = covariance[j][i];
+                }
+            }
+
+            float axis[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+            for (int iteration = 0; iteration < 8; ++iteration)
+            {
+                float next[4] = {};
+                float length = 0.0f;
+                for (int i = 0; i < channelCount; ++i)
+                {
+                    for (int j = 0; j < channelCount; ++j)
+                    {
+                        next[i] += covariance[i][j] * axis[j];
+                    }
+                    length = std::max(length, std::abs(next[i]));
+                }
+                if (length < 1e-6f)
+                    break;
+                for (int i = 0; i < channelCount; ++i)
+                {
+                    axis[i] = next[i] / length;
+                }
+            }
+
+            float minProjection = 0.0f;
+            float maxProjection = 0.0f;
+            float axisLength = 0.0f;
+            for (int c = 0; c < channelCount; ++c)
+            {
+                axisLength += axis[c] * axis[c];
+            }
+            if (axisLength > 1e-12f)
+            {
+                minProjection = FLT_MAX;
+                maxProjection = -FLT_MAX;
+                for (int t = 0; t < 16; ++t)
+                {
+                    float projection = 0.0f;
+                    for (int c = 0; c < channelCount; ++c)
+                    {
+                        projection += (block.channels[c][t] - mean[c]) * axis[c];
+                    }
+                    minProjection = std::min(minProjection, projection);
+                    maxProjection = std::max(maxProjection, projection);
+                }
+                minProjection /= axisLength;
+                maxProjection /= axisLength;
+            }
+
+            for (int c = 0; c < channelCount; ++c)
+            {
+                low[c] = std::clamp(mean[c] + axis[c] * minProjection, 0.0f, 255.0f);
+                high[c] = std::clamp(mean[c] + axis[c] * maxProjection, 0.0f, 255.0f);
+            }
+        }
+
+        // end points minimizing the squared error for the chosen indices, weights[i] is how much of high index i takes
+        void refineEndpoints(const BlockTexels &block, int channelCount, const uint8_t indices[16], const float *weights,
+                             float low[4], float high[4])
+        {
+            float lowLow = 0.0f, highHigh = 0.0f, lowHigh = 0.0f;
+            float lowX[4] = {}, highX[4] = {};
+            for (int t = 0; t < 16; ++t)
+            {
+                float w = weights[indices[t]];
+                lowLow += (1.0f - w) * (1.0f - w);
+                highHigh += w * w;
+                lowHigh += (1.0f - w) * w;
+                for (int c = 0; c < channelCount; ++c)
+                {
+                    lowX[c] += (1.0f - w) * block.channels[c][t];
+                    highX[c] += w * block.channels[c][t];
+                }
+            }
+
+            float determinant = lowLow * highHigh - lowHigh * lowHigh;
+            if (std::abs(determinant) < 1e-6f)
+                return;
+            for (int c = 0; c < channelCount; ++c)
+            {
+                low[c] = std::clamp((lowX[c] * highHigh - highX[c] * lowHigh) / determinant, 0.0f, 255.0f);
+                high[c] = std::clamp((highX[c] * lowLow - lowX[c] * lowHigh) / determinant, 0.0f, 255.0f);
+            }
+        }
+
+        uint16_t to565(const float color[3])
+        {
+            auto quantize = [](float value, float levels)
+            { return static_cast<uint16_t>(std::lround(value * levels / 255.0f)); };
+            return static_cast<uint16_t>(quantize(color[0], 31.0f) << 11 | quantize(color[1], 63.0f) << 5 | quantize(color[2], 31.0f));
+        }
+
+        void from565(uint16_t value, int color[3])
+        {
+            int r = value >> 11, g = (value >> 5) & 63, b = value & 31;
+            color[0] = (r << 3) | (r >> 2);
+            color[1] = (g << 2) | (g >> 4);
+            color[2] = (b << 3) | (b >> 2);
+        }
+
+        // 4 color palette, also what BC3 always decodes
+        void colorPalette(uint16_t color0, uint16_t color1, int palette[4][3])
+        {
+            from565(color0, palette[0]);
+            from565(color1, palette[1]);
+            for (int c = 0; c < 3; ++c)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+        }
+
+        void encodeColor(const BlockTexels &block, uint8_t out[8])
+        {
+            // how much of color0 (high) each index takes
+            static const float HIGH_WEIGHTS[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+
+            float low[4], high[4];
+            fitEndpoints(block, 3, low, high);
+
+            float bestError = FLT_MAX;
+            uint16_t bestColors[2] = {};
+            uint8_t bestIndices[16] = {};
+            for (int iteration = 0; iteration < 3; ++iteration)
+            {
+                uint16_t color0 = to565(high);
+                uint16_t color1 = to565(low);
+                int entries[4][3];
+                colorPalette(color0, color1, entries);
+                Palette palette{{}, 4};
+                for (int k = 0; k < 4; ++k)
+                {
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        palette.colors[k][c] = static_cast<float>(entries[k][c]);
+                    }
+                }
+
+                uint8_t indices[16];
+                float error = selectIndices(block, palette, 3, indices);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestColors[0] = color0;
+                    bestColors[1] = color1;
+                    std::memcpy(bestIndices, indices, sizeof(indices));
+                }
+                if (error == 0.0f)
+                    break;
+                refineEndpoints(block, 3, indices, HIGH_WEIGHTS, low, high);
+            }
+
+            // color0 > color1 selects the 4 color mode, swapping the end points swaps index pairs 0/1 and 2/3
+            if (bestColors[0] < bestColors[1])
+            {
+                std::swap(bestColors[0], bestColors[1]);
+                for (auto &index : bestIndices)
+                {
+                    index ^= 1;
+                }
+            }
+            else if (bestColors[0] == bestColors[1])
+            {
+                std::fill(std::begin(bestIndices), std::end(bestIndices), 0);
+            }
+
+            uint32_t bits = 0;
+            for (int t = 0; t < 16; ++t)
+            {
+                bits |= static_cast<uint32_t>(bestIndices[t]) << (2 * t);
+            }
+            std::memcpy(out, &bestColors[0], 2);
+            std::memcpy(out + 2, &bestColors[1], 2);
+            std::memcpy(out + 4, &bits, 4);
+        }
+
+        void alphaPalette(int alpha0, int alpha1, int palette[8])
+        {
+            palette[0] = alpha0;
+            palette[1] = alpha1;
+            if (alpha0 > alpha1)
+            {
+                for (int i = 2; i < 8; ++i)
+                {
+                    palette[i] = ((8 - i) * alpha0 + (i - 1) * alpha1) / 7;
+                }
+            }
+            else
+            {
+                for (int i = 2; i < 6; ++i)
+                {
+                    palette[i] = ((6 - i) * alpha0 + (i - 1) * alpha1) / 5;
+                }
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+        }
+
+        void encodeAlpha(const BlockTexels &block, uint8_t out[8])
+        {
+            float minAlpha = *std::min_element(block.channels[3], block.channels[3] + 16);
+            float maxAlpha = *std::max_element(block.channels[3], block.channels[3] + 16);
+            int alpha0 = static_cast<int>(std::lround(maxAlpha));
+            int alpha1 = static_cast<int>(std::lround(minAlpha));
+
+            int palette[8];
+            alphaPalette(alpha0, alpha1, palette);
+            uint64_t bits = 0;
+            if (alpha0 != alpha1)
+            {
+                for (int t = 0; t < 16; ++t)
+                {
+                    int bestIndex = 0;
+                    float bestError = FLT_MAX;
+                    for (int k = 0; k < 8; ++k)
+                    {
+                        float error = std::abs(block.channels[3][t] - palette[k]);
+                        if (error < bestError)
+                        {
+                            bestError = error;
+                            bestIndex = k;
+                        }
+                    }
+                    bits |= static_cast<uint64_t>(bestIndex) << (3 * t);
+                }
+            }
+
+            out[0] = static_cast<uint8_t>(alpha0);
+            out[1] = static_cast<uint8_t>(alpha1);
+            for (int i = 0; i < 6; ++i)
+            {
+                out[2 + i] = static_cast<uint8_t>(bits >> (8 * i));
+            }
+        }
+
+        // 7 bits per channel plus a shared low bit, the p bit that rounds the end point closest
+        void quantizeBc7Endpoint(const float endpoint[4], uint8_t channels[4], uint8_t &pBit)
+        {
+            float bestError = FLT_MAX;
+            for (uint8_t p = 0; p < 2; ++p)
+            {
+                uint8_t quantized[4];
+                float error = 0.0f;
+                for (int c = 0; c < 4; ++c)
+                {
+                    long value = std::lround((endpoint[c] - p) / 2.0f);
+                    quantized[c] = static_cast<uint8_t>(std::clamp(value, 0L, 127L));
+                    float d = static_cast<float>((quantized[c] << 1) | p) - endpoint[c];
+                    error += d * d;
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    pBit = p;
+                    std::memcpy(channels, quantized, 4);
+                }
+            }
+        }
+
+        void bc7Palette(const uint8_t channels[2][4], const uint8_t pBits[2], int palette[16][4])
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                int e0 = (channels[0][c] << 1) | pBits[0];
+                int e1 = (channels[1][c] << 1) | pBits[1];
+                for (int k = 0; k < 16; ++k)
+                {
+                    palette[k][c] = ((64 - BC7_WEIGHTS[k]) * e0 + BC7_WEIGHTS[k] * e1 + 32) >> 6;
+                }
+            }
+        }
+
+        void encodeBc7(const BlockTexels &block, uint8_t out[16])
+        {
+            static const float HIGH_WEIGHTS[16] = {
+                0 / 64.0f, 4 / 64.0f, 9 / 64.0f, 13 / 64.0f, 17 / 64.0f, 21 / 64.0f, 26 / 64.0f, 30 / 64.0f,
+                34 / 64.0f, 38 / 64.0f, 43 / 64.0f, 47 / 64.0f, 51 / 64.0f, 55 / 64.0f, 60 / 64.0f, 64 / 64.0f};
+
+            float low[4], high[4];
+            fitEndpoints(block, 4, low, high);
+
+            float bestError = FLT_MAX;
+            uint8_t bestChannels[2][4] = {};
+            uint8_t bestPBits[2] = {};
+            uint8_t bestIndices[16] = {};
+            for (int iteration = 0; iteration < 3; ++iteration)
+            {
+                uint8_t channels[2][4];
+                uint8_t pBits[2];
+                quantizeBc7Endpoint(low, channels[0], pBits[0]);
+                quantizeBc7Endpoint(high, channels[1], pBits[1]);
+
+                int entries[16][4];
+                bc7Palette(channels, pBits, entries);
+                Palette palette{{}, 16};
+                for (int k = 0; k < 16; ++k)
+                {
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        palette.colors[k][c] = static_cast<float>(entries[k][c]);
+                    }
+                }
+
+                uint8_t indices[16];
+                float error = selectIndices(block, palette, 4, indices);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    std::memcpy(bestChannels, channels, sizeof(channels));
+                    std::memcpy(bestPBits, pBits, sizeof(pBits));
+                    std::memcpy(bestIndices, indices, sizeof(indices));
+                }
+                if (error == 0.0f)
+                    break;
+                refineEndpoints(block, 4, indices, HIGH_WEIGHTS, low, high);
+            }
+
+            // the first texel's index drops its top bit, so it has to be in the lower half
+            if (bestIndices[0] & 8)
+            {
+                std::swap(bestChannels[0], bestChannels[1]);
+                std::swap(bestPBits[0], bestPBits[1]);
+                for (auto &index : bestIndices)
+                {
+                    index = static_cast<uint8_t>(15 - index);
+                }
+            }
+
+            std::memset(out, 0, 16);
+            BitWriter writer{out};
+            writer.write(1u << 6, 7);
+            for (int c = 0; c < 4; ++c)
+            {
+                writer.write(bestChannels[0][c], 7);
+                writer.write(bestChannels[1][c], 7);
+            }
+            writer.write(bestPBits[0], 1);
+            writer.write(bestPBits[1], 1);
+            for (int t = 0; t < 16; ++t)
+            {
+                writer.write(bestIndices[t], t == 0 ? 3 : 4);
+            }
+        }
+
+        void decodeColor(const uint8_t in[8], uint8_t texels[16][4], bool alwaysFourColors)
+        {
+            uint16_t color0, color1;
+            uint32_t bits;
+            std::memcpy(&color0, in, 2);
+            std::memcpy(&color1, in + 2, 2);
+            std::memcpy(&bits, in + 4, 4);
+
+            int palette[4][3];
+            colorPalette(color0, color1, palette);
+            if (!alwaysFourColors && color0 <= color1)
+            {
+                // 3 color mode, the fourth entry is black
+                for (int c = 0; c < 3; ++c)
+                {
+                    palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                    palette[3][c] = 0;
+                }
+            }
+
+            for (int t = 0; t < 16; ++t)
+            {
+                const int *color = palette[(bits >> (2 * t)) & 3];
+                texels[t][0] = static_cast<uint8_t>(color[0]);
+                texels[t][1] = static_cast<uint8_t>(color[1]);
+                texels[t][2] = static_cast<uint8_t>(color[2]);
+                texels[t][3] = 255;
+            }
+        }
+
+        void decodeAlpha(const uint8_t in[8], uint8_t texels[16][4])
+        {
+            int palette[8];
+            alphaPalette(in[0], in[1], palette);
+            uint64_t bits = 0;
+            for (int i = 0; i < 6; ++i)
+            {
+                bits |= static_cast<uint64_t>(in[2 + i]) << (8 * i);
+            }
+            for (int t = 0; t < 16; ++t)
+            {
+                texels[t][3] = static_cast<uint8_t>(palette[(bits >> (3 * t)) & 7]);
+            }
+        }
+
+        void decodeBc7(const uint8_t in[16], uint8_t texels[16][4])
+        {
+            // mode 6 is the only one with six zero bits before the first set bit
+            if ((in[0] & 0x7f) != 0x40)
+            {
+                int mode = 0;
+                while (mode < 8 && !(in[0] & (1 << mode)))
+                {
+                    mode++;
+                }
+                throw std::runtime_error("BC7 mode " + std::to_string(mode) + " blocks can only be sampled by the GPU!");
+            }
+
+            BitReader reader{in};
+            reader.read(7);
+            uint8_t channels[2][4];
+            for (int c = 0; c < 4; ++c)
+            {
+                channels[0][c] = static_cast<uint8_t>(reader.read(7));
+                channels[1][c] = static_cast<uint8_t>(reader.read(7));
+            }
+            uint8_t pBits[2];
+            pBits[0] = static_cast<uint8_t>(reader.read(1));
+            pBits[1] = static_cast<uint8_t>(reader.read(1));
+
+            int palette[16][4];
+            bc7Palette(channels, pBits, palette);
+            for (int t = 0; t < 16; ++t)
+            {
+                uint32_t index = reader.read(t == 0 ? 3 : 4);
+                for (int c = 0; c < 4; ++c)
+                {
+                    texels[t][c] = static_cast<uint8_t>(palette[index][c]);
+                }
+            }
+        }
+    }
+
+    uint32_t blockBytes(BlockFormat format)
+    {
+        return format == BlockFormat::BC1 ? 8 : 16;
+    }
+
+    size_t compressedSize(BlockFormat format, uint32_t width, uint32_t height)
+    {
+        return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * blockBytes(format);
+    }
+
+    std::vector<uint8_t> compressBlocks(const uint8_t *rgba, uint32_t width, uint32_t height, BlockFormat format,
+                                        uint32_t workerThreads)
+    {
+        uint32_t blocksX = (width + 3) / 4;
+        uint32_t blocksY = (height + 3) / 4;
+        uint32_t bytes = blockBytes(format);
+        std::vector<uint8_t> blocks(compressedSize(format, width, height));
+
+        auto compressRows = [&](uint32_t firstRow, uint32_t rowStep)
+        {
+            BlockTexels block{};
+            for (uint32_t y = firstRow; y < blocksY; y += rowStep)
+            {
+                for (uint32_t x = 0; x < blocksX; ++x)
+                {
+                    gatherBlock(rgba, width, height, x, y, block);
+                    uint8_t *out = blocks.data() + (static_cast<size_t>(y) * blocksX + x) * bytes;
+                    switch (format)
+                    {
+                    case BlockFormat::BC1:
+                        encodeColor(block, out);
+                        break;
+                    case BlockFormat::BC3:
+                        encodeAlpha(block, out);
+                        encodeColor(block, out + 8);
+                        break;
+                    case BlockFormat::BC7:
+                        encodeBc7(block, out);
+                        break;
+                    }
+                }
+            }
+        };
+
+        uint32_t threadCount = workerThreads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : workerThreads;
+        threadCount = std::min(threadCount, blocksY);
+        if (threadCount <= 1)
+        {
+            compressRows(0, 1);
+            return blocks;
+        }
+
+        // rows are interleaved so every thread gets a similar mix of flat and detailed areas
+        std::vector<std::thread> threads{};
+        for (uint32_t t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back(compressRows, t, threadCount);
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        return blocks;
+    }
+
+    std::vector<uint8_t> decompressBlocks(const uint8_t *blocks, uint32_t width, uint32_t height, BlockFormat format)
+    {
+        uint32_t blocksX = (width + 3) / 4;
+        uint32_t blocksY = (height + 3) / 4;
+        uint32_t bytes = blockBytes(format);
+        std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+
+        uint8_t texels[16][4];
+        for (uint32_t by = 0; by < blocksY; ++by)
+        {
+            for (uint32_t bx = 0; bx < blocksX; ++bx)
+            {
+                const uint8_t *in = blocks + (static_cast<size_t>(by) * blocksX + bx) * bytes;
+                switch (format)
+                {
+                case BlockFormat::BC1:
+                    decodeColor(in, texels, false);
+                    break;
+                case BlockFormat::BC3:
+                    decodeColor(in + 8, texels, true);
+                    decodeAlpha(in, texels);
+                    break;
+                case BlockFormat::BC7:
+                    decodeBc7(in, texels);
+                    break;
+                }
+
+                // edge blocks only write the texels inside the image
+                for (uint32_t y = 0; y < 4 && by * 4 + y < height; ++y)
+                {
+                    for (uint32_t x = 0; x < 4 && bx * 4 + x < width; ++x)
+                    {
+                        size_t offset = (static_cast<size_t>(by * 4 + y) * width + bx * 4 + x) * 4;
+                        std::memcpy(rgba.data() + offset, texels[y * 4 + x], 4);
+                    }
+                }
+            }
+        }
+        return rgba;
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef __ARC_BLOCK_COMPRESSION_H__
+#define __ARC_BLOCK_COMPRESSION_H__
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace arc
+{
+    // 4x4 texel block formats, stored in the same byte order Vulkan reads them
+    enum class BlockFormat
+    {
+        BC1, // 8 bytes, opaque RGB
+        BC3, // 16 bytes, RGB with interpolated alpha
+        BC7  // 16 bytes, RGBA, written in mode 6 only
+    };
+
+    uint32_t blockBytes(BlockFormat format);
+    // bytes of a width x height level, partial blocks at the edges count as whole ones
+    size_t compressedSize(BlockFormat format, uint32_t width, uint32_t height);
+
+    // Compresses tightly packed RGBA8 texels, edge blocks repeat the last row and column
+    // endpoints are fitted along the principal axis of each block and refined by least squares,
+    // the nearest palette entry per texel is searched four texels at a time with SSE2 where available
+    // rows of blocks are split across workerThreads, 0 picks the hardware concurrency
+    std::vector<uint8_t> compressBlocks(const uint8_t *rgba, uint32_t width, uint32_t height, BlockFormat format,
+                                        uint32_t workerThreads = 0);
+
+    // Back to RGBA8 for devices without BC support
+    // BC7 blocks in any mode other than 6 throw, they only come from other encoders
+    std::vector<uint8_t> decompressBlocks(const uint8_t *blocks, uint32_t width, uint32_t height, BlockFormat format);
+}
+
+#endif // __ARC_BLOCK_COMPRESSION_H__
@@ -0,0 +1,126 @@
+#include "arc_bounds.hpp"
+
+// std
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ARC_BOUNDS_SSE
+#include <emmintrin.h>
+#endif
+
+namespace arc
+{
+    namespace
+    {
+#ifdef ARC_BOUNDS_SSE
+        // xyz into the low three lanes without touching the bytes after z
+        inline __m128 loadPosition(const float *position)
+        {
+            __m128 xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double *>(position)));
+            __m128 z = _mm_load_ss(position + 2);
+            return _mm_movelh_ps(xy, z);
+        }
+#endif
+
+        inline const float *positionAt(const float *positions, size_t stride, size_t i)
+        {
+            return reinterpret_cast<const float *>(reinterpret_cast<const uint8_t *>(positions) + i * stride);
+        }
+    }
+
+    Bounds computeBounds(const float *positions, size_t stride, size_t count)
+    {
+        Bounds bounds{};
+        if (count == 0)
+            return bounds;
+
+#ifdef ARC_BOUNDS_SSE
+        // two accumulators per bound hide the latency of the min/max chain
+        __m128 min0 = loadPosition(positions);
+        __m128 max0 = min0;
+        __m128 min1 = min0;
+        __m128 max1 = min0;
+        size_t i = 1;
+        for (; i + 2 <= count; i += 2)
+        {
+            __m128 p0 = loadPosition(positionAt(positions, stride, i));
+            __m128 p1 = loadPosition(positionAt(positions, stride, i + 1));
+            min0 = _mm_min_ps(min0, p0);
+            max0 = _mm_max_ps(max0, p0);
+            min1 = _mm_min_ps(min1, p1);
+            max1 = _mm_max_ps(max1, p1);
+        }
+        if (i < count)
+        {
+            __m128 p = loadPosition(positionAt(positions, stride, i));
+            min0 = _mm_min_ps(min0, p);
+            max0 = _mm_max_ps(max0, p);
+        }
+        alignas(16) float minLanes[4];
+        alignas(16) float maxLanes[4];
+        _mm_store_ps(minLanes, _mm_min_ps(min0, min1));
+        _mm_store_ps(maxLanes, _mm_max_ps(max0, max1));
+        bounds.min = glm::vec3{minLanes[0], minLanes[1], minLanes[2]};
+        bounds.max = glm::vec3{maxLanes[0], maxLanes[1], maxLanes[2]};
+
+        // farthest point from the box center, the fourth lane is always zero
+        glm::vec3 center = bounds.center();
+        __m128 c = _mm_setr_ps(center.x, center.y, center.z, 0.0f);
+        __m128 maxDistance = _mm_setzero_ps();
+        for (i = 0; i < count; ++i)
+        {
+            __m128 d = _mm_sub_ps(loadPosition(positionAt(positions, stride, i)), c);
+            d = _mm_mul_ps(d, d);
+            __m128 sum = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)));
+            sum = _mm_add_ss(sum, _mm_movehl_ps(d, d));
+            maxDistance = _mm_max_ss(maxDistance, sum);
+        }
+        float radiusSquared = _mm_cvtss_f32(maxDistance);
+#else
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float *p = positionAt(positions, stride, i);
+            glm::vec3 position{p[0], p[1], p[2]};
+            bounds.min = glm::min(bounds.min, position);
+            bounds.max = glm::max(bounds.max, position);
+        }
+
+        glm::vec3 center = bounds.center();
+        float radiusSquared = 0.0f;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float *p = positionAt(positions, stride, i);
+            glm::vec3 d = glm::vec3{p[0], p[1], p[2]} - center;
+            radiusSquared = glm::max(radiusSquared, glm::dot(d, d));
+        }
+#endif
+
+        bounds.sphere = glm::vec4{center, glm::sqrt(radiusSquared)};
+        return bounds;
+    }
+
+    Bounds transformBounds(const Bounds &bounds, const glm::mat4 &transform)
+    {
+        if (!bounds.isValid())
+            return bounds;
+
+        glm::vec3 center{transform * glm::vec4{bounds.center(), 1.0f}};
+        glm::vec3 extent = bounds.extent();
+
+        // each world axis collects the absolute contribution of every local axis
+        glm::vec3 worldExtent{0.0f};
+        for (int column = 0; column < 3; ++column)
+        {
+            worldExtent += glm::abs(glm::vec3{transform[column]}) * extent[column];
+        }
+
+        float scale = glm::max(glm::length(glm::vec3{transform[0]}),
+                               glm::max(glm::length(glm::vec3{transform[1]}), glm::length(glm::vec3{transform[2]})));
+
+        Bounds result{};
+        result.min = center - worldExtent;
+        result.max = center + worldExtent;
+        result.sphere = glm::vec4{glm::vec3{transform * glm::vec4{glm::vec3{bounds.sphere}, 1.0f}}, bounds.sphere.w * scale};
+        return result;
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef __ARC_BOUNDS_H__
+#define __ARC_BOUNDS_H__
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <cfloat>
+#include <cstddef>
+
+namespace arc
+{
+    // Axis aligned box and a sphere around the same geometry, used for culling, lod selection and picking
+    struct Bounds
+    {
+        glm::vec3 min{FLT_MAX};
+        glm::vec3 max{-FLT_MAX};
+        // center (xyz) and radius (w), centered on the box and as tight as that center allows
+        glm::vec4 sphere{0.0f};
+
+        // false until some point was added
+        bool isValid() const { return min.x <= max.x; }
+        glm::vec3 center() const { return (min + max) * 0.5f; }
+        glm::vec3 extent() const { return (max - min) * 0.5f; }
+    };
+
+    // min/max reduction over interleaved positions, stride in bytes between consecutive xyz triples
+    Bounds computeBounds(const float *positions, size_t stride, size_t count);
+
+    // Arvo's method, the box stays tight under rotation around the transformed center
+    // the sphere radius grows with the largest axis scale
+    Bounds transformBounds(const Bounds &bounds, const glm::mat4 &transform);
+}
+
+#endif // __ARC_BOUNDS_H__
@@ -110,4 +110,16 @@ namespace arc
         inverseViewMatrix[3][2] = position.z;
     }
 
-}
\ No newline at end of file
+    float ArcCamera::projectedRadius(glm::vec3 center, float radius) const
+    {
+        // orthographic projections don't shrink with distance
+        if (projectionMatrix[2][3] == 0.0f)
+            return radius * projectionMatrix[1][1];
+
+        float depth = glm::dot(glm::vec3{viewMatrix[0][2], viewMatrix[1][2], viewMatrix[2][2]}, center) + viewMatrix[3][2];
+        // a sphere around the camera covers the whole screen
+        if (depth <= radius)
+            return std::numeric_limits<float>::max();
+        return radius * projectionMatrix[1][1] / depth;
+    }
+}
@@ -24,6 +24,9 @@ namespace arc
         const glm::mat4 &getInverseView() const { return inverseViewMatrix; }
         const glm::vec3 getPosition() const { return glm::vec3(inverseViewMatrix[3]); }
 
+        // radius of a world space sphere after projection, in NDC units (the screen is 2 units high)
+        float projectedRadius(glm::vec3 center, float radius) const;
+
     private:
         glm::mat4 projectionMatrix{1.0f};
         glm::mat4 viewMatrix{1.0f};
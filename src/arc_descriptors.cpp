@@ -13,7 +13,8 @@ namespace arc
         uint32_t binding,
         VkDescriptorType descriptorType,
         VkShaderStageFlags stageFlags,
-        uint32_t count)
+        uint32_t count,
+        VkDescriptorBindingFlags flags)
     {
         assert(bindings.count(binding) == 0 && "Binding already in use");
         VkDescriptorSetLayoutBinding layoutBinding{};
@@ -22,28 +23,53 @@ namespace arc
         layoutBinding.descriptorCount = count;
         layoutBinding.stageFlags = stageFlags;
         bindings[binding] = layoutBinding;
+        if (flags != 0)
+        {
+            bindingFlags[binding] = flags;
+        }
+        return *this;
+    }
+
+    ArcDescriptorSetLayout::Builder &ArcDescriptorSetLayout::Builder::setLayoutFlags(
+        VkDescriptorSetLayoutCreateFlags flags)
+    {
+        layoutFlags = flags;
         return *this;
     }
 
     std::unique_ptr<ArcDescriptorSetLayout> ArcDescriptorSetLayout::Builder::build() const
     {
-        return std::make_unique<ArcDescriptorSetLayout>(arcDevice, bindings);
+        return std::make_unique<ArcDescriptorSetLayout>(arcDevice, bindings, bindingFlags, layoutFlags);
     }
 
     // *************** Descriptor Set Layout *********************
 
     ArcDescriptorSetLayout::ArcDescriptorSetLayout(
-        ArcDevice &arcDevice, std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings)
+        ArcDevice &arcDevice,
+        std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings,
+        std::unordered_map<uint32_t, VkDescriptorBindingFlags> bindingFlags,
+        VkDescriptorSetLayoutCreateFlags layoutFlags)
         : arcDevice{arcDevice}, bindings{bindings}
     {
         std::vector<VkDescriptorSetLayoutBinding> setLayoutBindings{};
+        // flags are given per binding, in the same order as the bindings
+        std::vector<VkDescriptorBindingFlags> setLayoutBindingFlags{};
         for (auto kv : bindings)
         {
             setLayoutBindings.push_back(kv.second);
+            auto flags = bindingFlags.find(kv.first);
+            setLayoutBindingFlags.push_back(flags == bindingFlags.end() ? 0 : flags->second);
         }
 
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+        bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        bindingFlagsInfo.bindingCount = static_cast<uint32_t>(setLayoutBindingFlags.size());
+        bindingFlagsInfo.pBindingFlags = setLayoutBindingFlags.data();
+
         VkDescriptorSetLayoutCreateInfo descriptorSetLayoutInfo{};
         descriptorSetLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        descriptorSetLayoutInfo.pNext = bindingFlags.empty() ? nullptr : &bindingFlagsInfo;
+        descriptorSetLayoutInfo.flags = layoutFlags;
         descriptorSetLayoutInfo.bindingCount = static_cast<uint32_t>(setLayoutBindings.size());
         descriptorSetLayoutInfo.pBindings = setLayoutBindings.data();
 
@@ -197,6 +223,29 @@ namespace arc
         return *this;
     }
 
+    ArcDescriptorWriter &ArcDescriptorWriter::writeImages(
+        uint32_t binding, uint32_t firstElement, uint32_t count, VkDescriptorImageInfo *imageInfos)
+    {
+        assert(setLayout.bindings.count(binding) == 1 && "Layout does not contain specified binding");
+
+        auto &bindingDescription = setLayout.bindings[binding];
+
+        assert(
+            firstElement + count <= bindingDescription.descriptorCount &&
+            "Writing past the end of the binding's array");
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.descriptorType = bindingDescription.descriptorType;
+        write.dstBinding = binding;
+        write.dstArrayElement = firstElement;
+        write.pImageInfo = imageInfos;
+        write.descriptorCount = count;
+
+        writes.push_back(write);
+        return *this;
+    }
+
     bool ArcDescriptorWriter::build(VkDescriptorSet &set)
     {
         bool success = pool.allocateDescriptor(setLayout.getDescriptorSetLayout(), set);
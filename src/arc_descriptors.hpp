@@ -23,16 +23,24 @@ namespace arc
                 uint32_t binding,
                 VkDescriptorType descriptorType,
                 VkShaderStageFlags stageFlags,
-                uint32_t count = 1);
+                uint32_t count = 1,
+                VkDescriptorBindingFlags bindingFlags = 0);
+            Builder &setLayoutFlags(VkDescriptorSetLayoutCreateFlags flags);
             std::unique_ptr<ArcDescriptorSetLayout> build() const;
 
         private:
             ArcDevice &arcDevice;
             std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings{};
+            std::unordered_map<uint32_t, VkDescriptorBindingFlags> bindingFlags{};
+            VkDescriptorSetLayoutCreateFlags layoutFlags = 0;
         };
 
+        // binding flags need descriptor indexing, see ArcDevice::supportsDescriptorIndexing
         ArcDescriptorSetLayout(
-            ArcDevice &arcDevice, std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings);
+            ArcDevice &arcDevice,
+            std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings,
+            std::unordered_map<uint32_t, VkDescriptorBindingFlags> bindingFlags = {},
+            VkDescriptorSetLayoutCreateFlags layoutFlags = 0);
         ~ArcDescriptorSetLayout();
         ArcDescriptorSetLayout(const ArcDescriptorSetLayout &) = delete;
         ArcDescriptorSetLayout &operator=(const ArcDescriptorSetLayout &) = delete;
@@ -97,6 +105,9 @@ namespace arc
 
         ArcDescriptorWriter &writeBuffer(uint32_t binding, VkDescriptorBufferInfo *bufferInfo);
         ArcDescriptorWriter &writeImage(uint32_t binding, VkDescriptorImageInfo *imageInfo);
+        // count elements of an array binding starting at firstElement
+        ArcDescriptorWriter &writeImages(
+            uint32_t binding, uint32_t firstElement, uint32_t count, VkDescriptorImageInfo *imageInfos);
 
         bool build(VkDescriptorSet &set);
         void overwrite(VkDescriptorSet &set);
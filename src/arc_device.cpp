@@ -1,6 +1,7 @@
 #include "arc_device.hpp"
 
 // std headers
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <set>
@@ -63,10 +64,12 @@ namespace arc
         pickPhysicalDevice();
         createLogicalDevice();
         createCommandPool();
+        samplerCache = std::make_unique<ArcSamplerCache>(device_);
     }
 
     ArcDevice::~ArcDevice()
     {
+        samplerCache.reset();
         vkDestroyCommandPool(device_, commandPool, nullptr);
         vkDestroyDevice(device_, nullptr);
 
@@ -92,7 +95,14 @@ namespace arc
         appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
         appInfo.pEngineName = "No Engine";
         appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-        appInfo.apiVersion = VK_API_VERSION_1_0;
+        // 1.2 where the loader has it, descriptor indexing is core there
+        auto enumerateInstanceVersion = reinterpret_cast<PFN_vkEnumerateInstanceVersion>(
+            vkGetInstanceProcAddr(nullptr, "vkEnumerateInstanceVersion"));
+        if (enumerateInstanceVersion != nullptr && enumerateInstanceVersion(&instanceApiVersion) == VK_SUCCESS)
+        {
+            instanceApiVersion = std::min(instanceApiVersion, static_cast<uint32_t>(VK_API_VERSION_1_2));
+        }
+        appInfo.apiVersion = instanceApiVersion;
 
         VkInstanceCreateInfo createInfo = {};
         createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -173,8 +183,59 @@ namespace arc
             queueCreateInfos.push_back(queueCreateInfo);
         }
 
+        VkPhysicalDeviceFeatures supportedFeatures;
+        vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+        textureCompressionBC = supportedFeatures.textureCompressionBC == VK_TRUE;
+
         VkPhysicalDeviceFeatures deviceFeatures = {};
         deviceFeatures.samplerAnisotropy = VK_TRUE;
+        deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+        // texture arrays are indexed with a push constant
+        deviceFeatures.shaderSampledImageArrayDynamicIndexing = supportedFeatures.shaderSampledImageArrayDynamicIndexing;
+        sampledImageArrayDynamicIndexing = supportedFeatures.shaderSampledImageArrayDynamicIndexing == VK_TRUE;
+
+        // bindless textures need partially bound, update after bind sampler arrays,
+        // core in 1.2 and VK_EXT_descriptor_indexing on 1.1
+        std::vector<const char *> enabledExtensions = deviceExtensions;
+        uint32_t deviceApiVersion = std::min(instanceApiVersion, properties.apiVersion);
+        bool indexingExtension = deviceApiVersion < VK_API_VERSION_1_2 && deviceApiVersion >= VK_API_VERSION_1_1 &&
+                                 hasDeviceExtension(physicalDevice, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+        VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures{};
+        indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+        if (deviceApiVersion >= VK_API_VERSION_1_2 || indexingExtension)
+        {
+            VkPhysicalDeviceFeatures2 features2{};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features2.pNext = &indexingFeatures;
+            vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+
+            VkPhysicalDeviceDescriptorIndexingProperties indexingProperties{};
+            indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+            VkPhysicalDeviceProperties2 properties2{};
+            properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+            properties2.pNext = &indexingProperties;
+            vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+            descriptorIndexing = supportedFeatures.shaderSampledImageArrayDynamicIndexing &&
+                                 indexingFeatures.descriptorBindingPartiallyBound &&
+                                 indexingFeatures.descriptorBindingSampledImageUpdateAfterBind;
+            maxBindlessTextures = std::min({indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers,
+                                            indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                            indexingProperties.maxDescriptorSetUpdateAfterBindSamplers,
+                                            indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages});
+        }
+
+        VkPhysicalDeviceDescriptorIndexingFeatures enabledIndexingFeatures{};
+        enabledIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+        if (descriptorIndexing)
+        {
+            enabledIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+            enabledIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+            if (indexingExtension)
+            {
+                enabledExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+            }
+        }
 
         VkDeviceCreateInfo createInfo = {};
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -182,9 +243,10 @@ namespace arc
         createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
         createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
+        createInfo.pNext = descriptorIndexing ? &enabledIndexingFeatures : nullptr;
         createInfo.pEnabledFeatures = &deviceFeatures;
-        createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-        createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+        createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+        createInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
         // might not really be necessary anymore because device specific validation layers
         // have been deprecated
@@ -344,6 +406,22 @@ namespace arc
         }
     }
 
+    bool ArcDevice::hasDeviceExtension(VkPhysicalDevice device, const char *extension)
+    {
+        uint32_t extensionCount;
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+        std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+        for (const auto &available : availableExtensions)
+        {
+            if (std::strcmp(available.extensionName, extension) == 0)
+                return true;
+        }
+        return false;
+    }
+
     bool ArcDevice::checkDeviceExtensionSupport(VkPhysicalDevice device)
     {
         uint32_t extensionCount;
@@ -452,6 +530,15 @@ namespace arc
         throw std::runtime_error("failed to find supported format!");
     }
 
+    bool ArcDevice::supportsFormatFeatures(VkFormat format, VkImageTiling tiling, VkFormatFeatureFlags features)
+    {
+        VkFormatProperties props;
+        vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &props);
+
+        VkFormatFeatureFlags supported = tiling == VK_IMAGE_TILING_LINEAR ? props.linearTilingFeatures : props.optimalTilingFeatures;
+        return (supported & features) == features;
+    }
+
     VkSampleCountFlagBits ArcDevice::getMaxUsableSampleCount()
     {
         VkPhysicalDeviceProperties physicalDeviceProperties;
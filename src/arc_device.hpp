@@ -1,9 +1,11 @@
 #ifndef __ARC_DEVICE_H__
 #define __ARC_DEVICE_H__
 
+#include "arc_sampler_cache.hpp"
 #include "arc_window.hpp"
 
 // std lib headers
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -55,6 +57,17 @@ namespace arc
         QueueFamilyIndices findPhysicalQueueFamilies() { return findQueueFamilies(physicalDevice); }
         VkFormat findSupportedFormat(
             const std::vector<VkFormat> &candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
+        bool supportsFormatFeatures(VkFormat format, VkImageTiling tiling, VkFormatFeatureFlags features);
+        // BC1-BC7 images can be sampled, enabled whenever the physical device has it
+        bool supportsTextureCompressionBC() const { return textureCompressionBC; }
+        // samplers shared by everything created with the same parameters
+        ArcSamplerCache &getSamplerCache() { return *samplerCache; }
+        // sampler arrays indexed by push constants, see ArcTextureRegistry
+        bool supportsSampledImageArrayDynamicIndexing() const { return sampledImageArrayDynamicIndexing; }
+        // partially bound, update after bind sampler arrays, see ArcTextureRegistry
+        bool supportsDescriptorIndexing() const { return descriptorIndexing; }
+        // most textures an update after bind array may hold, 0 without descriptor indexing
+        uint32_t getMaxBindlessTextures() const { return descriptorIndexing ? maxBindlessTextures : 0; }
 
         // Multisampling
         VkSampleCountFlagBits getMaxUsableSampleCount();
@@ -96,11 +109,17 @@ namespace arc
         void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT &createInfo);
         void hasGflwRequiredInstanceExtensions();
         bool checkDeviceExtensionSupport(VkPhysicalDevice device);
+        bool hasDeviceExtension(VkPhysicalDevice device, const char *extension);
         SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device);
 
         VkInstance instance;
         VkDebugUtilsMessengerEXT debugMessenger;
         VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+        bool textureCompressionBC = false;
+        uint32_t instanceApiVersion = VK_API_VERSION_1_0;
+        bool sampledImageArrayDynamicIndexing = false;
+        bool descriptorIndexing = false;
+        uint32_t maxBindlessTextures = 0;
         ArcWindow &window;
         VkCommandPool commandPool;
 
@@ -108,6 +127,7 @@ namespace arc
         VkSurfaceKHR surface_;
         VkQueue graphicsQueue_;
         VkQueue presentQueue_;
+        std::unique_ptr<ArcSamplerCache> samplerCache;
 
         const std::vector<const char *> validationLayers = {"VK_LAYER_KHRONOS_validation"};
         const std::vector<const char *> deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
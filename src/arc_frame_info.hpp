@@ -9,6 +9,8 @@
 
 namespace arc
 {
+    class ArcTextureRegistry;
+
 #define MAX_LIGHTS 10
     struct PointLight
     {
@@ -37,6 +39,8 @@ namespace arc
         ArcCamera &camera;
         VkDescriptorSet globalDescriptorSet;
         ArcGameObject::Map &gameObjects;
+        // set 1 of the systems sampling textures
+        const ArcTextureRegistry *textureRegistry = nullptr;
     };
 
 }
@@ -77,4 +77,19 @@ namespace arc
         return gameObj;
     }
 
-}
\ No newline at end of file
+    uint32_t ArcGameObject::selectLod(const ArcCamera &camera)
+    {
+        if (model == nullptr)
+            return 0;
+
+        glm::vec4 sphere = getWorldBounds().sphere;
+        return model->selectLod(camera.projectedRadius(glm::vec3{sphere}, sphere.w));
+    }
+
+    Bounds ArcGameObject::getWorldBounds()
+    {
+        if (model == nullptr)
+            return Bounds{};
+        return transformBounds(model->getBounds(), transform.mat4());
+    }
+}
@@ -1,6 +1,7 @@
 #ifndef __ARC_GAME_OBJECT_H__
 #define __ARC_GAME_OBJECT_H__
 
+#include "arc_camera.hpp"
 #include "arc_model.hpp"
 
 // libs
@@ -50,8 +51,15 @@ namespace arc
 
         const id_t getID() const { return id; }
 
+        // level of detail of the model for the camera's current view, 0 without a model
+        uint32_t selectLod(const ArcCamera &camera);
+        // the model's bounds in world space, invalid without a model
+        Bounds getWorldBounds();
+
         glm::vec3 color{};
         TransformComponent transform{};
+        // slot in the ArcTextureRegistry, 0 is the default texture
+        uint32_t textureIndex = 0;
 
         // Optional
         std::shared_ptr<ArcModel> model{};
@@ -0,0 +1,258 @@
+#include "arc_geometry_arena.hpp"
+#include "arc_upload_batch.hpp"
+
+// std
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace arc
+{
+    ArcGeometryArena::FreeList::FreeList(uint32_t capacity)
+    {
+        spans.push_back({0, capacity});
+    }
+
+    bool ArcGeometryArena::FreeList::allocate(uint32_t count, uint32_t &offset)
+    {
+        for (auto it = spans.begin(); it != spans.end(); ++it)
+        {
+            if (it->count < count)
+                continue;
+
+            offset = it->offset;
+            it->offset += count;
+            it->count -= count;
+            if (it->count == 0)
+            {
+                spans.erase(it);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void ArcGeometryArena::FreeList::release(uint32_t offset, uint32_t count)
+    {
+        auto next = std::lower_bound(spans.begin(), spans.end(), offset,
+                                     [](const Span &span, uint32_t value)
+                                     { return span.offset < value; });
+
+        // merge with the span right after and the one right before
+        if (next != spans.end() && offset + count == next->offset)
+        {
+            next->offset = offset;
+            next->count += count;
+        }
+        else
+        {
+            next = spans.insert(next, {offset, count});
+        }
+
+        if (next != spans.begin())
+        {
+            auto previous = next - 1;
+            if (previous->offset + previous->count == next->offset)
+            {
+                previous->count += next->count;
+                spans.erase(next);
+            }
+        }
+    }
+
+    ArcGeometryArena::ArcGeometryArena(ArcDevice &device, VkDeviceSize vertexBlockSize, VkDeviceSize indexBlockSize)
+        : arcDevice{device}, vertexBlockSize{vertexBlockSize}, indexBlockSize{indexBlockSize}
+    {
+    }
+
+    ArcGeometryArena::~ArcGeometryArena()
+    {
+    }
+
+    uint32_t ArcGeometryArena::indexSize(VkIndexType indexType)
+    {
+        return indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    }
+
+    ArcGeometryArena::Block &ArcGeometryArena::createBlock(uint32_t vertexStride, VkIndexType indexType, bool indexed,
+                                                           uint32_t vertexCount, uint32_t indexCount)
+    {
+        // a model bigger than a whole block gets a block of its own size
+        uint32_t vertexCapacity = std::max(vertexCount, static_cast<uint32_t>(vertexBlockSize / vertexStride));
+        uint32_t indexCapacity = indexed ? std::max(indexCount, static_cast<uint32_t>(indexBlockSize / indexSize(indexType))) : 0;
+
+        std::unique_ptr<ArcBuffer> indexBuffer{};
+        if (indexed)
+        {
+            indexBuffer = std::make_unique<ArcBuffer>(
+                arcDevice,
+                indexSize(indexType),
+                indexCapacity,
+                VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        }
+
+        auto block = std::unique_ptr<Block>(new Block{
+            vertexStride,
+            indexType,
+            indexed,
+            std::make_unique<ArcBuffer>(
+                arcDevice,
+                vertexStride,
+                vertexCapacity,
+                VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+            std::move(indexBuffer),
+            FreeList{vertexCapacity},
+            FreeList{indexCapacity}});
+
+        std::cout << "Geometry arena block " << blocks.size() << ": " << vertexCapacity << " vertices of "
+                  << vertexStride << " bytes, ";
+        if (indexed)
+        {
+            std::cout << indexCapacity << " indices of " << indexSize(indexType) << " bytes\n";
+        }
+        else
+        {
+            std::cout << "vertices only\n";
+        }
+
+        blocks.push_back(std::move(block));
+        return *blocks.back();
+    }
+
+    ArcGeometryArena::Range ArcGeometryArena::allocate(const void *vertices, uint32_t vertexStride, uint32_t vertexCount,
+                                                       const void *indices, VkIndexType indexType, uint32_t indexCount,
+                                                       ArcUploadBatch &batch)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return allocateLocked(vertices, vertexStride, vertexCount, indices, indexType, indexCount, true, batch);
+    }
+
+    ArcGeometryArena::Range ArcGeometryArena::allocateVertices(const void *vertices, uint32_t vertexStride, uint32_t vertexCount,
+                                                               ArcUploadBatch &batch)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return allocateLocked(vertices, vertexStride, vertexCount, nullptr, VK_INDEX_TYPE_UINT32, 0, false, batch);
+    }
+
+    ArcGeometryArena::Range ArcGeometryArena::allocateLocked(const void *vertices, uint32_t vertexStride, uint32_t vertexCount,
+                                                             const void *indices, VkIndexType indexType, uint32_t indexCount,
+                                                             bool indexed, ArcUploadBatch &batch)
+    {
+        Range range{};
+        range.vertexCount = vertexCount;
+        range.indexCount = indexCount;
+
+        // both parts have to fit into the same block, a half placed model gives its vertices back
+        auto tryBlock = [&](Block &block, uint32_t blockIndex)
+        {
+            if (block.vertexStride != vertexStride || block.indexType != indexType || block.indexed != indexed)
+                return false;
+            if (!block.vertexSpace.allocate(vertexCount, range.vertexOffset))
+                return false;
+            if (indexCount > 0 && !block.indexSpace.allocate(indexCount, range.firstIndex))
+            {
+                block.vertexSpace.release(range.vertexOffset, vertexCount);
+                return false;
+            }
+            range.block = blockIndex;
+            return true;
+        };
+
+        for (uint32_t i = 0; i < blocks.size() && range.block == INVALID_BLOCK; ++i)
+        {
+            tryBlock(*blocks[i], i);
+        }
+        if (range.block == INVALID_BLOCK)
+        {
+            uint32_t blockIndex = static_cast<uint32_t>(blocks.size());
+            if (!tryBlock(createBlock(vertexStride, indexType, indexed, vertexCount, indexCount), blockIndex))
+            {
+                throw std::runtime_error("failed to allocate geometry in a new arena block!");
+            }
+        }
+
+        Block &block = *blocks[range.block];
+        VkDeviceSize vertexBytes = static_cast<VkDeviceSize>(vertexStride) * vertexCount;
+        VkDeviceSize indexBytes = static_cast<VkDeviceSize>(indexSize(indexType)) * indexCount;
+        batch.uploadBuffer(block.vertexBuffer->getBuffer(), vertices, vertexBytes,
+                           static_cast<VkDeviceSize>(vertexStride) * range.vertexOffset);
+        if (indexCount > 0)
+        {
+            batch.uploadBuffer(block.indexBuffer->getBuffer(), indices, indexBytes,
+                               static_cast<VkDeviceSize>(indexSize(indexType)) * range.firstIndex);
+        }
+        block.usedBytes += vertexBytes + indexBytes;
+
+        return range;
+    }
+
+    void ArcGeometryArena::free(const Range &range)
+    {
+        if (range.block == INVALID_BLOCK)
+            return;
+
+        std::lock_guard<std::mutex> lock{mutex};
+        Block &block = *blocks[range.block];
+        block.vertexSpace.release(range.vertexOffset, range.vertexCount);
+        if (range.indexCount > 0)
+        {
+            block.indexSpace.release(range.firstIndex, range.indexCount);
+        }
+        block.usedBytes -= static_cast<VkDeviceSize>(block.vertexStride) * range.vertexCount +
+                           static_cast<VkDeviceSize>(indexSize(block.indexType)) * range.indexCount;
+    }
+
+    void ArcGeometryArena::bind(VkCommandBuffer commandBuffer, uint32_t block) const
+    {
+        bind(commandBuffer, block, block);
+    }
+
+    void ArcGeometryArena::bind(VkCommandBuffer commandBuffer, uint32_t vertexBlock, uint32_t indexBlock) const
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        const Block &vertices = *blocks[vertexBlock];
+        const Block &indices = *blocks[indexBlock];
+
+        VkBuffer buffers[] = {vertices.vertexBuffer->getBuffer()};
+        VkDeviceSize offsets[] = {0};
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+        if (indices.indexBuffer != nullptr)
+        {
+            vkCmdBindIndexBuffer(commandBuffer, indices.indexBuffer->getBuffer(), 0, indices.indexType);
+        }
+    }
+
+    uint32_t ArcGeometryArena::getBlockCount() const
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return static_cast<uint32_t>(blocks.size());
+    }
+
+    VkDeviceSize ArcGeometryArena::getUsedBytes() const
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        VkDeviceSize bytes = 0;
+        for (const auto &block : blocks)
+        {
+            bytes += block->usedBytes;
+        }
+        return bytes;
+    }
+
+    VkDeviceSize ArcGeometryArena::getCapacityBytes() const
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        VkDeviceSize bytes = 0;
+        for (const auto &block : blocks)
+        {
+            bytes += block->vertexBuffer->getBufferSize();
+            if (block->indexBuffer != nullptr)
+            {
+                bytes += block->indexBuffer->getBufferSize();
+            }
+        }
+        return bytes;
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef __ARC_GEOMETRY_ARENA_H__
+#define __ARC_GEOMETRY_ARENA_H__
+
+#include "arc_device.hpp"
+#include "arc_buffer.hpp"
+
+// std
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace arc
+{
+    class ArcUploadBatch;
+
+    // Suballocates the vertices and indices of every model from a few large device-local buffers,
+    // so a frame binds geometry once per vertex layout and draws with firstIndex / vertexOffset.
+    // Each block holds one vertex stride and one index type, a new block is only created once
+    // the existing ones of that layout are full. Extra vertex streams that reuse a model's indices
+    // live in vertex only blocks.
+    class ArcGeometryArena
+    {
+    public:
+        static constexpr uint32_t INVALID_BLOCK = UINT32_MAX;
+
+        // where a model's geometry lives, offsets and counts are in vertices and indices
+        struct Range
+        {
+            uint32_t block = INVALID_BLOCK;
+            uint32_t vertexOffset = 0;
+            uint32_t vertexCount = 0;
+            uint32_t firstIndex = 0;
+            uint32_t indexCount = 0;
+        };
+
+        ArcGeometryArena(ArcDevice &device,
+                         VkDeviceSize vertexBlockSize = 64 * 1024 * 1024,
+                         VkDeviceSize indexBlockSize = 32 * 1024 * 1024);
+        ~ArcGeometryArena();
+
+        ArcGeometryArena(const ArcGeometryArena &) = delete;
+        ArcGeometryArena &operator=(const ArcGeometryArena &) = delete;
+
+        // reserves room for the geometry and records its upload into batch
+        Range allocate(const void *vertices, uint32_t vertexStride, uint32_t vertexCount,
+                       const void *indices, VkIndexType indexType, uint32_t indexCount,
+                       ArcUploadBatch &batch);
+        // vertices without indices of their own, placed in blocks without an index buffer
+        Range allocateVertices(const void *vertices, uint32_t vertexStride, uint32_t vertexCount, ArcUploadBatch &batch);
+        // the caller makes sure the GPU no longer reads the range
+        void free(const Range &range);
+
+        void bind(VkCommandBuffer commandBuffer, uint32_t block) const;
+        // vertices of vertexBlock at binding 0 with the indices of indexBlock
+        void bind(VkCommandBuffer commandBuffer, uint32_t vertexBlock, uint32_t indexBlock) const;
+
+        uint32_t getBlockCount() const;
+        // bytes handed out to models and bytes reserved on the device
+        VkDeviceSize getUsedBytes() const;
+        VkDeviceSize getCapacityBytes() const;
+
+    private:
+        // first fit over free element ranges sorted by offset, neighbours merge on release
+        class FreeList
+        {
+        public:
+            FreeList(uint32_t capacity);
+
+            bool allocate(uint32_t count, uint32_t &offset);
+            void release(uint32_t offset, uint32_t count);
+
+        private:
+            struct Span
+            {
+                uint32_t offset;
+                uint32_t count;
+            };
+            std::vector<Span> spans{};
+        };
+
+        struct Block
+        {
+            uint32_t vertexStride;
+            VkIndexType indexType;
+            bool indexed;
+            std::unique_ptr<ArcBuffer> vertexBuffer;
+            std::unique_ptr<ArcBuffer> indexBuffer; // null in vertex only blocks
+            FreeList vertexSpace;
+            FreeList indexSpace;
+            VkDeviceSize usedBytes = 0;
+        };
+
+        static uint32_t indexSize(VkIndexType indexType);
+        Range allocateLocked(const void *vertices, uint32_t vertexStride, uint32_t vertexCount,
+                             const void *indices, VkIndexType indexType, uint32_t indexCount,
+                             bool indexed, ArcUploadBatch &batch);
+        Block &createBlock(uint32_t vertexStride, VkIndexType indexType, bool indexed, uint32_t vertexCount, uint32_t indexCount);
+
+        ArcDevice &arcDevice;
+        VkDeviceSize vertexBlockSize;
+        VkDeviceSize indexBlockSize;
+
+        mutable std::mutex mutex;
+        std::vector<std::unique_ptr<Block>> blocks{};
+    };
+}
+
+#endif // __ARC_GEOMETRY_ARENA_H__
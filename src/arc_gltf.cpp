@@ -0,0 +1,776 @@
+#include "arc_gltf.hpp"
+#include "arc_mapped_file.hpp"
+
+// std
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace arc
+{
+    namespace
+    {
+        constexpr uint32_t GLB_MAGIC = 0x46546c67; // "glTF"
+        constexpr uint32_t GLB_VERSION = 2;
+        constexpr uint32_t GLB_CHUNK_JSON = 0x4e4f534a;
+        constexpr uint32_t GLB_CHUNK_BIN = 0x004e4942;
+
+        constexpr int GLTF_BYTE = 5120;
+        constexpr int GLTF_UNSIGNED_BYTE = 5121;
+        constexpr int GLTF_SHORT = 5122;
+        constexpr int GLTF_UNSIGNED_SHORT = 5123;
+        constexpr int GLTF_UNSIGNED_INT = 5125;
+        constexpr int GLTF_FLOAT = 5126;
+        constexpr int GLTF_TRIANGLES = 4;
+
+        // just enough JSON for the glTF header chunk
+        struct JsonValue
+        {
+            enum class Type
+            {
+                Null,
+                Bool,
+                Number,
+                String,
+                Array,
+                Object
+            };
+
+            Type type = Type::Null;
+            bool boolean = false;
+            double number = 0.0;
+            std::string string{};
+            std::vector<JsonValue> array{};
+            std::vector<std::pair<std::string, JsonValue>> object{};
+
+            // missing members and elements read as null
+            const JsonValue &operator[](const char *key) const
+            {
+                for (const auto &member : object)
+                {
+                    if (member.first == key)
+                        return member.second;
+                }
+                return null();
+            }
+
+            const JsonValue &operator[](size_t index) const
+            {
+                return index < array.size() ? array[index] : null();
+            }
+
+            bool isNull() const { return type == Type::Null; }
+            size_t size() const { return array.size(); }
+            double asNumber(double fallback) const { return type == Type::Number ? number : fallback; }
+            int asInt(int fallback) const { return type == Type::Number ? static_cast<int>(number) : fallback; }
+            std::string asString() const { return type == Type::String ? string : std::string{}; }
+
+            static const JsonValue &null()
+            {
+                static const JsonValue value{};
+                return value;
+            }
+        };
+
+        class JsonParser
+        {
+        public:
+            JsonParser(const char *begin, const char *end) : cursor{begin}, end{end} {}
+
+            JsonValue parse()
+            {
+                JsonValue value = parseValue(0);
+                skipSpace();
+                if (cursor != end)
+                    fail();
+                return value;
+            }
+
+        private:
+            static constexpr int MAX_DEPTH = 64;
+
+            [[noreturn]] void fail()
+            {
+                throw std::runtime_error("failed to parse glTF json!");
+            }
+
+            void skipSpace()
+            {
+                while (cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\n' || *cursor == '\r'))
+                    ++cursor;
+            }
+
+            void expect(char c)
+            {
+                skipSpace();
+                if (cursor >= end || *cursor != c)
+                    fail();
+                ++cursor;
+            }
+
+            bool consume(const char *literal)
+            {
+                size_t length = std::strlen(literal);
+                if (static_cast<size_t>(end - cursor) < length || std::memcmp(cursor, literal, length) != 0)
+                    return false;
+                cursor += length;
+                return true;
+            }
+
+            JsonValue parseValue(int depth)
+            {
+                if (depth > MAX_DEPTH)
+                    fail();
+
+                skipSpace();
+                if (cursor >= end)
+                    fail();
+
+                JsonValue value{};
+                if (*cursor == '{')
+                {
+                    value.type = JsonValue::Type::Object;
+                    ++cursor;
+                    skipSpace();
+                    if (cursor < end && *cursor == '}')
+                    {
+                        ++cursor;
+                        return value;
+                    }
+                    do
+                    {
+                        skipSpace();
+                        std::string key = parseString();
+                        expect(':');
+                        value.object.emplace_back(std::move(key), parseValue(depth + 1));
+                        skipSpace();
+                    } while (cursor < end && *cursor == ',' && ++cursor);
+                    expect('}');
+                }
+                else if (*cursor == '[')
+                {
+                    value.type = JsonValue::Type::Array;
+                    ++cursor;
+                    skipSpace();
+                    if (cursor < end && *cursor == ']')
+                    {
+                        ++cursor;
+                        return value;
+                    }
+                    do
+                    {
+                        value.array.push_back(parseValue(depth + 1));
+                        skipSpace();
+                    } while (cursor < end && *cursor == ',' && ++cursor);
+                    expect(']');
+                }
+                else if (*cursor == '"')
+                {
+                    value.type = JsonValue::Type::String;
+                    value.string = parseString();
+                }
+                else if (consume("true"))
+                {
+                    value.type = JsonValue::Type::Bool;
+                    value.boolean = true;
+                }
+                else if (consume("false"))
+                {
+                    value.type = JsonValue::Type::Bool;
+                }
+                else if (consume("null"))
+                {
+                    value.type = JsonValue::Type::Null;
+                }
+                else
+                {
+                    value.type = JsonValue::Type::Number;
+                    auto result = std::from_chars(cursor, end, value.number);
+                    if (result.ec != std::errc{})
+                        fail();
+                    cursor = result.ptr;
+                }
+                return value;
+            }
+
+            std::string parseString()
+            {
+                if (cursor >= end || *cursor != '"')
+                    fail();
+                ++cursor;
+
+                std::string result{};
+                while (cursor < end && *cursor != '"')
+                {
+                    char c = *cursor++;
+                    if (c != '\\')
+                    {
+                        result.push_back(c);
+                        continue;
+                    }
+                    if (cursor >= end)
+                        fail();
+
+                    c = *cursor++;
+                    switch (c)
+                    {
+                    case 'b': result.push_back('\b'); break;
+                    case 'f': result.push_back('\f'); break;
+                    case 'n': result.push_back('\n'); break;
+                    case 'r': result.push_back('\r'); break;
+                    case 't': result.push_back('\t'); break;
+                    case 'u':
+                    {
+                        // names and uris only, surrogate pairs are encoded one half at a time
+                        if (end - cursor < 4)
+                            fail();
+                        unsigned int code = 0;
+                        auto result16 = std::from_chars(cursor, cursor + 4, code, 16);
+                        if (result16.ec != std::errc{} || result16.ptr != cursor + 4)
+                            fail();
+                        cursor += 4;
+                        if (code < 0x80)
+                        {
+                            result.push_back(static_cast<char>(code));
+                        }
+                        else if (code < 0x800)
+                        {
+                            result.push_back(static_cast<char>(0xc0 | (code >> 6)));
+                            result.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+                        }
+                        else
+                        {
+                            result.push_back(static_cast<char>(0xe0 | (code >> 12)));
+                            result.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+                            result.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+                        }
+                        break;
+                    }
+                    default: result.push_back(c); break;
+                    }
+                }
+                if (cursor >= end)
+                    fail();
+                ++cursor;
+                return result;
+            }
+
+            const char *cursor;
+            const char *end;
+        };
+
+        // a typed, strided window into the BIN chunk
+        struct AccessorView
+        {
+            const uint8_t *data = nullptr;
+            size_t stride = 0;
+            size_t count = 0;
+            int componentType = GLTF_FLOAT;
+            int components = 0;
+            bool normalized = false;
+        };
+
+        size_t componentSize(int componentType)
+        {
+            switch (componentType)
+            {
+            case GLTF_BYTE:
+            case GLTF_UNSIGNED_BYTE:
+                return 1;
+            case GLTF_SHORT:
+            case GLTF_UNSIGNED_SHORT:
+                return 2;
+            case GLTF_UNSIGNED_INT:
+            case GLTF_FLOAT:
+                return 4;
+            default:
+                throw std::runtime_error("unsupported glTF component type!");
+            }
+        }
+
+        int componentCount(const std::string &type)
+        {
+            if (type == "SCALAR")
+                return 1;
+            if (type == "VEC2")
+                return 2;
+            if (type == "VEC3")
+                return 3;
+            if (type == "VEC4")
+                return 4;
+            throw std::runtime_error("unsupported glTF accessor type " + type + "!");
+        }
+
+        AccessorView viewAccessor(const JsonValue &gltf, int index, const uint8_t *bin, size_t binSize)
+        {
+            const JsonValue &accessor = gltf["accessors"][static_cast<size_t>(index)];
+            if (accessor.isNull())
+            {
+                throw std::runtime_error("glTF accessor index out of range!");
+            }
+            if (!accessor["sparse"].isNull())
+            {
+                throw std::runtime_error("sparse glTF accessors are not supported!");
+            }
+
+            AccessorView view{};
+            view.count = static_cast<size_t>(accessor["count"].asNumber(0.0));
+            view.componentType = accessor["componentType"].asInt(GLTF_FLOAT);
+            view.components = componentCount(accessor["type"].string);
+            view.normalized = accessor["normalized"].boolean;
+
+            size_t elementSize = componentSize(view.componentType) * view.components;
+            view.stride = elementSize;
+
+            // an accessor without a buffer view reads as zeros, which the caller treats as absent
+            const JsonValue &bufferViewIndex = accessor["bufferView"];
+            if (bufferViewIndex.isNull())
+                return view;
+
+            const JsonValue &bufferView = gltf["bufferViews"][static_cast<size_t>(bufferViewIndex.asInt(-1))];
+            if (bufferView.isNull() || bufferView["buffer"].asInt(0) != 0)
+            {
+                throw std::runtime_error("glTF accessor must read from the embedded BIN buffer!");
+            }
+
+            size_t offset = static_cast<size_t>(bufferView["byteOffset"].asNumber(0.0)) +
+                            static_cast<size_t>(accessor["byteOffset"].asNumber(0.0));
+            size_t viewLength = static_cast<size_t>(bufferView["byteLength"].asNumber(0.0));
+            view.stride = static_cast<size_t>(bufferView["byteStride"].asNumber(static_cast<double>(elementSize)));
+
+            size_t viewEnd = static_cast<size_t>(bufferView["byteOffset"].asNumber(0.0)) + viewLength;
+            size_t lastByte = view.count == 0 ? offset : offset + view.stride * (view.count - 1) + elementSize;
+            if (lastByte > viewEnd || viewEnd > binSize)
+            {
+                throw std::runtime_error("glTF accessor reads past its buffer view!");
+            }
+
+            view.data = bin + offset;
+            return view;
+        }
+
+        float readComponent(const uint8_t *data, int componentType, bool normalized)
+        {
+            switch (componentType)
+            {
+            case GLTF_FLOAT:
+            {
+                float value;
+                std::memcpy(&value, data, sizeof(value));
+                return value;
+            }
+            case GLTF_UNSIGNED_BYTE:
+                return normalized ? data[0] / 255.0f : data[0];
+            case GLTF_BYTE:
+            {
+                int8_t value = static_cast<int8_t>(data[0]);
+                return normalized ? std::max(value / 127.0f, -1.0f) : value;
+            }
+            case GLTF_UNSIGNED_SHORT:
+            {
+                uint16_t value;
+                std::memcpy(&value, data, sizeof(value));
+                return normalized ? value / 65535.0f : value;
+            }
+            case GLTF_SHORT:
+            {
+                int16_t value;
+                std::memcpy(&value, data, sizeof(value));
+                return normalized ? std::max(value / 32767.0f, -1.0f) : value;
+            }
+            default:
+            {
+                uint32_t value;
+                std::memcpy(&value, data, sizeof(value));
+                return static_cast<float>(value);
+            }
+            }
+        }
+
+        uint32_t readIndex(const uint8_t *data, int componentType)
+        {
+            switch (componentType)
+            {
+            case GLTF_UNSIGNED_BYTE:
+                return data[0];
+            case GLTF_UNSIGNED_SHORT:
+            {
+                uint16_t value;
+                std::memcpy(&value, data, sizeof(value));
+                return value;
+            }
+            case GLTF_UNSIGNED_INT:
+            {
+                uint32_t value;
+                std::memcpy(&value, data, sizeof(value));
+                return value;
+            }
+            default:
+                throw std::runtime_error("glTF indices must be unsigned integers!");
+            }
+        }
+
+        // copies the first `size` components of every element into the vertex member at memberOffset
+        // float data of the exact size is copied as is, everything else goes through readComponent
+        void readAttribute(const AccessorView &view, std::vector<ArcModel::Vertex> &vertices, size_t firstVertex,
+                           size_t memberOffset, int size)
+        {
+            if (view.data == nullptr)
+                return;
+
+            uint8_t *target = reinterpret_cast<uint8_t *>(vertices.data() + firstVertex) + memberOffset;
+            if (view.componentType == GLTF_FLOAT && view.components >= size)
+            {
+                for (size_t i = 0; i < view.count; ++i)
+                {
+                    std::memcpy(target + i * sizeof(ArcModel::Vertex), view.data + i * view.stride, size * sizeof(float));
+                }
+                return;
+            }
+
+            size_t step = componentSize(view.componentType);
+            int components = std::min(size, view.components);
+            for (size_t i = 0; i < view.count; ++i)
+            {
+                float values[4];
+                for (int c = 0; c < components; ++c)
+                {
+                    values[c] = readComponent(view.data + i * view.stride + c * step, view.componentType, view.normalized);
+                }
+                std::memcpy(target + i * sizeof(ArcModel::Vertex), values, components * sizeof(float));
+            }
+        }
+
+        // keeps the defaults in values where the array is shorter
+        void readFloats(const JsonValue &array, float *values, size_t count)
+        {
+            for (size_t i = 0; i < count && i < array.size(); ++i)
+            {
+                values[i] = static_cast<float>(array[i].asNumber(values[i]));
+            }
+        }
+
+        glm::mat4 nodeTransform(const JsonValue &node)
+        {
+            glm::mat4 transform{1.0f};
+            const JsonValue &matrix = node["matrix"];
+            if (matrix.size() == 16)
+            {
+                for (int column = 0; column < 4; ++column)
+                    for (int row = 0; row < 4; ++row)
+                        transform[column][row] = static_cast<float>(matrix[column * 4 + row].asNumber(0.0));
+                return transform;
+            }
+
+            // translation * rotation * scale
+            float rotation[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+            float scale[3] = {1.0f, 1.0f, 1.0f};
+            float translation[3] = {0.0f, 0.0f, 0.0f};
+            readFloats(node["rotation"], rotation, 4);
+            readFloats(node["scale"], scale, 3);
+            readFloats(node["translation"], translation, 3);
+
+            float x = rotation[0];
+            float y = rotation[1];
+            float z = rotation[2];
+            float w = rotation[3];
+            transform[0] = glm::vec4{1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y), 0.0f};
+            transform[1] = glm::vec4{2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x), 0.0f};
+            transform[2] = glm::vec4{2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y), 0.0f};
+
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                transform[axis] = transform[axis] * scale[axis];
+            }
+            transform[3] = glm::vec4{translation[0], translation[1], translation[2], 1.0f};
+            return transform;
+        }
+
+        bool isIdentity(const glm::mat4 &transform)
+        {
+            for (int column = 0; column < 4; ++column)
+                for (int row = 0; row < 4; ++row)
+                    if (transform[column][row] != (column == row ? 1.0f : 0.0f))
+                        return false;
+            return true;
+        }
+
+        // base color factor and texture, textures embedded in the BIN chunk or as data URIs aren't kept
+        void readMaterials(const JsonValue &gltf, std::vector<ArcModel::Material> &materials)
+        {
+            const JsonValue &gltfMaterials = gltf["materials"];
+            for (size_t m = 0; m < gltfMaterials.size(); ++m)
+            {
+                const JsonValue &pbr = gltfMaterials[m]["pbrMetallicRoughness"];
+                ArcModel::Material material{};
+                material.name = gltfMaterials[m]["name"].asString();
+
+                float baseColor[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+                readFloats(pbr["baseColorFactor"], baseColor, 4);
+                material.diffuse = glm::vec3{baseColor[0], baseColor[1], baseColor[2]};
+
+                const JsonValue &texture = pbr["baseColorTexture"];
+                if (!texture.isNull())
+                {
+                    int source = gltf["textures"][static_cast<size_t>(texture["index"].asInt(-1))]["source"].asInt(-1);
+                    std::string uri = gltf["images"][static_cast<size_t>(source)]["uri"].asString();
+                    if (uri.compare(0, 5, "data:") != 0)
+                    {
+                        material.diffuseTexture = uri;
+                    }
+                }
+                materials.push_back(std::move(material));
+            }
+        }
+
+        struct GlbReader
+        {
+            const JsonValue &gltf;
+            const uint8_t *bin;
+            size_t binSize;
+            ArcModel::Builder &builder;
+            size_t skippedPrimitives = 0;
+
+            void readPrimitive(const JsonValue &primitive, const glm::mat4 &transform)
+            {
+                if (primitive["mode"].asInt(GLTF_TRIANGLES) != GLTF_TRIANGLES || primitive["attributes"]["POSITION"].isNull())
+                {
+                    skippedPrimitives++;
+                    return;
+                }
+
+                const JsonValue &attributes = primitive["attributes"];
+                AccessorView positions = viewAccessor(gltf, attributes["POSITION"].asInt(-1), bin, binSize);
+                if (positions.components != 3)
+                {
+                    throw std::runtime_error("glTF positions must be VEC3!");
+                }
+
+                size_t firstVertex = builder.vertices.size();
+                if (firstVertex + positions.count > UINT32_MAX)
+                {
+                    throw std::runtime_error("glTF model has too many vertices!");
+                }
+
+                // glTF colors default to white, like the OBJ path
+                ArcModel::Vertex defaultVertex{};
+                defaultVertex.color = glm::vec3{1.0f};
+                builder.vertices.resize(firstVertex + positions.count, defaultVertex);
+
+                auto readOptional = [&](const char *name, size_t memberOffset, int size)
+                {
+                    const JsonValue &index = attributes[name];
+                    if (index.isNull())
+                        return;
+                    AccessorView view = viewAccessor(gltf, index.asInt(-1), bin, binSize);
+                    if (view.count != positions.count)
+                    {
+                        throw std::runtime_error(std::string("glTF attribute ") + name + " has the wrong count!");
+                    }
+                    readAttribute(view, builder.vertices, firstVertex, memberOffset, size);
+                };
+                readAttribute(positions, builder.vertices, firstVertex, offsetof(ArcModel::Vertex, position), 3);
+                readOptional("NORMAL", offsetof(ArcModel::Vertex, normal), 3);
+                readOptional("TEXCOORD_0", offsetof(ArcModel::Vertex, uv), 2);
+                readOptional("COLOR_0", offsetof(ArcModel::Vertex, color), 3);
+
+                // normals go through the cofactor matrix, which handles non-uniform scale without an inverse
+                bool mirrored = false;
+                if (!isIdentity(transform))
+                {
+                    glm::vec3 axes[3] = {glm::vec3{transform[0]}, glm::vec3{transform[1]}, glm::vec3{transform[2]}};
+                    glm::vec3 cofactor[3] = {glm::cross(axes[1], axes[2]), glm::cross(axes[2], axes[0]), glm::cross(axes[0], axes[1])};
+                    mirrored = glm::dot(axes[0], cofactor[0]) < 0.0f;
+
+                    for (size_t i = firstVertex; i < builder.vertices.size(); ++i)
+                    {
+                        auto &vertex = builder.vertices[i];
+                        vertex.position = glm::vec3{transform * glm::vec4{vertex.position, 1.0f}};
+                        glm::vec3 normal = cofactor[0] * vertex.normal.x + cofactor[1] * vertex.normal.y + cofactor[2] * vertex.normal.z;
+                        float length = glm::length(normal);
+                        vertex.normal = length > 0.0f ? normal / (mirrored ? -length : length) : normal;
+                    }
+                }
+
+                size_t firstIndex = builder.indices.size();
+                const JsonValue &indicesIndex = primitive["indices"];
+                if (indicesIndex.isNull())
+                {
+                    builder.indices.resize(firstIndex + positions.count);
+                    for (size_t i = 0; i < positions.count; ++i)
+                        builder.indices[firstIndex + i] = static_cast<uint32_t>(firstVertex + i);
+                }
+                else
+                {
+                    AccessorView indices = viewAccessor(gltf, indicesIndex.asInt(-1), bin, binSize);
+                    if (indices.components != 1 || indices.data == nullptr)
+                    {
+                        throw std::runtime_error("glTF indices must be a SCALAR accessor with data!");
+                    }
+
+                    builder.indices.resize(firstIndex + indices.count);
+                    uint32_t *target = builder.indices.data() + firstIndex;
+                    if (indices.componentType == GLTF_UNSIGNED_INT && indices.stride == sizeof(uint32_t))
+                    {
+                        std::memcpy(target, indices.data, indices.count * sizeof(uint32_t));
+                    }
+                    else
+                    {
+                        size_t step = indices.stride;
+                        for (size_t i = 0; i < indices.count; ++i)
+                            target[i] = readIndex(indices.data + i * step, indices.componentType);
+                    }
+
+                    for (size_t i = 0; i < indices.count; ++i)
+                    {
+                        if (target[i] >= positions.count)
+                        {
+                            throw std::runtime_error("glTF index out of range!");
+                        }
+                        target[i] += static_cast<uint32_t>(firstVertex);
+                    }
+                }
+
+                // drop a trailing partial triangle, flip the winding under a mirroring transform
+                builder.indices.resize(firstIndex + (builder.indices.size() - firstIndex) / 3 * 3);
+                if (mirrored)
+                {
+                    for (size_t i = firstIndex; i < builder.indices.size(); i += 3)
+                        std::swap(builder.indices[i + 1], builder.indices[i + 2]);
+                }
+
+                // grouped by material once the whole file is read
+                int material = primitive["material"].asInt(-1);
+                builder.submeshes.push_back({static_cast<uint32_t>(firstIndex),
+                                             static_cast<uint32_t>(builder.indices.size() - firstIndex),
+                                             material >= 0 && static_cast<size_t>(material) < builder.materials.size()
+                                                 ? static_cast<uint32_t>(material)
+                                                 : UINT32_MAX});
+            }
+
+            void readMesh(int meshIndex, const glm::mat4 &transform)
+            {
+                const JsonValue &mesh = gltf["meshes"][static_cast<size_t>(meshIndex)];
+                const JsonValue &primitives = mesh["primitives"];
+                for (size_t p = 0; p < primitives.size(); ++p)
+                {
+                    readPrimitive(primitives[p], transform);
+                }
+            }
+
+            void readNode(int nodeIndex, const glm::mat4 &parent, size_t depth)
+            {
+                const JsonValue &nodes = gltf["nodes"];
+                // a valid hierarchy can't be deeper than the node count
+                if (depth > nodes.size())
+                {
+                    throw std::runtime_error("glTF node hierarchy contains a cycle!");
+                }
+
+                const JsonValue &node = nodes[static_cast<size_t>(nodeIndex)];
+                glm::mat4 transform = parent * nodeTransform(node);
+                if (!node["mesh"].isNull())
+                {
+                    readMesh(node["mesh"].asInt(-1), transform);
+                }
+
+                const JsonValue &children = node["children"];
+                for (size_t c = 0; c < children.size(); ++c)
+                {
+                    readNode(children[c].asInt(-1), transform, depth + 1);
+                }
+            }
+        };
+    }
+
+    void readGlb(ArcModel::Builder &builder, const std::string &enginePath)
+    {
+        ArcMappedFile file{enginePath};
+        if (!file.isOpen())
+        {
+            throw std::runtime_error("failed to open model file: " + enginePath);
+        }
+
+        // header: magic, version, length, then JSON and BIN chunks of length, type, data
+        const uint8_t *data = file.data();
+        uint32_t header[3] = {};
+        if (file.size() < sizeof(header) + 8)
+        {
+            throw std::runtime_error("glb file is too small: " + enginePath);
+        }
+        std::memcpy(header, data, sizeof(header));
+        if (header[0] != GLB_MAGIC || header[1] != GLB_VERSION || header[2] > file.size())
+        {
+            throw std::runtime_error("not a glTF 2.0 binary file: " + enginePath);
+        }
+
+        const char *json = nullptr;
+        size_t jsonSize = 0;
+        const uint8_t *bin = nullptr;
+        size_t binSize = 0;
+        for (size_t offset = sizeof(header); offset + 8 <= header[2];)
+        {
+            uint32_t chunk[2];
+            std::memcpy(chunk, data + offset, sizeof(chunk));
+            offset += sizeof(chunk);
+            if (chunk[0] > header[2] - offset)
+            {
+                throw std::runtime_error("glb chunk runs past the end of the file: " + enginePath);
+            }
+
+            if (chunk[1] == GLB_CHUNK_JSON && json == nullptr)
+            {
+                json = reinterpret_cast<const char *>(data + offset);
+                jsonSize = chunk[0];
+            }
+            else if (chunk[1] == GLB_CHUNK_BIN && bin == nullptr)
+            {
+                bin = data + offset;
+                binSize = chunk[0];
+            }
+            offset += (chunk[0] + 3) & ~3u;
+        }
+        if (json == nullptr)
+        {
+            throw std::runtime_error("glb file has no JSON chunk: " + enginePath);
+        }
+
+        JsonValue gltf = JsonParser{json, json + jsonSize}.parse();
+
+        builder.vertices.clear();
+        builder.indices.clear();
+        builder.materials.clear();
+        builder.submeshes.clear();
+        readMaterials(gltf, builder.materials);
+        GlbReader reader{gltf, bin, binSize, builder};
+
+        // the default scene, or every mesh untransformed when the file has no scenes
+        const JsonValue &scenes = gltf["scenes"];
+        if (scenes.size() > 0)
+        {
+            const JsonValue &scene = scenes[static_cast<size_t>(gltf["scene"].asInt(0))];
+            const JsonValue &roots = scene["nodes"];
+            for (size_t r = 0; r < roots.size(); ++r)
+            {
+                reader.readNode(roots[r].asInt(-1), glm::mat4{1.0f}, 0);
+            }
+        }
+        else
+        {
+            for (size_t m = 0; m < gltf["meshes"].size(); ++m)
+            {
+                reader.readMesh(static_cast<int>(m), glm::mat4{1.0f});
+            }
+        }
+
+        if (reader.skippedPrimitives > 0)
+        {
+            std::cout << "Skipped " << reader.skippedPrimitives << " non-triangle glTF primitives in " << enginePath << '\n';
+        }
+    }
+}
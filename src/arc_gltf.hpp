@@ -0,0 +1,20 @@
+#ifndef __ARC_GLTF_H__
+#define __ARC_GLTF_H__
+
+#include "arc_model.hpp"
+
+// std
+#include <string>
+
+namespace arc
+{
+    // Reads every triangle primitive of the default scene of a binary glTF 2.0 file into builder,
+    // with node transforms applied. The file is memory mapped and the geometry is already indexed,
+    // so float attributes and 32-bit indices are copied as they are, other component types are converted.
+    // Every primitive adds a submesh run, materials keep their base color and the image URI of
+    // the base color texture, relative to the file.
+    // Only the embedded BIN buffer is supported, sparse accessors and morph targets are not.
+    void readGlb(ArcModel::Builder &builder, const std::string &enginePath);
+}
+
+#endif // __ARC_GLTF_H__
@@ -0,0 +1,244 @@
+#include "arc_hot_reload.hpp"
+#include "arc_swap_chain.hpp"
+
+// std
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifndef ENGINE_DIR
+#define ENGINE_DIR "../"
+#endif
+
+namespace arc
+{
+    namespace
+    {
+        // editors may write a file in several steps, a change is picked up once the file stayed quiet this long
+        constexpr std::chrono::milliseconds SETTLE_TIME{100};
+        // modification times are compared this often where inotify isn't available
+        constexpr std::chrono::milliseconds POLL_INTERVAL{500};
+
+        double elapsedMilliseconds(std::chrono::steady_clock::time_point startTime)
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        }
+
+        std::filesystem::file_time_type writeTime(const std::string &filepath)
+        {
+            std::error_code error;
+            auto time = std::filesystem::last_write_time(ENGINE_DIR + filepath, error);
+            return error ? std::filesystem::file_time_type::min() : time;
+        }
+    }
+
+    ArcHotReload::ArcHotReload(const std::vector<std::string> &directories)
+    {
+#ifdef __linux__
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyFd >= 0)
+        {
+            for (const auto &directory : directories)
+            {
+                // written in place or moved over, which covers editors that save through a temporary file
+                int wd = inotify_add_watch(inotifyFd, (ENGINE_DIR + directory).c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+                if (wd < 0)
+                {
+                    std::cout << "Failed to watch " << directory << " for changes\n";
+                    continue;
+                }
+                watchDirectories[wd] = normalize(directory);
+            }
+        }
+        else
+        {
+            std::cout << "inotify unavailable, polling watched files for changes\n";
+        }
+#endif
+
+        reloadThread = std::thread{&ArcHotReload::reloadLoop, this};
+    }
+
+    ArcHotReload::~ArcHotReload()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            stopping = true;
+            rebuildQueue.clear();
+        }
+        workAvailable.notify_all();
+        reloadThread.join();
+
+#ifdef __linux__
+        if (inotifyFd >= 0)
+        {
+            close(inotifyFd);
+        }
+#endif
+    }
+
+    std::string ArcHotReload::normalize(const std::string &filepath)
+    {
+        std::string path = std::filesystem::path{filepath}.lexically_normal().generic_string();
+        while (!path.empty() && path.back() == '/')
+        {
+            path.pop_back();
+        }
+        return path;
+    }
+
+    void ArcHotReload::watch(const std::string &filepath, Rebuild rebuild)
+    {
+        std::string path = normalize(filepath);
+        if (writeTimes.count(path) == 0)
+        {
+            writeTimes[path] = writeTime(path);
+        }
+        rebuilds[path].push_back(std::move(rebuild));
+    }
+
+    void ArcHotReload::retire(std::shared_ptr<void> resource)
+    {
+        // a frame recorded before this call is waited on by the swap chain at most MAX_FRAMES_IN_FLIGHT frames later
+        retired.push_back({std::move(resource), frame + ArcSwapChain::MAX_FRAMES_IN_FLIGHT});
+    }
+
+    void ArcHotReload::readChanges()
+    {
+        auto now = std::chrono::steady_clock::now();
+
+#ifdef __linux__
+        if (inotifyFd >= 0)
+        {
+            alignas(inotify_event) char buffer[4096];
+            ssize_t length;
+            while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0)
+            {
+                for (char *cursor = buffer; cursor < buffer + length;)
+                {
+                    auto *event = reinterpret_cast<inotify_event *>(cursor);
+                    cursor += sizeof(inotify_event) + event->len;
+
+                    auto directory = watchDirectories.find(event->wd);
+                    if (event->len == 0 || directory == watchDirectories.end())
+                        continue;
+
+                    std::string path = directory->second + '/' + event->name;
+                    if (rebuilds.count(path) != 0)
+                    {
+                        changed[path] = now;
+                    }
+                }
+            }
+            return;
+        }
+#endif
+
+        if (now - lastPoll < POLL_INTERVAL)
+            return;
+        lastPoll = now;
+        for (const auto &kv : rebuilds)
+        {
+            if (writeTime(kv.first) != writeTimes[kv.first] && changed.count(kv.first) == 0)
+            {
+                changed[kv.first] = now;
+            }
+        }
+    }
+
+    void ArcHotReload::update()
+    {
+        frame++;
+        while (!retired.empty() && retired.front().releaseFrame <= frame)
+        {
+            retired.pop_front();
+        }
+
+        readChanges();
+
+        auto now = std::chrono::steady_clock::now();
+        std::vector<std::pair<std::string, Rebuild>> queued{};
+        for (auto it = changed.begin(); it != changed.end();)
+        {
+            if (now - it->second < SETTLE_TIME)
+            {
+                ++it;
+                continue;
+            }
+
+            // closing a file without touching it, or writing it back unchanged, reloads nothing
+            auto time = writeTime(it->first);
+            if (time != writeTimes[it->first])
+            {
+                writeTimes[it->first] = time;
+                for (const auto &rebuild : rebuilds[it->first])
+                {
+                    queued.emplace_back(it->first, rebuild);
+                }
+            }
+            it = changed.erase(it);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            for (auto &job : queued)
+            {
+                rebuildQueue.push_back(std::move(job));
+            }
+            for (auto &swap : readySwaps)
+            {
+                activeSwaps.push_back(std::move(swap));
+            }
+            readySwaps.clear();
+        }
+        if (!queued.empty())
+        {
+            workAvailable.notify_one();
+        }
+
+        for (auto it = activeSwaps.begin(); it != activeSwaps.end();)
+        {
+            it = (*it)() ? activeSwaps.erase(it) : it + 1;
+        }
+    }
+
+    void ArcHotReload::reloadLoop()
+    {
+        while (true)
+        {
+            std::pair<std::string, Rebuild> job{};
+            {
+                std::unique_lock<std::mutex> lock{mutex};
+                workAvailable.wait(lock, [&]()
+                                   { return stopping || !rebuildQueue.empty(); });
+                if (stopping)
+                    return;
+
+                job = std::move(rebuildQueue.front());
+                rebuildQueue.pop_front();
+            }
+
+            auto startTime = std::chrono::steady_clock::now();
+            Swap swap{};
+            try
+            {
+                swap = job.second();
+            }
+            catch (const std::exception &e)
+            {
+                std::cout << "Failed to reload " << job.first << ", keeping the current version: " << e.what() << '\n';
+                continue;
+            }
+            std::cout << "Rebuilt " << job.first << " in " << elapsedMilliseconds(startTime) << " ms\n";
+
+            if (swap)
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                readySwaps.push_back(std::move(swap));
+            }
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef __ARC_HOT_RELOAD_H__
+#define __ARC_HOT_RELOAD_H__
+
+// std
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace arc
+{
+    // Rebuilds assets whose files change while the engine runs
+    // files are watched per directory with inotify on Linux, elsewhere the watched files' modification
+    // times are polled. A change runs the file's rebuild callbacks on a background thread, the swaps they
+    // return run in update() on the render thread, and the objects they replace are kept alive until
+    // every frame that could still use them retired.
+    class ArcHotReload
+    {
+    public:
+        // called in update() until it returns true, e.g. while an upload is still in flight
+        using Swap = std::function<bool()>;
+        // runs on the reload thread, an empty swap means nothing has to happen on the render thread
+        // a rebuild that throws keeps the current asset
+        using Rebuild = std::function<Swap()>;
+
+        // directories relative to ENGINE_DIR, not recursive
+        ArcHotReload(const std::vector<std::string> &directories);
+        ~ArcHotReload();
+
+        ArcHotReload(const ArcHotReload &) = delete;
+        ArcHotReload &operator=(const ArcHotReload &) = delete;
+
+        // filepath relative to ENGINE_DIR inside one of the watched directories, several rebuilds may share a file
+        void watch(const std::string &filepath, Rebuild rebuild);
+
+        // keeps resource alive until the frames submitted so far retired
+        void retire(std::shared_ptr<void> resource);
+
+        // call once per frame on the render thread, before beginFrame
+        void update();
+
+    private:
+        struct Retired
+        {
+            std::shared_ptr<void> resource;
+            uint64_t releaseFrame;
+        };
+
+        static std::string normalize(const std::string &filepath);
+
+        void readChanges();
+        void reloadLoop();
+
+        int inotifyFd = -1;
+        std::unordered_map<int, std::string> watchDirectories{};
+        // polling fallback, also used to skip events that didn't change the file
+        std::unordered_map<std::string, std::filesystem::file_time_type> writeTimes{};
+        std::chrono::steady_clock::time_point lastPoll{};
+
+        // render thread only
+        std::unordered_map<std::string, std::vector<Rebuild>> rebuilds{};
+        std::unordered_map<std::string, std::chrono::steady_clock::time_point> changed{};
+        std::vector<Swap> activeSwaps{};
+        std::deque<Retired> retired{};
+        uint64_t frame = 0;
+
+        std::thread reloadThread;
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        bool stopping = false;
+        // guarded by mutex
+        std::deque<std::pair<std::string, Rebuild>> rebuildQueue{};
+        std::vector<Swap> readySwaps{};
+    };
+}
+
+#endif // __ARC_HOT_RELOAD_H__
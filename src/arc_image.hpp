@@ -18,10 +18,12 @@ namespace arc
                          uint32_t miplevels, uint32_t arrayLayers, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties);
         void transitionImageLayout(VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
 
-        void createImageView(VkFormat format);
+        // components swizzles what shaders read, identity by default
+        void createImageView(VkFormat format, VkComponentMapping components = {});
 
         VkImage getImage() const { return image; }
         VkImageView getImageView() const { return imageView; }
+        uint32_t getMipLevels() const { return mipLevels; }
 
     private:
         ArcDevice &arcDevice;
@@ -29,6 +31,7 @@ namespace arc
         VkImage image{};
         VkDeviceMemory imageMemory{};
         VkImageView imageView{};
+        uint32_t mipLevels = 1;
     };
 }
 
@@ -0,0 +1,258 @@
+#include "arc_ktx2.hpp"
+
+// std
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace arc
+{
+    namespace
+    {
+        constexpr uint8_t KTX2_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+        struct Ktx2Header
+        {
+            uint8_t identifier[12];
+            uint32_t vkFormat;
+            uint32_t typeSize;
+            uint32_t pixelWidth;
+            uint32_t pixelHeight;
+            uint32_t pixelDepth;
+            uint32_t layerCount;
+            uint32_t faceCount;
+            uint32_t levelCount;
+            uint32_t supercompressionScheme;
+            uint32_t dfdByteOffset;
+            uint32_t dfdByteLength;
+            uint32_t kvdByteOffset;
+            uint32_t kvdByteLength;
+            uint64_t sgdByteOffset;
+            uint64_t sgdByteLength;
+        };
+        static_assert(sizeof(Ktx2Header) == 80, "KTX2 header is 80 bytes");
+
+        struct Ktx2Level
+        {
+            uint64_t byteOffset;
+            uint64_t byteLength;
+            uint64_t uncompressedByteLength;
+        };
+
+        // Khronos data format descriptor values used for BC formats
+        constexpr uint8_t KHR_DF_MODEL_BC1A = 128;
+        constexpr uint8_t KHR_DF_MODEL_BC3 = 130;
+        constexpr uint8_t KHR_DF_MODEL_BC7 = 134;
+        constexpr uint8_t KHR_DF_PRIMARIES_BT709 = 1;
+        constexpr uint8_t KHR_DF_TRANSFER_LINEAR = 1;
+        constexpr uint8_t KHR_DF_TRANSFER_SRGB = 2;
+        constexpr uint8_t KHR_DF_CHANNEL_COLOR = 0;
+        constexpr uint8_t KHR_DF_CHANNEL_ALPHA = 15;
+
+        void appendU32(std::vector<uint8_t> &out, uint32_t value)
+        {
+            uint8_t bytes[4];
+            std::memcpy(bytes, &value, 4);
+            out.insert(out.end(), bytes, bytes + 4);
+        }
+
+        // basic descriptor block with one sample per 64 bits of the block
+        std::vector<uint8_t> dataFormatDescriptor(BlockFormat format, bool srgb)
+        {
+            struct Sample
+            {
+                uint16_t bitOffset;
+                uint8_t bitLength; // minus one
+                uint8_t channel;
+            };
+            std::vector<Sample> samples{};
+            uint8_t model = KHR_DF_MODEL_BC1A;
+            switch (format)
+            {
+            case BlockFormat::BC1:
+                samples.push_back({0, 63, KHR_DF_CHANNEL_COLOR});
+                break;
+            case BlockFormat::BC3:
+                model = KHR_DF_MODEL_BC3;
+                samples.push_back({0, 63, KHR_DF_CHANNEL_ALPHA});
+                samples.push_back({64, 63, KHR_DF_CHANNEL_COLOR});
+                break;
+            case BlockFormat::BC7:
+                model = KHR_DF_MODEL_BC7;
+                samples.push_back({0, 127, KHR_DF_CHANNEL_COLOR});
+                break;
+            }
+
+            uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+            std::vector<uint8_t> dfd{};
+            appendU32(dfd, 4 + blockSize);
+            appendU32(dfd, 0);                     // vendor Khronos, basic descriptor type
+            appendU32(dfd, 2 | (blockSize << 16)); // version 1.3
+            dfd.push_back(model);
+            dfd.push_back(KHR_DF_PRIMARIES_BT709);
+            dfd.push_back(srgb ? KHR_DF_TRANSFER_SRGB : KHR_DF_TRANSFER_LINEAR);
+            dfd.push_back(0); // straight alpha
+            uint8_t dimensions[4] = {3, 3, 0, 0};
+            dfd.insert(dfd.end(), dimensions, dimensions + 4);
+            uint8_t bytesPlane[8] = {static_cast<uint8_t>(blockBytes(format))};
+            dfd.insert(dfd.end(), bytesPlane, bytesPlane + 8);
+            for (const auto &sample : samples)
+            {
+                // alpha is stored linearly whatever the color transfer is
+                uint8_t channelType = sample.channel == KHR_DF_CHANNEL_ALPHA && srgb ? (sample.channel | 0x10) : sample.channel;
+                appendU32(dfd, sample.bitOffset | (sample.bitLength << 16) | (channelType << 24));
+                appendU32(dfd, 0); // sample position
+                appendU32(dfd, 0);
+                appendU32(dfd, UINT32_MAX);
+            }
+            return dfd;
+        }
+    }
+
+    VkFormat blockVkFormat(BlockFormat format, bool srgb)
+    {
+        switch (format)
+        {
+        case BlockFormat::BC1:
+            return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+        case BlockFormat::BC3:
+            return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+        case BlockFormat::BC7:
+            return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+        }
+        return VK_FORMAT_UNDEFINED;
+    }
+
+    bool blockFormatOf(VkFormat vkFormat, BlockFormat &format, bool &srgb)
+    {
+        for (BlockFormat candidate : {BlockFormat::BC1, BlockFormat::BC3, BlockFormat::BC7})
+        {
+            for (bool candidateSrgb : {false, true})
+            {
+                if (blockVkFormat(candidate, candidateSrgb) == vkFormat)
+                {
+                    format = candidate;
+                    srgb = candidateSrgb;
+                    return true;
+                }
+            }
+        }
+        // BC1 with punch-through alpha decodes the same way
+        if (vkFormat == VK_FORMAT_BC1_RGBA_UNORM_BLOCK || vkFormat == VK_FORMAT_BC1_RGBA_SRGB_BLOCK)
+        {
+            format = BlockFormat::BC1;
+            srgb = vkFormat == VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+            return true;
+        }
+        return false;
+    }
+
+    Ktx2Texture readKtx2(const std::string &enginePath)
+    {
+        Ktx2Texture texture{};
+        texture.file = std::make_unique<ArcMappedFile>(enginePath);
+        if (!texture.file->isOpen())
+        {
+            throw std::runtime_error("failed to open " + enginePath);
+        }
+
+        const uint8_t *bytes = texture.file->data();
+        size_t fileSize = texture.file->size();
+        Ktx2Header header{};
+        if (fileSize < sizeof(header))
+        {
+            throw std::runtime_error(enginePath + " is not a KTX2 file!");
+        }
+        std::memcpy(&header, bytes, sizeof(header));
+        if (std::memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+        {
+            throw std::runtime_error(enginePath + " is not a KTX2 file!");
+        }
+        if (header.pixelHeight == 0 || header.pixelDepth != 0 || header.layerCount > 1 || header.faceCount != 1)
+        {
+            throw std::runtime_error(enginePath + ": only single 2D KTX2 images are supported!");
+        }
+        if (header.supercompressionScheme != 0)
+        {
+            throw std::runtime_error(enginePath + ": supercompressed KTX2 files are not supported!");
+        }
+
+        // a level count of 0 asks the loader to generate mips, the file still holds level 0
+        uint32_t levelCount = std::max(header.levelCount, 1u);
+        if (sizeof(header) + static_cast<size_t>(levelCount) * sizeof(Ktx2Level) > fileSize)
+        {
+            throw std::runtime_error(enginePath + ": truncated KTX2 level index!");
+        }
+
+        std::vector<Ktx2Level> levels(levelCount);
+        std::memcpy(levels.data(), bytes + sizeof(header), levelCount * sizeof(Ktx2Level));
+        uint64_t first = UINT64_MAX;
+        uint64_t end = 0;
+        for (const auto &level : levels)
+        {
+            if (level.byteLength == 0 || level.byteOffset > fileSize || level.byteLength > fileSize - level.byteOffset)
+            {
+                throw std::runtime_error(enginePath + ": KTX2 level outside the file!");
+            }
+            first = std::min(first, level.byteOffset);
+            end = std::max(end, level.byteOffset + level.byteLength);
+        }
+
+        texture.format = static_cast<VkFormat>(header.vkFormat);
+        texture.width = header.pixelWidth;
+        texture.height = header.pixelHeight;
+        texture.data = bytes + first;
+        texture.size = end - first;
+        for (const auto &level : levels)
+        {
+            texture.levelOffsets.push_back(level.byteOffset - first);
+            texture.levelSizes.push_back(level.byteLength);
+        }
+        return texture;
+    }
+
+    void writeKtx2(const std::string &enginePath, BlockFormat format, bool srgb, uint32_t width, uint32_t height,
+                   const std::vector<std::vector<uint8_t>> &levels)
+    {
+        std::vector<uint8_t> dfd = dataFormatDescriptor(format, srgb);
+        uint32_t levelCount = static_cast<uint32_t>(levels.size());
+
+        Ktx2Header header{};
+        std::memcpy(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+        header.vkFormat = static_cast<uint32_t>(blockVkFormat(format, srgb));
+        header.typeSize = 1;
+        header.pixelWidth = width;
+        header.pixelHeight = height;
+        header.faceCount = 1;
+        header.levelCount = levelCount;
+        header.dfdByteOffset = static_cast<uint32_t>(sizeof(header) + levelCount * sizeof(Ktx2Level));
+        header.dfdByteLength = static_cast<uint32_t>(dfd.size());
+
+        // levels are aligned to the block size, the smallest one comes first
+        uint64_t alignment = blockBytes(format);
+        uint64_t offset = header.dfdByteOffset + header.dfdByteLength;
+        std::vector<Ktx2Level> index(levelCount);
+        for (uint32_t i = levelCount; i-- > 0;)
+        {
+            offset = (offset + alignment - 1) / alignment * alignment;
+            index[i] = {offset, levels[i].size(), levels[i].size()};
+            offset += levels[i].size();
+        }
+
+        std::vector<uint8_t> file(offset, 0);
+        std::memcpy(file.data(), &header, sizeof(header));
+        std::memcpy(file.data() + sizeof(header), index.data(), index.size() * sizeof(Ktx2Level));
+        std::memcpy(file.data() + header.dfdByteOffset, dfd.data(), dfd.size());
+        for (uint32_t i = 0; i < levelCount; ++i)
+        {
+            std::memcpy(file.data() + index[i].byteOffset, levels[i].data(), levels[i].size());
+        }
+
+        std::ofstream out{enginePath, std::ios::binary | std::ios::trunc};
+        if (!out.write(reinterpret_cast<const char *>(file.data()), static_cast<std::streamsize>(file.size())))
+        {
+            throw std::runtime_error("failed to write " + enginePath);
+        }
+    }
+}
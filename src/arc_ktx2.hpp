@@ -0,0 +1,43 @@
+#ifndef __ARC_KTX2_H__
+#define __ARC_KTX2_H__
+
+#include "arc_block_compression.hpp"
+#include "arc_mapped_file.hpp"
+
+// libs
+#include <vulkan/vulkan.h>
+
+// std
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace arc
+{
+    // A memory mapped KTX2 file, the mip levels are staged for upload straight from the mapping
+    struct Ktx2Texture
+    {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        // the levels form one range of the file, level i (largest first) starts at data + levelOffsets[i]
+        const uint8_t *data = nullptr;
+        VkDeviceSize size = 0;
+        std::vector<VkDeviceSize> levelOffsets{};
+        std::vector<VkDeviceSize> levelSizes{};
+
+        std::unique_ptr<ArcMappedFile> file{};
+    };
+
+    // Single 2D image without supercompression, which is what writeKtx2 produces
+    Ktx2Texture readKtx2(const std::string &enginePath);
+    // levels largest first, stored smallest first with a data format descriptor as the spec asks
+    void writeKtx2(const std::string &enginePath, BlockFormat format, bool srgb, uint32_t width, uint32_t height,
+                   const std::vector<std::vector<uint8_t>> &levels);
+
+    VkFormat blockVkFormat(BlockFormat format, bool srgb);
+    // false for formats that aren't BC1, BC3 or BC7
+    bool blockFormatOf(VkFormat vkFormat, BlockFormat &format, bool &srgb);
+}
+
+#endif // __ARC_KTX2_H__
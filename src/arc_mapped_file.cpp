@@ -0,0 +1,148 @@
+#include "arc_mapped_file.hpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// std
+#include <algorithm>
+
+namespace arc
+{
+#ifdef _WIN32
+    ArcMappedFile::ArcMappedFile(const std::string &filepath)
+    {
+        HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return;
+        fileHandle = file;
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size))
+        {
+            close();
+            return;
+        }
+        fileSize = static_cast<size_t>(size.QuadPart);
+        opened = true;
+
+        // an empty file can't be mapped, but it is still a valid (empty) view
+        if (fileSize == 0)
+            return;
+
+        mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle == nullptr)
+        {
+            close();
+            return;
+        }
+
+        mapped = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if (mapped == nullptr)
+        {
+            close();
+        }
+    }
+
+    void ArcMappedFile::close()
+    {
+        if (mapped)
+            UnmapViewOfFile(mapped);
+        if (mappingHandle)
+            CloseHandle(mappingHandle);
+        if (fileHandle)
+            CloseHandle(fileHandle);
+
+        mapped = nullptr;
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+        fileSize = 0;
+        opened = false;
+    }
+
+    void ArcMappedFile::discard(size_t offset, size_t size)
+    {
+        if (mapped == nullptr || offset >= fileSize)
+            return;
+
+        // unlocking pages that were never locked takes them out of the working set
+        VirtualUnlock(static_cast<uint8_t *>(mapped) + offset, std::min(size, fileSize - offset));
+    }
+#else
+    ArcMappedFile::ArcMappedFile(const std::string &filepath)
+    {
+        fileDescriptor = ::open(filepath.c_str(), O_RDONLY);
+        if (fileDescriptor < 0)
+            return;
+
+        struct stat fileStat{};
+        if (fstat(fileDescriptor, &fileStat) != 0)
+        {
+            close();
+            return;
+        }
+        fileSize = static_cast<size_t>(fileStat.st_size);
+        opened = true;
+
+        // an empty file can't be mapped, but it is still a valid (empty) view
+        if (fileSize == 0)
+            return;
+
+        void *view = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        if (view == MAP_FAILED)
+        {
+            close();
+            return;
+        }
+        mapped = view;
+
+        // the loaders walk the file front to back
+        madvise(mapped, fileSize, MADV_SEQUENTIAL);
+    }
+
+    void ArcMappedFile::close()
+    {
+        if (mapped)
+            munmap(mapped, fileSize);
+        if (fileDescriptor >= 0)
+            ::close(fileDescriptor);
+
+        mapped = nullptr;
+        fileDescriptor = -1;
+        fileSize = 0;
+        opened = false;
+    }
+
+    void ArcMappedFile::discard(size_t offset, size_t size)
+    {
+        if (mapped == nullptr || offset >= fileSize)
+            return;
+
+        // only whole pages inside the range can go
+        size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t begin = (offset + pageSize - 1) / pageSize * pageSize;
+        size_t end = std::min(offset + size, fileSize) / pageSize * pageSize;
+        if (begin < end)
+        {
+            madvise(static_cast<uint8_t *>(mapped) + begin, end - begin, MADV_DONTNEED);
+        }
+    }
+#endif
+
+    ArcMappedFile::~ArcMappedFile()
+    {
+        close();
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef __ARC_MAPPED_FILE_H__
+#define __ARC_MAPPED_FILE_H__
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace arc
+{
+    // Read-only memory mapping of a whole file
+    // the view stays valid for the lifetime of the object
+    class ArcMappedFile
+    {
+    public:
+        ArcMappedFile(const std::string &filepath);
+        ~ArcMappedFile();
+
+        ArcMappedFile(const ArcMappedFile &) = delete;
+        ArcMappedFile &operator=(const ArcMappedFile &) = delete;
+
+        bool isOpen() const { return opened; }
+
+        const uint8_t *data() const { return static_cast<const uint8_t *>(mapped); }
+        size_t size() const { return fileSize; }
+
+        // drops the pages of a range that was read already from the resident set,
+        // they are read back from the file if touched again
+        void discard(size_t offset, size_t size);
+
+    private:
+        void close();
+
+        void *mapped = nullptr;
+        size_t fileSize = 0;
+        bool opened = false;
+
+#ifdef _WIN32
+        void *fileHandle = nullptr;
+        void *mappingHandle = nullptr;
+#else
+        int fileDescriptor = -1;
+#endif
+    };
+}
+
+#endif // __ARC_MAPPED_FILE_H__
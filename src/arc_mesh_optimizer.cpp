@@ -0,0 +1,280 @@
+#include "arc_mesh_optimizer.hpp"
+
+// std
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+namespace arc
+{
+    namespace
+    {
+        // Forsyth's tuning constants, the simulated cache is LRU
+        constexpr uint32_t CACHE_SIZE = 32;
+        constexpr float CACHE_DECAY_POWER = 1.5f;
+        constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+        constexpr float VALENCE_BOOST_SCALE = 2.0f;
+        constexpr float VALENCE_BOOST_POWER = 0.5f;
+        constexpr uint32_t VALENCE_TABLE_SIZE = 64;
+
+        constexpr size_t NO_TRIANGLE = SIZE_MAX;
+
+        struct ScoreTable
+        {
+            float cache[CACHE_SIZE];
+            float valence[VALENCE_TABLE_SIZE];
+
+            ScoreTable()
+            {
+                for (uint32_t i = 0; i < CACHE_SIZE; ++i)
+                {
+                    // the three most recent vertices belong to the last triangle, so they score the same
+                    cache[i] = i < 3 ? LAST_TRIANGLE_SCORE
+                                     : std::pow(1.0f - float(i - 3) / float(CACHE_SIZE - 3), CACHE_DECAY_POWER);
+                }
+                valence[0] = 0.0f;
+                for (uint32_t i = 1; i < VALENCE_TABLE_SIZE; ++i)
+                {
+                    valence[i] = VALENCE_BOOST_SCALE * std::pow(float(i), -VALENCE_BOOST_POWER);
+                }
+            }
+        };
+
+        float vertexScore(const ScoreTable &table, int32_t cachePosition, uint32_t remainingTriangles)
+        {
+            // vertices with no triangles left never attract anything
+            if (remainingTriangles == 0)
+                return -1.0f;
+
+            float score = cachePosition >= 0 ? table.cache[cachePosition] : 0.0f;
+            score += remainingTriangles < VALENCE_TABLE_SIZE
+                         ? table.valence[remainingTriangles]
+                         : VALENCE_BOOST_SCALE * std::pow(float(remainingTriangles), -VALENCE_BOOST_POWER);
+            return score;
+        }
+    }
+
+    void optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount)
+    {
+        static const ScoreTable scoreTable{};
+
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0 || vertexCount == 0)
+            return;
+
+        // vertex -> triangle adjacency, the live triangles of v are the first remaining[v] entries of its list
+        std::vector<uint32_t> remaining(vertexCount, 0);
+        for (uint32_t index : indices)
+        {
+            assert(index < vertexCount && "Index out of range");
+            remaining[index]++;
+        }
+
+        std::vector<size_t> offsets(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            offsets[v + 1] = offsets[v] + remaining[v];
+        }
+
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < indices.size(); ++i)
+            {
+                adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        std::vector<int32_t> cachePositions(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            vertexScores[v] = vertexScore(scoreTable, -1, remaining[v]);
+        }
+
+        std::vector<float> triangleScores(triangleCount);
+        std::vector<uint8_t> emitted(triangleCount, 0);
+        size_t bestTriangle = 0;
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            triangleScores[t] = vertexScores[indices[3 * t + 0]] +
+                                vertexScores[indices[3 * t + 1]] +
+                                vertexScores[indices[3 * t + 2]];
+            if (triangleScores[t] > triangleScores[bestTriangle])
+                bestTriangle = t;
+        }
+
+        std::vector<uint32_t> output{};
+        output.reserve(indices.size());
+
+        uint32_t cache[CACHE_SIZE + 3];
+        uint32_t cacheCount = 0;
+        size_t inputCursor = 0;
+
+        while (bestTriangle != NO_TRIANGLE)
+        {
+            emitted[bestTriangle] = 1;
+            const uint32_t *triangle = &indices[3 * bestTriangle];
+            output.insert(output.end(), triangle, triangle + 3);
+
+            // the emitted corners go to the front of the cache, older entries shift back
+            uint32_t newCache[CACHE_SIZE + 3];
+            uint32_t newCacheCount = 0;
+            for (int k = 0; k < 3; ++k)
+            {
+                uint32_t v = triangle[k];
+
+                uint32_t *live = &adjacency[offsets[v]];
+                for (uint32_t i = 0; i < remaining[v]; ++i)
+                {
+                    if (live[i] == bestTriangle)
+                    {
+                        live[i] = live[remaining[v] - 1];
+                        remaining[v]--;
+                        break;
+                    }
+                }
+
+                bool cached = false;
+                for (uint32_t c = 0; c < newCacheCount; ++c)
+                    cached = cached || newCache[c] == v;
+                if (!cached)
+                    newCache[newCacheCount++] = v;
+            }
+            for (uint32_t c = 0; c < cacheCount; ++c)
+            {
+                uint32_t v = cache[c];
+                if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+                    newCache[newCacheCount++] = v;
+            }
+
+            // entries past CACHE_SIZE fall out of the cache this step
+            for (uint32_t c = 0; c < newCacheCount; ++c)
+            {
+                uint32_t v = newCache[c];
+                cachePositions[v] = c < CACHE_SIZE ? static_cast<int32_t>(c) : -1;
+                vertexScores[v] = vertexScore(scoreTable, cachePositions[v], remaining[v]);
+            }
+
+            // only triangles touching the cache changed score, and the next pick comes from them
+            bestTriangle = NO_TRIANGLE;
+            float bestScore = -1.0f;
+            for (uint32_t c = 0; c < newCacheCount; ++c)
+            {
+                uint32_t v = newCache[c];
+                const uint32_t *live = &adjacency[offsets[v]];
+                for (uint32_t i = 0; i < remaining[v]; ++i)
+                {
+                    uint32_t t = live[i];
+                    float score = vertexScores[indices[3 * t + 0]] +
+                                  vertexScores[indices[3 * t + 1]] +
+                                  vertexScores[indices[3 * t + 2]];
+                    triangleScores[t] = score;
+                    if (c < CACHE_SIZE && score > bestScore)
+                    {
+                        bestScore = score;
+                        bestTriangle = t;
+                    }
+                }
+            }
+
+            cacheCount = newCacheCount < CACHE_SIZE ? newCacheCount : CACHE_SIZE;
+            for (uint32_t c = 0; c < cacheCount; ++c)
+            {
+                cache[c] = newCache[c];
+            }
+
+            // nothing in the cache has triangles left, restart from the next unemitted triangle in input order
+            if (bestTriangle == NO_TRIANGLE)
+            {
+                while (inputCursor < triangleCount && emitted[inputCursor])
+                    ++inputCursor;
+                if (inputCursor < triangleCount)
+                    bestTriangle = inputCursor;
+            }
+        }
+
+        // trailing indices that don't form a full triangle are dropped, as the draw would ignore them anyway
+        indices = std::move(output);
+    }
+
+    void optimizeVertexFetch(std::vector<ArcModel::Vertex> &vertices, std::vector<uint32_t> &indices)
+    {
+        std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+        std::vector<ArcModel::Vertex> reordered{};
+        reordered.reserve(vertices.size());
+
+        for (uint32_t &index : indices)
+        {
+            if (remap[index] == UINT32_MAX)
+            {
+                remap[index] = static_cast<uint32_t>(reordered.size());
+                reordered.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+
+        vertices = std::move(reordered);
+    }
+
+    VertexCacheStats analyzeVertexCache(const std::vector<uint32_t> &indices, size_t vertexCount, uint32_t cacheSize)
+    {
+        VertexCacheStats stats{};
+        if (indices.size() < 3 || vertexCount == 0)
+            return stats;
+
+        // a vertex is still cached if fewer than cacheSize misses happened since it was loaded
+        std::vector<uint32_t> timestamps(vertexCount, 0);
+        uint32_t time = cacheSize + 1;
+        size_t misses = 0;
+        for (uint32_t index : indices)
+        {
+            if (time - timestamps[index] > cacheSize)
+            {
+                timestamps[index] = time++;
+                misses++;
+            }
+        }
+
+        stats.acmr = float(misses) / float(indices.size() / 3);
+        stats.atvr = float(misses) / float(vertexCount);
+        return stats;
+    }
+
+    VertexFetchStats analyzeVertexFetch(const std::vector<uint32_t> &indices, size_t vertexCount, uint32_t vertexStride,
+                                        uint32_t cacheSize)
+    {
+        VertexFetchStats stats{};
+        if (indices.empty() || vertexCount == 0)
+            return stats;
+
+        // roughly the L1 a vertex fetch goes through on current GPUs
+        constexpr size_t LINE_SIZE = 64;
+        constexpr size_t LINE_COUNT = 16 * 1024 / LINE_SIZE;
+        std::vector<size_t> lines(LINE_COUNT, SIZE_MAX);
+
+        std::vector<uint32_t> timestamps(vertexCount, 0);
+        uint32_t time = cacheSize + 1;
+        for (uint32_t index : indices)
+        {
+            if (time - timestamps[index] <= cacheSize)
+                continue;
+            timestamps[index] = time++;
+
+            size_t first = size_t(index) * vertexStride / LINE_SIZE;
+            size_t last = (size_t(index) * vertexStride + vertexStride - 1) / LINE_SIZE;
+            for (size_t line = first; line <= last; ++line)
+            {
+                size_t &slot = lines[line % LINE_COUNT];
+                if (slot != line)
+                {
+                    slot = line;
+                    stats.bytesFetched += LINE_SIZE;
+                }
+            }
+        }
+
+        stats.overfetch = float(stats.bytesFetched) / float(vertexCount * vertexStride);
+        return stats;
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef __ARC_MESH_OPTIMIZER_H__
+#define __ARC_MESH_OPTIMIZER_H__
+
+#include "arc_model.hpp"
+
+// std
+#include <cstdint>
+#include <vector>
+
+namespace arc
+{
+    struct VertexCacheStats
+    {
+        // average cache miss ratio: transformed vertices per triangle, 0.5 is ideal for a grid
+        float acmr = 0.0f;
+        // average transform to vertex ratio: transformed vertices per unique vertex, 1.0 is ideal
+        float atvr = 0.0f;
+    };
+
+    struct VertexFetchStats
+    {
+        // bytes read from memory by the vertex fetch
+        size_t bytesFetched = 0;
+        // bytes fetched per byte of vertex data, 1.0 when every vertex is read exactly once
+        float overfetch = 0.0f;
+    };
+
+    // Reorder triangles for post-transform vertex cache reuse (Forsyth, "Linear-Speed Vertex Cache Optimisation")
+    void optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount);
+
+    // Renumber vertices in the order the index buffer first uses them, so fetches walk memory forwards
+    // vertices that no triangle references are dropped
+    void optimizeVertexFetch(std::vector<ArcModel::Vertex> &vertices, std::vector<uint32_t> &indices);
+
+    // Simulate a FIFO post-transform cache of the given size over the index buffer
+    VertexCacheStats analyzeVertexCache(const std::vector<uint32_t> &indices, size_t vertexCount, uint32_t cacheSize = 16);
+
+    // Simulate the memory traffic of fetching vertexStride bytes for every post-transform cache miss,
+    // through a small direct mapped cache of 64-byte lines
+    VertexFetchStats analyzeVertexFetch(const std::vector<uint32_t> &indices, size_t vertexCount, uint32_t vertexStride,
+                                        uint32_t cacheSize = 16);
+}
+
+#endif // __ARC_MESH_OPTIMIZER_H__
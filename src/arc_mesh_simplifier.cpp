@@ -0,0 +1,346 @@
+#include "arc_mesh_simplifier.hpp"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <tuple>
+
+namespace arc
+{
+    namespace
+    {
+        // a collapse may rotate a surrounding triangle's normal by at most ~75 degrees
+        constexpr float MAX_NORMAL_FLIP = 0.25f;
+
+        // symmetric 4x4 error quadric, sum of squared distances to a set of planes
+        struct Quadric
+        {
+            double xx = 0, xy = 0, xz = 0, xw = 0;
+            double yy = 0, yz = 0, yw = 0;
+            double zz = 0, zw = 0;
+            double ww = 0;
+
+            static Quadric fromPlane(glm::vec3 n, float d)
+            {
+                Quadric q{};
+                q.xx = double(n.x) * n.x;
+                q.xy = double(n.x) * n.y;
+                q.xz = double(n.x) * n.z;
+                q.xw = double(n.x) * d;
+                q.yy = double(n.y) * n.y;
+                q.yz = double(n.y) * n.z;
+                q.yw = double(n.y) * d;
+                q.zz = double(n.z) * n.z;
+                q.zw = double(n.z) * d;
+                q.ww = double(d) * d;
+                return q;
+            }
+
+            Quadric &operator+=(const Quadric &o)
+            {
+                xx += o.xx, xy += o.xy, xz += o.xz, xw += o.xw;
+                yy += o.yy, yz += o.yz, yw += o.yw;
+                zz += o.zz, zw += o.zw;
+                ww += o.ww;
+                return *this;
+            }
+
+            double evaluate(glm::vec3 p) const
+            {
+                double x = p.x, y = p.y, z = p.z;
+                double error = xx * x * x + 2 * xy * x * y + 2 * xz * x * z + 2 * xw * x +
+                               yy * y * y + 2 * yz * y * z + 2 * yw * y +
+                               zz * z * z + 2 * zw * z +
+                               ww;
+                return error > 0 ? error : 0;
+            }
+        };
+
+        // moves every vertex at the source position onto the target position
+        struct Collapse
+        {
+            uint32_t source; // canonical vertex ids
+            uint32_t target;
+            double cost;
+        };
+
+        uint64_t edgeKey(uint32_t a, uint32_t b)
+        {
+            return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+        }
+    }
+
+    std::vector<uint32_t> simplifyMesh(const std::vector<uint32_t> &indices,
+                                       const float *positionData,
+                                       size_t positionStride,
+                                       size_t vertexCount,
+                                       size_t targetIndexCount,
+                                       float targetError,
+                                       float *resultError)
+    {
+        std::vector<uint32_t> result(indices.begin(), indices.begin() + indices.size() / 3 * 3);
+        if (resultError)
+            *resultError = 0.0f;
+        if (result.size() <= targetIndexCount || vertexCount == 0)
+            return result;
+
+        // positions are scaled so the bounding box diagonal is 1, which makes errors relative
+        std::vector<glm::vec3> positions(vertexCount);
+        glm::vec3 minPosition{0.0f};
+        glm::vec3 maxPosition{0.0f};
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            const float *p = reinterpret_cast<const float *>(reinterpret_cast<const uint8_t *>(positionData) + positionStride * v);
+            positions[v] = glm::vec3{p[0], p[1], p[2]};
+            minPosition = v == 0 ? positions[v] : glm::min(minPosition, positions[v]);
+            maxPosition = v == 0 ? positions[v] : glm::max(maxPosition, positions[v]);
+        }
+        float diagonal = glm::length(maxPosition - minPosition);
+        float invDiagonal = diagonal > 0.0f ? 1.0f / diagonal : 1.0f;
+        for (auto &position : positions)
+        {
+            position = (position - minPosition) * invDiagonal;
+        }
+
+        // vertices sharing a position are wedges of one canonical vertex, the lowest id among them
+        std::vector<uint32_t> canonical(vertexCount);
+        {
+            std::vector<uint32_t> order(vertexCount);
+            for (uint32_t v = 0; v < vertexCount; ++v)
+                order[v] = v;
+
+            auto positionBits = [&](uint32_t v)
+            {
+                uint32_t bits[3];
+                std::memcpy(bits, &positions[v], sizeof(bits));
+                return std::make_tuple(bits[0], bits[1], bits[2]);
+            };
+            std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+                      { auto pa = positionBits(a), pb = positionBits(b);
+                        return pa != pb ? pa < pb : a < b; });
+
+            for (size_t i = 0; i < order.size();)
+            {
+                size_t j = i;
+                while (j < order.size() && positionBits(order[j]) == positionBits(order[i]))
+                    ++j;
+                for (size_t k = i; k < j; ++k)
+                    canonical[order[k]] = order[i];
+                i = j;
+            }
+        }
+
+        // lock open borders and non-manifold edges
+        std::vector<uint8_t> locked(vertexCount, 0);
+        {
+            std::vector<uint64_t> edges{};
+            edges.reserve(result.size());
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                for (int k = 0; k < 3; ++k)
+                {
+                    uint32_t a = canonical[result[i + k]];
+                    uint32_t b = canonical[result[i + (k + 1) % 3]];
+                    if (a != b)
+                        edges.push_back(edgeKey(a, b));
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+            for (size_t i = 0; i < edges.size();)
+            {
+                size_t j = i;
+                while (j < edges.size() && edges[j] == edges[i])
+                    ++j;
+                if (j - i != 2)
+                {
+                    locked[uint32_t(edges[i] >> 32)] = 1;
+                    locked[uint32_t(edges[i] & 0xffffffff)] = 1;
+                }
+                i = j;
+            }
+        }
+
+        std::vector<Quadric> quadrics(vertexCount);
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            glm::vec3 p0 = positions[result[i + 0]];
+            glm::vec3 normal = glm::cross(positions[result[i + 1]] - p0, positions[result[i + 2]] - p0);
+            float area = glm::length(normal);
+            if (area == 0.0f)
+                continue;
+            normal /= area;
+
+            Quadric plane = Quadric::fromPlane(normal, -glm::dot(normal, p0));
+            for (int k = 0; k < 3; ++k)
+                quadrics[canonical[result[i + k]]] += plane;
+        }
+
+        double errorLimit = double(targetError) * targetError;
+        double reachedError = 0.0;
+
+        std::vector<uint32_t> remap(vertexCount);
+        std::vector<uint8_t> touched(vertexCount);
+        std::vector<uint32_t> triangleOffsets(vertexCount + 1);
+        std::vector<uint32_t> adjacency{};
+        std::vector<Collapse> collapses{};
+        std::vector<std::pair<uint32_t, uint32_t>> wedgeMap{};
+
+        while (result.size() > targetIndexCount)
+        {
+            size_t triangleCount = result.size() / 3;
+
+            // position -> triangle adjacency of the current mesh
+            std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+            for (uint32_t index : result)
+                triangleOffsets[canonical[index] + 1]++;
+            for (size_t v = 0; v < vertexCount; ++v)
+                triangleOffsets[v + 1] += triangleOffsets[v];
+            adjacency.resize(result.size());
+            {
+                std::vector<uint32_t> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+                for (size_t i = 0; i < result.size(); ++i)
+                    adjacency[fill[canonical[result[i]]]++] = static_cast<uint32_t>(i / 3);
+            }
+
+            // every directed edge with a movable source is a candidate, cheapest first
+            collapses.clear();
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                for (int k = 0; k < 3; ++k)
+                {
+                    uint32_t a = canonical[result[i + k]];
+                    uint32_t b = canonical[result[i + (k + 1) % 3]];
+                    if (a == b)
+                        continue;
+                    for (auto [source, target] : {std::make_pair(a, b), std::make_pair(b, a)})
+                    {
+                        if (locked[source])
+                            continue;
+                        Quadric q = quadrics[source];
+                        q += quadrics[target];
+                        double cost = q.evaluate(positions[target]);
+                        if (cost <= errorLimit)
+                            collapses.push_back({source, target, cost});
+                    }
+                }
+            }
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse &a, const Collapse &b)
+                      { return a.cost != b.cost ? a.cost < b.cost
+                                                : (a.source != b.source ? a.source < b.source : a.target < b.target); });
+
+            for (uint32_t v = 0; v < vertexCount; ++v)
+                remap[v] = v;
+            std::fill(touched.begin(), touched.end(), 0);
+
+            size_t collapsed = 0;
+            for (const Collapse &collapse : collapses)
+            {
+                if (triangleCount * 3 <= targetIndexCount)
+                    break;
+
+                uint32_t source = collapse.source;
+                uint32_t target = collapse.target;
+                if (touched[source] || touched[target])
+                    continue;
+
+                // each source vertex takes the attributes of the target vertex it shares a triangle with,
+                // so a seam only collapses along itself and a source vertex without a partner blocks the collapse
+                bool valid = true;
+                size_t removed = 0;
+                wedgeMap.clear();
+                for (uint32_t j = triangleOffsets[source]; j < triangleOffsets[source + 1] && valid; ++j)
+                {
+                    const uint32_t *triangle = &result[3 * adjacency[j]];
+                    uint32_t sourceWedge = 0;
+                    uint32_t targetWedge = UINT32_MAX;
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        if (canonical[triangle[k]] == source)
+                            sourceWedge = triangle[k];
+                        if (canonical[triangle[k]] == target)
+                            targetWedge = triangle[k];
+                    }
+                    if (targetWedge == UINT32_MAX)
+                        continue;
+
+                    removed++;
+                    auto mapped = std::find_if(wedgeMap.begin(), wedgeMap.end(), [&](const auto &pair)
+                                               { return pair.first == sourceWedge; });
+                    if (mapped == wedgeMap.end())
+                        wedgeMap.push_back({sourceWedge, targetWedge});
+                    else
+                        valid = mapped->second == targetWedge;
+                }
+
+                // moving source onto target must not fold any remaining triangle over
+                for (uint32_t j = triangleOffsets[source]; j < triangleOffsets[source + 1] && valid; ++j)
+                {
+                    const uint32_t *triangle = &result[3 * adjacency[j]];
+                    if (canonical[triangle[0]] == target || canonical[triangle[1]] == target || canonical[triangle[2]] == target)
+                        continue;
+
+                    glm::vec3 p[3];
+                    glm::vec3 moved[3];
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        p[k] = positions[triangle[k]];
+                        moved[k] = canonical[triangle[k]] == source ? positions[target] : p[k];
+                        if (canonical[triangle[k]] == source)
+                        {
+                            valid = valid && std::any_of(wedgeMap.begin(), wedgeMap.end(), [&](const auto &pair)
+                                                         { return pair.first == triangle[k]; });
+                        }
+                    }
+                    glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                    glm::vec3 after = glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+                    valid = valid && glm::dot(before, after) >= MAX_NORMAL_FLIP * glm::length(before) * glm::length(after);
+                }
+                if (!valid || wedgeMap.empty())
+                    continue;
+
+                for (const auto &[sourceWedge, targetWedge] : wedgeMap)
+                    remap[sourceWedge] = targetWedge;
+                quadrics[target] += quadrics[source];
+                reachedError = std::max(reachedError, collapse.cost);
+                triangleCount -= removed;
+                collapsed++;
+
+                // the one-ring of source changed, its other collapses wait for the next pass
+                for (uint32_t j = triangleOffsets[source]; j < triangleOffsets[source + 1]; ++j)
+                {
+                    const uint32_t *triangle = &result[3 * adjacency[j]];
+                    for (int k = 0; k < 3; ++k)
+                        touched[canonical[triangle[k]]] = 1;
+                }
+            }
+
+            if (collapsed == 0)
+                break;
+
+            // apply the collapses and drop triangles that became degenerate
+            size_t write = 0;
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                uint32_t a = remap[result[i + 0]];
+                uint32_t b = remap[result[i + 1]];
+                uint32_t c = remap[result[i + 2]];
+                if (canonical[a] == canonical[b] || canonical[b] == canonical[c] || canonical[a] == canonical[c])
+                    continue;
+                result[write++] = a;
+                result[write++] = b;
+                result[write++] = c;
+            }
+            result.resize(write);
+        }
+
+        if (resultError)
+            *resultError = static_cast<float>(std::sqrt(reachedError));
+        return result;
+    }
+}
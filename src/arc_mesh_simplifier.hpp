@@ -0,0 +1,28 @@
+#ifndef __ARC_MESH_SIMPLIFIER_H__
+#define __ARC_MESH_SIMPLIFIER_H__
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace arc
+{
+    // Quadric error metric simplification (Garland & Heckbert) using half-edge collapses,
+    // so the simplified index buffer keeps referencing the original vertex buffer.
+    // Vertices sharing a position move together, attribute seams only collapse along themselves
+    // and vertices on open borders or non-manifold edges never move.
+    //
+    // targetIndexCount: stop once the result has at most this many indices
+    // targetError: largest allowed error, relative to the mesh's bounding box diagonal
+    // returns the simplified indices; resultError receives the relative error actually reached
+    std::vector<uint32_t> simplifyMesh(const std::vector<uint32_t> &indices,
+                                       const float *positions,
+                                       size_t positionStride,
+                                       size_t vertexCount,
+                                       size_t targetIndexCount,
+                                       float targetError,
+                                       float *resultError = nullptr);
+}
+
+#endif // __ARC_MESH_SIMPLIFIER_H__
@@ -0,0 +1,247 @@
+#include "arc_meshlet.hpp"
+
+// std
+#include <algorithm>
+#include <cmath>
+
+namespace arc
+{
+    namespace
+    {
+        constexpr uint8_t NOT_IN_MESHLET = 0xff;
+
+        // cones wider than this (dot of the widest normal with the axis) can't cull anything useful
+        constexpr float MIN_CONE_SPREAD = 0.1f;
+
+        glm::vec3 loadPosition(const float *positions, size_t positionStride, uint32_t vertex)
+        {
+            const float *p = reinterpret_cast<const float *>(reinterpret_cast<const uint8_t *>(positions) + positionStride * vertex);
+            return glm::vec3{p[0], p[1], p[2]};
+        }
+    }
+
+    void buildMeshlets(MeshletData &data,
+                       const std::vector<uint32_t> &indices,
+                       const float *positions,
+                       size_t positionStride)
+    {
+        data = MeshletData{};
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0)
+            return;
+
+        uint32_t vertexCount = *std::max_element(indices.begin(), indices.begin() + 3 * triangleCount) + 1;
+
+        // vertex -> triangle adjacency
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (size_t i = 0; i < 3 * triangleCount; ++i)
+        {
+            offsets[indices[i] + 1]++;
+        }
+        for (uint32_t v = 0; v < vertexCount; ++v)
+        {
+            offsets[v + 1] += offsets[v];
+        }
+        std::vector<uint32_t> adjacency(3 * triangleCount);
+        {
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < 3 * triangleCount; ++i)
+            {
+                adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        std::vector<uint8_t> localIds(vertexCount, NOT_IN_MESHLET);
+        std::vector<uint8_t> emitted(triangleCount, 0);
+        size_t scanCursor = 0;
+
+        Meshlet current{0, 0, 0, 0};
+
+        auto newVertexCount = [&](size_t t)
+        {
+            uint32_t a = indices[3 * t + 0];
+            uint32_t b = indices[3 * t + 1];
+            uint32_t c = indices[3 * t + 2];
+            return uint32_t(localIds[a] == NOT_IN_MESHLET) +
+                   uint32_t(localIds[b] == NOT_IN_MESHLET && b != a) +
+                   uint32_t(localIds[c] == NOT_IN_MESHLET && c != a && c != b);
+        };
+
+        auto finishMeshlet = [&]()
+        {
+            if (current.triangleCount == 0)
+                return;
+
+            for (uint32_t i = 0; i < current.vertexCount; ++i)
+            {
+                localIds[data.vertices[current.vertexOffset + i]] = NOT_IN_MESHLET;
+            }
+
+            // keep every meshlet's triangles 4-byte aligned so the GPU can read them as uints
+            while (data.triangles.size() % 4 != 0)
+            {
+                data.triangles.push_back(0);
+            }
+
+            data.meshlets.push_back(current);
+            data.bounds.push_back(computeMeshletBounds(data, current, positions, positionStride));
+            current = Meshlet{static_cast<uint32_t>(data.vertices.size()), static_cast<uint32_t>(data.triangles.size()), 0, 0};
+        };
+
+        while (true)
+        {
+            // grow the meshlet through its own vertices: take the triangle that adds the fewest new vertices,
+            // ties go to the lowest triangle index so the result never depends on anything but the input
+            size_t next = SIZE_MAX;
+            uint32_t nextCost = UINT32_MAX;
+            for (uint32_t i = 0; i < current.vertexCount; ++i)
+            {
+                uint32_t v = data.vertices[current.vertexOffset + i];
+                for (uint32_t j = offsets[v]; j < offsets[v + 1]; ++j)
+                {
+                    uint32_t t = adjacency[j];
+                    if (emitted[t])
+                        continue;
+                    uint32_t cost = newVertexCount(t);
+                    if (current.vertexCount + cost <= MESHLET_MAX_VERTICES &&
+                        (cost < nextCost || (cost == nextCost && t < next)))
+                    {
+                        next = t;
+                        nextCost = cost;
+                    }
+                }
+            }
+
+            // nothing connected fits, continue with the first unused triangle in index order,
+            // which is still spatially close after vertex cache optimization
+            if (next == SIZE_MAX)
+            {
+                while (scanCursor < triangleCount && emitted[scanCursor])
+                    ++scanCursor;
+                if (scanCursor == triangleCount)
+                    break;
+                next = scanCursor;
+
+                if (current.vertexCount + newVertexCount(next) > MESHLET_MAX_VERTICES)
+                {
+                    finishMeshlet();
+                }
+            }
+
+            emitted[next] = 1;
+            for (int k = 0; k < 3; ++k)
+            {
+                uint32_t v = indices[3 * next + k];
+                if (localIds[v] == NOT_IN_MESHLET)
+                {
+                    localIds[v] = static_cast<uint8_t>(current.vertexCount++);
+                    data.vertices.push_back(v);
+                }
+                data.triangles.push_back(localIds[v]);
+            }
+            current.triangleCount++;
+
+            if (current.triangleCount == MESHLET_MAX_TRIANGLES)
+            {
+                finishMeshlet();
+            }
+        }
+
+        finishMeshlet();
+    }
+
+    MeshletBounds computeMeshletBounds(const MeshletData &data,
+                                       const Meshlet &meshlet,
+                                       const float *positions,
+                                       size_t positionStride)
+    {
+        MeshletBounds bounds{};
+        bounds.coneCutoff = 1.0f;
+        if (meshlet.vertexCount == 0)
+            return bounds;
+
+        std::vector<glm::vec3> points(meshlet.vertexCount);
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i)
+        {
+            points[i] = loadPosition(positions, positionStride, data.vertices[meshlet.vertexOffset + i]);
+        }
+
+        // Ritter's bounding sphere: start from the widest pair of axis extremes, then grow to cover every point
+        uint32_t minPoint[3] = {0, 0, 0};
+        uint32_t maxPoint[3] = {0, 0, 0};
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (points[i][axis] < points[minPoint[axis]][axis])
+                    minPoint[axis] = i;
+                if (points[i][axis] > points[maxPoint[axis]][axis])
+                    maxPoint[axis] = i;
+            }
+        }
+
+        int widestAxis = 0;
+        float widestDistance = -1.0f;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            glm::vec3 span = points[maxPoint[axis]] - points[minPoint[axis]];
+            float distance = glm::dot(span, span);
+            if (distance > widestDistance)
+            {
+                widestDistance = distance;
+                widestAxis = axis;
+            }
+        }
+
+        glm::vec3 center = (points[minPoint[widestAxis]] + points[maxPoint[widestAxis]]) * 0.5f;
+        float radius = std::sqrt(widestDistance) * 0.5f;
+        for (const glm::vec3 &point : points)
+        {
+            float distance = glm::length(point - center);
+            if (distance > radius)
+            {
+                float grownRadius = (radius + distance) * 0.5f;
+                center += (point - center) * ((distance - grownRadius) / distance);
+                radius = grownRadius;
+            }
+        }
+        bounds.center = center;
+        bounds.radius = radius;
+
+        // normal cone around the average triangle normal (counter-clockwise front faces)
+        std::vector<glm::vec3> normals{};
+        normals.reserve(meshlet.triangleCount);
+        glm::vec3 normalSum{0.0f};
+        for (uint32_t t = 0; t < meshlet.triangleCount; ++t)
+        {
+            const uint8_t *triangle = &data.triangles[meshlet.triangleOffset + 3 * t];
+            glm::vec3 p0 = points[triangle[0]];
+            glm::vec3 normal = glm::cross(points[triangle[1]] - p0, points[triangle[2]] - p0);
+            float area = glm::length(normal);
+            if (area > 0.0f)
+            {
+                normals.push_back(normal / area);
+                normalSum += normals.back();
+            }
+        }
+
+        float axisLength = glm::length(normalSum);
+        if (normals.empty() || axisLength == 0.0f)
+            return bounds;
+
+        glm::vec3 axis = normalSum / axisLength;
+        float minDot = 1.0f;
+        for (const glm::vec3 &normal : normals)
+        {
+            minDot = std::min(minDot, glm::dot(normal, axis));
+        }
+
+        bounds.coneAxis = axis;
+        if (minDot > MIN_CONE_SPREAD)
+        {
+            // sine of the cone's half angle, see the culling condition in MeshletBounds
+            bounds.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+        }
+        return bounds;
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef __ARC_MESHLET_H__
+#define __ARC_MESHLET_H__
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace arc
+{
+    constexpr uint32_t MESHLET_MAX_VERTICES = 64;
+    constexpr uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+    // Layouts below match the std430 storage buffers read by the culling pass
+    struct Meshlet
+    {
+        uint32_t vertexOffset;   // into MeshletData::vertices
+        uint32_t triangleOffset; // into MeshletData::triangles, always a multiple of 4
+        uint32_t vertexCount;
+        uint32_t triangleCount;
+    };
+
+    // Model space bounds of one meshlet
+    // the cluster is backfacing when dot(center - camera, coneAxis) >= coneCutoff * length(center - camera) + radius
+    struct MeshletBounds
+    {
+        glm::vec3 center;
+        float radius;
+        glm::vec3 coneAxis;
+        float coneCutoff; // 1 disables cone culling
+    };
+
+    struct MeshletData
+    {
+        std::vector<Meshlet> meshlets{};
+        std::vector<MeshletBounds> bounds{};
+        // meshlet local vertex -> model vertex id
+        std::vector<uint32_t> vertices{};
+        // three meshlet local vertex ids per triangle
+        std::vector<uint8_t> triangles{};
+
+        bool empty() const { return meshlets.empty(); }
+    };
+
+    // Greedily split an index buffer into meshlets, growing each one across shared vertices
+    // the result only depends on the index buffer, so repeated builds are identical
+    // positions point at the first vertex position, positionStride is the vertex size in bytes
+    void buildMeshlets(MeshletData &data,
+                       const std::vector<uint32_t> &indices,
+                       const float *positions,
+                       size_t positionStride);
+
+    MeshletBounds computeMeshletBounds(const MeshletData &data,
+                                       const Meshlet &meshlet,
+                                       const float *positions,
+                                       size_t positionStride);
+}
+
+#endif // __ARC_MESHLET_H__
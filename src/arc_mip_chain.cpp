@@ -0,0 +1,85 @@
+#include "arc_mip_chain.hpp"
+
+// std
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace arc
+{
+    namespace
+    {
+        float srgbToLinear(uint8_t value)
+        {
+            float c = value / 255.0f;
+            return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+
+        uint8_t linearToSrgb(float c)
+        {
+            c = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+            return static_cast<uint8_t>(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+    }
+
+    uint32_t mipLevelCount(uint32_t width, uint32_t height)
+    {
+        return static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+    }
+
+    std::vector<uint8_t> buildMipChain(const uint8_t *pixels, uint32_t width, uint32_t height, uint32_t mipLevels,
+                                       bool srgb, std::vector<uint64_t> &levelOffsets, uint32_t channels)
+    {
+        // the last of 2 or 4 channels is alpha
+        uint32_t colorChannels = channels % 2 == 0 ? channels - 1 : channels;
+
+        std::array<float, 256> toLinear{};
+        for (int i = 0; i < 256; ++i)
+        {
+            toLinear[i] = srgb ? srgbToLinear(static_cast<uint8_t>(i)) : i / 255.0f;
+        }
+
+        std::vector<uint8_t> chain(pixels, pixels + static_cast<size_t>(width) * height * channels);
+        levelOffsets.assign(1, 0);
+        for (uint32_t level = 1; level < mipLevels; ++level)
+        {
+            size_t sourceOffset = levelOffsets.back();
+            uint32_t sourceWidth = std::max(width >> (level - 1), 1u);
+            uint32_t sourceHeight = std::max(height >> (level - 1), 1u);
+            uint32_t levelWidth = std::max(width >> level, 1u);
+            uint32_t levelHeight = std::max(height >> level, 1u);
+
+            levelOffsets.push_back(chain.size());
+            chain.resize(chain.size() + static_cast<size_t>(levelWidth) * levelHeight * channels);
+            const uint8_t *source = chain.data() + sourceOffset;
+            uint8_t *target = chain.data() + levelOffsets.back();
+
+            for (uint32_t y = 0; y < levelHeight; ++y)
+            {
+                for (uint32_t x = 0; x < levelWidth; ++x)
+                {
+                    // a side of 1 texel reads the same texel twice
+                    uint32_t x0 = std::min(2 * x, sourceWidth - 1), x1 = std::min(2 * x + 1, sourceWidth - 1);
+                    uint32_t y0 = std::min(2 * y, sourceHeight - 1), y1 = std::min(2 * y + 1, sourceHeight - 1);
+                    const uint8_t *texels[4] = {source + (static_cast<size_t>(y0) * sourceWidth + x0) * channels,
+                                                source + (static_cast<size_t>(y0) * sourceWidth + x1) * channels,
+                                                source + (static_cast<size_t>(y1) * sourceWidth + x0) * channels,
+                                                source + (static_cast<size_t>(y1) * sourceWidth + x1) * channels};
+
+                    uint8_t *texel = target + (static_cast<size_t>(y) * levelWidth + x) * channels;
+                    for (uint32_t c = 0; c < colorChannels; ++c)
+                    {
+                        float sum = toLinear[texels[0][c]] + toLinear[texels[1][c]] + toLinear[texels[2][c]] + toLinear[texels[3][c]];
+                        texel[c] = srgb ? linearToSrgb(sum * 0.25f)
+                                        : static_cast<uint8_t>((texels[0][c] + texels[1][c] + texels[2][c] + texels[3][c] + 2) / 4);
+                    }
+                    for (uint32_t c = colorChannels; c < channels; ++c)
+                    {
+                        texel[c] = static_cast<uint8_t>((texels[0][c] + texels[1][c] + texels[2][c] + texels[3][c] + 2) / 4);
+                    }
+                }
+            }
+        }
+        return chain;
+    }
+}
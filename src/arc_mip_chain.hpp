@@ -0,0 +1,20 @@
+#ifndef __ARC_MIP_CHAIN_H__
+#define __ARC_MIP_CHAIN_H__
+
+// std
+#include <cstdint>
+#include <vector>
+
+namespace arc
+{
+    // levels of a full chain down to 1x1
+    uint32_t mipLevelCount(uint32_t width, uint32_t height);
+
+    // Box filtered 8 bit mip chain starting with a copy of pixels, level i starts at levelOffsets[i]
+    // srgb averages color in linear space like a linear filtered blit of an sRGB image, alpha is averaged as it is
+    // channels is 1 (gray), 2 (gray, alpha), 3 (RGB) or 4 (RGBA)
+    std::vector<uint8_t> buildMipChain(const uint8_t *pixels, uint32_t width, uint32_t height, uint32_t mipLevels,
+                                       bool srgb, std::vector<uint64_t> &levelOffsets, uint32_t channels = 4);
+}
+
+#endif // __ARC_MIP_CHAIN_H__
@@ -1,23 +1,41 @@
 #include "arc_model.hpp"
+#include "arc_gltf.hpp"
+#include "arc_mapped_file.hpp"
+#include "arc_mesh_optimizer.hpp"
+#include "arc_mesh_simplifier.hpp"
+#include "arc_obj_stream.hpp"
+#include "arc_upload_batch.hpp"
 #include "arc_utils.hpp"
+#include "arc_vertex_quantization.hpp"
+#include "arc_weld_table.hpp"
 
 // libs
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tiny_obj_loader.h>
 
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/hash.hpp>
-
 // std
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
 #include <cstring>
-#include <unordered_map>
+#include <fstream>
+#include <map>
+#include <thread>
+#include <type_traits>
 
 #ifndef ENGINE_DIR
 #define ENGINE_DIR "../"
 #endif
 
+#ifdef ARC_BENCHMARKS
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
+
+#include <unordered_map>
+
+// node based map welding, kept as the baseline for the weld table benchmark
 namespace std
 {
     template <>
@@ -31,9 +49,790 @@ namespace std
         }
     };
 }
+#endif
 
 namespace arc
 {
+    namespace
+    {
+        // Binary mesh cache written next to the source model
+        // layout: MeshCacheHeader | vertices | indices | MeshCacheLod per lod | lod indices |
+        //         submeshes of level 0 and every lod | MeshCacheMaterial, name, texture per material
+        constexpr const char *MESH_CACHE_EXTENSION = ".arcmesh";
+        constexpr uint32_t MESH_CACHE_MAGIC = 0x48534d41; // "AMSH"
+        constexpr uint32_t MESH_CACHE_VERSION = 4;
+
+        // Builder options that change the cached buffers
+        constexpr uint32_t MESH_BUILD_OPTIMIZED = 1 << 0;
+        constexpr uint32_t MESH_BUILD_STREAMED = 1 << 1;
+
+        // a level keeping more than this fraction of the previous level's triangles isn't worth its memory
+        constexpr float MIN_LOD_REDUCTION = 0.9f;
+
+        // the source hash walks big files in blocks and lets go of each block afterwards
+        constexpr size_t SOURCE_HASH_BLOCK = 4 * 1024 * 1024;
+
+        // below this many corners per thread, spawning workers costs more than it saves
+        constexpr size_t MIN_CORNERS_PER_SHARD = 1 << 16;
+
+        struct MeshCacheHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t sourceHash;
+            uint64_t vertexLayout;
+            uint32_t vertexStride;
+            uint32_t indexStride;
+            uint32_t buildOptions;
+            uint32_t lodCount;
+            uint64_t vertexCount;
+            uint64_t indexCount;
+            uint64_t lodSettingsHash;
+            uint32_t submeshCount;
+            uint32_t materialCount;
+        };
+
+        struct MeshCacheLod
+        {
+            uint32_t indexCount;
+            float error;
+            uint32_t submeshCount;
+        };
+
+        struct MeshCacheMaterial
+        {
+            float diffuse[3];
+            uint32_t nameLength;
+            uint32_t textureLength;
+        };
+
+        // any change to the vertex attributes invalidates existing caches
+        uint64_t vertexLayoutHash()
+        {
+            auto attributes = ArcModel::Vertex::getAttributeDescriptions();
+            return hashBytes(attributes.data(), attributes.size() * sizeof(attributes[0]), sizeof(ArcModel::Vertex));
+        }
+
+        uint32_t meshBuildOptions(const ArcModel::Builder &builder)
+        {
+            return (builder.optimizeMesh ? MESH_BUILD_OPTIMIZED : 0) |
+                   (builder.streamObj ? MESH_BUILD_STREAMED : 0);
+        }
+
+        uint64_t lodSettingsHash(const ArcModel::Builder &builder)
+        {
+            return hashBytes(builder.lodSettings.data(), builder.lodSettings.size() * sizeof(ArcModel::LodSettings));
+        }
+
+        uint64_t hashSource(ArcMappedFile &source)
+        {
+            uint64_t hash = 0;
+            for (size_t offset = 0; offset < source.size(); offset += SOURCE_HASH_BLOCK)
+            {
+                size_t size = std::min(SOURCE_HASH_BLOCK, source.size() - offset);
+                hash = hashBytes(source.data() + offset, size, hash);
+                source.discard(offset, size);
+            }
+            return hash;
+        }
+
+        bool isGlb(const std::string &filepath)
+        {
+            return filepath.size() >= 4 && filepath.compare(filepath.size() - 4, 4, ".glb") == 0;
+        }
+
+        double elapsedMilliseconds(std::chrono::high_resolution_clock::time_point startTime)
+        {
+            auto endTime = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double, std::milli>(endTime - startTime).count();
+        }
+
+        bool readMeshCache(ArcModel::Builder &builder, const std::string &cachePath, uint64_t sourceHash)
+        {
+            ArcMappedFile cache{cachePath};
+            if (!cache.isOpen() || cache.size() < sizeof(MeshCacheHeader))
+                return false;
+
+            MeshCacheHeader header{};
+            std::memcpy(&header, cache.data(), sizeof(header));
+
+            // stale or foreign caches fall back to the OBJ path
+            if (header.magic != MESH_CACHE_MAGIC ||
+                header.version != MESH_CACHE_VERSION ||
+                header.sourceHash != sourceHash ||
+                header.vertexLayout != vertexLayoutHash() ||
+                header.vertexStride != sizeof(ArcModel::Vertex) ||
+                header.indexStride != sizeof(uint32_t) ||
+                header.buildOptions != meshBuildOptions(builder) ||
+                header.lodSettingsHash != lodSettingsHash(builder))
+            {
+                return false;
+            }
+
+            // every count is checked against the bytes left before anything is allocated for it,
+            // a truncated or damaged cache reads as a miss
+            const uint8_t *cursor = cache.data() + sizeof(MeshCacheHeader);
+            const uint8_t *end = cache.data() + cache.size();
+            auto fits = [&](uint64_t count, size_t elementSize)
+            {
+                return count <= static_cast<uint64_t>(end - cursor) / elementSize;
+            };
+            auto take = [&](auto &target, uint64_t count)
+            {
+                using Element = typename std::decay_t<decltype(target)>::value_type;
+                if (!fits(count, sizeof(Element)))
+                    return false;
+                target.resize(count);
+                if (count > 0)
+                {
+                    std::memcpy(&target[0], cursor, count * sizeof(Element));
+                }
+                cursor += count * sizeof(Element);
+                return true;
+            };
+
+            ArcModel::Builder cached{};
+            std::vector<MeshCacheLod> lodHeaders{};
+            if (!take(cached.vertices, header.vertexCount) ||
+                !take(cached.indices, header.indexCount) ||
+                !take(lodHeaders, header.lodCount))
+            {
+                return false;
+            }
+
+            cached.lods.resize(lodHeaders.size());
+            for (size_t i = 0; i < lodHeaders.size(); ++i)
+            {
+                cached.lods[i].error = lodHeaders[i].error;
+                if (!take(cached.lods[i].indices, lodHeaders[i].indexCount))
+                    return false;
+            }
+
+            if (!take(cached.submeshes, header.submeshCount))
+                return false;
+            for (size_t i = 0; i < lodHeaders.size(); ++i)
+            {
+                if (!take(cached.lods[i].submeshes, lodHeaders[i].submeshCount))
+                    return false;
+            }
+
+            // each material takes at least its fixed size entry
+            if (!fits(header.materialCount, sizeof(MeshCacheMaterial)))
+                return false;
+            cached.materials.resize(header.materialCount);
+            for (auto &material : cached.materials)
+            {
+                MeshCacheMaterial entry{};
+                if (!fits(1, sizeof(entry)))
+                    return false;
+                std::memcpy(&entry, cursor, sizeof(entry));
+                cursor += sizeof(entry);
+                material.diffuse = glm::vec3{entry.diffuse[0], entry.diffuse[1], entry.diffuse[2]};
+                if (!take(material.name, entry.nameLength) || !take(material.diffuseTexture, entry.textureLength))
+                    return false;
+            }
+            if (cursor != end)
+                return false;
+
+            builder.vertices = std::move(cached.vertices);
+            builder.indices = std::move(cached.indices);
+            builder.lods = std::move(cached.lods);
+            builder.submeshes = std::move(cached.submeshes);
+            builder.materials = std::move(cached.materials);
+            return true;
+        }
+
+        void writeMeshCache(const ArcModel::Builder &builder, const std::string &cachePath, uint64_t sourceHash)
+        {
+            MeshCacheHeader header{};
+            header.magic = MESH_CACHE_MAGIC;
+            header.version = MESH_CACHE_VERSION;
+            header.sourceHash = sourceHash;
+            header.vertexLayout = vertexLayoutHash();
+            header.vertexStride = sizeof(ArcModel::Vertex);
+            header.indexStride = sizeof(uint32_t);
+            header.buildOptions = meshBuildOptions(builder);
+            header.lodCount = static_cast<uint32_t>(builder.lods.size());
+            header.vertexCount = builder.vertices.size();
+            header.indexCount = builder.indices.size();
+            header.lodSettingsHash = lodSettingsHash(builder);
+            header.submeshCount = static_cast<uint32_t>(builder.submeshes.size());
+            header.materialCount = static_cast<uint32_t>(builder.materials.size());
+
+            std::vector<MeshCacheLod> lodHeaders{};
+            for (const auto &lod : builder.lods)
+            {
+                lodHeaders.push_back({static_cast<uint32_t>(lod.indices.size()), lod.error, static_cast<uint32_t>(lod.submeshes.size())});
+            }
+
+            // write to a temporary file first so a crash never leaves a torn cache behind
+            std::string tempPath = cachePath + ".tmp";
+            {
+                std::ofstream file{tempPath, std::ios::binary | std::ios::trunc};
+                if (!file.is_open())
+                {
+                    std::cout << "Failed to write mesh cache " << cachePath << '\n';
+                    return;
+                }
+                file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+                file.write(reinterpret_cast<const char *>(builder.vertices.data()), builder.vertices.size() * sizeof(ArcModel::Vertex));
+                file.write(reinterpret_cast<const char *>(builder.indices.data()), builder.indices.size() * sizeof(uint32_t));
+                file.write(reinterpret_cast<const char *>(lodHeaders.data()), lodHeaders.size() * sizeof(MeshCacheLod));
+                for (const auto &lod : builder.lods)
+                {
+                    file.write(reinterpret_cast<const char *>(lod.indices.data()), lod.indices.size() * sizeof(uint32_t));
+                }
+                file.write(reinterpret_cast<const char *>(builder.submeshes.data()), builder.submeshes.size() * sizeof(ArcModel::Submesh));
+                for (const auto &lod : builder.lods)
+                {
+                    file.write(reinterpret_cast<const char *>(lod.submeshes.data()), lod.submeshes.size() * sizeof(ArcModel::Submesh));
+                }
+                for (const auto &material : builder.materials)
+                {
+                    MeshCacheMaterial entry{{material.diffuse.x, material.diffuse.y, material.diffuse.z},
+                                            static_cast<uint32_t>(material.name.size()),
+                                            static_cast<uint32_t>(material.diffuseTexture.size())};
+                    file.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+                    file.write(material.name.data(), material.name.size());
+                    file.write(material.diffuseTexture.data(), material.diffuseTexture.size());
+                }
+                if (!file.good())
+                {
+                    file.close();
+                    std::remove(tempPath.c_str());
+                    std::cout << "Failed to write mesh cache " << cachePath << '\n';
+                    return;
+                }
+            }
+
+            std::remove(cachePath.c_str());
+            if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0)
+            {
+                std::remove(tempPath.c_str());
+            }
+        }
+
+        ArcModel::Vertex makeVertex(const tinyobj::attrib_t &attrib, const tinyobj::index_t &idx)
+        {
+            ArcModel::Vertex vertex{};
+            if (idx.vertex_index >= 0)
+            {
+                vertex.position.x = attrib.vertices[3 * size_t(idx.vertex_index) + 0];
+                vertex.position.y = attrib.vertices[3 * size_t(idx.vertex_index) + 1];
+                vertex.position.z = attrib.vertices[3 * size_t(idx.vertex_index) + 2];
+
+                vertex.color.x = attrib.colors[3 * size_t(idx.vertex_index) + 0];
+                vertex.color.y = attrib.colors[3 * size_t(idx.vertex_index) + 1];
+                vertex.color.z = attrib.colors[3 * size_t(idx.vertex_index) + 2];
+            }
+
+            // Check if normal index
+            if (idx.normal_index >= 0)
+            {
+                vertex.normal.x = attrib.normals[3 * size_t(idx.normal_index) + 0];
+                vertex.normal.y = attrib.normals[3 * size_t(idx.normal_index) + 1];
+                vertex.normal.z = attrib.normals[3 * size_t(idx.normal_index) + 2];
+            }
+
+            if (idx.texcoord_index >= 0)
+            {
+                vertex.uv.x = attrib.texcoords[2 * size_t(idx.texcoord_index) + 0];
+                vertex.uv.y = 1.0f - attrib.texcoords[2 * size_t(idx.texcoord_index) + 1];
+            }
+            return vertex;
+        }
+
+        ArcModel::Material makeMaterial(const tinyobj::material_t &source)
+        {
+            ArcModel::Material material{};
+            material.name = source.name;
+            material.diffuse = glm::vec3{source.diffuse[0], source.diffuse[1], source.diffuse[2]};
+            material.diffuseTexture = source.diffuse_texname;
+            return material;
+        }
+
+        // Corners of all shapes seen as one flat range [0, cornerCount)
+        struct CornerRange
+        {
+            const std::vector<tinyobj::shape_t> &shapes;
+            std::vector<size_t> shapeOffsets{};
+            size_t cornerCount = 0;
+
+            CornerRange(const std::vector<tinyobj::shape_t> &shapes) : shapes{shapes}
+            {
+                shapeOffsets.reserve(shapes.size());
+                for (auto &shape : shapes)
+                {
+                    shapeOffsets.push_back(cornerCount);
+                    cornerCount += shape.mesh.indices.size();
+                }
+            }
+
+            template <typename Fn>
+            void forEach(size_t begin, size_t end, Fn &&fn) const
+            {
+                // find the shape containing the first corner of this range
+                size_t s = std::upper_bound(shapeOffsets.begin(), shapeOffsets.end(), begin) - shapeOffsets.begin() - 1;
+                size_t corner = begin;
+                for (; s < shapes.size() && corner < end; ++s)
+                {
+                    const auto &shapeIndices = shapes[s].mesh.indices;
+                    size_t shapeEnd = std::min(end, shapeOffsets[s] + shapeIndices.size());
+                    for (; corner < shapeEnd; ++corner)
+                    {
+                        fn(corner, shapeIndices[corner - shapeOffsets[s]]);
+                    }
+                }
+            }
+        };
+
+        // Each shard welds a contiguous run of corners on its own thread.
+        // Shards are merged in order, so a vertex keeps the id of its first use
+        // in corner order, exactly like a single threaded walk over all faces.
+        void weldCorners(const tinyobj::attrib_t &attrib,
+                         const CornerRange &corners,
+                         uint32_t threadCount,
+                         std::vector<ArcModel::Vertex> &vertices,
+                         std::vector<uint32_t> &indices)
+        {
+            vertices.clear();
+            indices.resize(corners.cornerCount);
+
+            size_t shardCount = std::max<size_t>(1, std::min<size_t>(threadCount, corners.cornerCount / MIN_CORNERS_PER_SHARD));
+            size_t shardSize = (corners.cornerCount + shardCount - 1) / shardCount;
+
+            struct Shard
+            {
+                size_t begin = 0;
+                size_t end = 0;
+                std::vector<ArcModel::Vertex> vertices{};
+                std::vector<uint32_t> remap{};
+            };
+            std::vector<Shard> shards(shardCount);
+
+            auto weldShard = [&](Shard &shard)
+            {
+                // a closed triangle mesh has about half as many vertices as faces,
+                // seams push that up, so size the table for one vertex per face
+                ArcWeldTable weldTable{shard.vertices, (shard.end - shard.begin) / 3};
+                corners.forEach(shard.begin, shard.end, [&](size_t corner, const tinyobj::index_t &idx)
+                                { indices[corner] = weldTable.weld(makeVertex(attrib, idx)); });
+            };
+
+            for (size_t i = 0; i < shardCount; ++i)
+            {
+                shards[i].begin = std::min(i * shardSize, corners.cornerCount);
+                shards[i].end = std::min(shards[i].begin + shardSize, corners.cornerCount);
+            }
+
+            if (shardCount == 1)
+            {
+                weldShard(shards[0]);
+                vertices = std::move(shards[0].vertices);
+                return;
+            }
+
+            {
+                std::vector<std::thread> workers{};
+                workers.reserve(shardCount - 1);
+                for (size_t i = 1; i < shardCount; ++i)
+                {
+                    workers.emplace_back(weldShard, std::ref(shards[i]));
+                }
+                weldShard(shards[0]);
+                for (auto &worker : workers)
+                {
+                    worker.join();
+                }
+            }
+
+            // merge the shard-local vertices into the global vertex list in shard order
+            size_t shardVertexCount = 0;
+            for (auto &shard : shards)
+            {
+                shardVertexCount += shard.vertices.size();
+            }
+            ArcWeldTable weldTable{vertices, shardVertexCount};
+            for (auto &shard : shards)
+            {
+                shard.remap.resize(shard.vertices.size());
+                for (size_t v = 0; v < shard.vertices.size(); ++v)
+                {
+                    shard.remap[v] = weldTable.weld(shard.vertices[v]);
+                }
+                shard.vertices.clear();
+                shard.vertices.shrink_to_fit();
+            }
+
+            // rewrite the shard-local indices to global ones
+            auto remapShard = [&](const Shard &shard)
+            {
+                for (size_t corner = shard.begin; corner < shard.end; ++corner)
+                {
+                    indices[corner] = shard.remap[indices[corner]];
+                }
+            };
+
+            std::vector<std::thread> workers{};
+            workers.reserve(shardCount - 1);
+            for (size_t i = 1; i < shardCount; ++i)
+            {
+                workers.emplace_back(remapShard, std::cref(shards[i]));
+            }
+            remapShard(shards[0]);
+            for (auto &worker : workers)
+            {
+                worker.join();
+            }
+        }
+
+#ifdef ARC_BENCHMARKS
+        // the original single threaded weld: count() then operator[] on a std::unordered_map
+        void weldCornersWithMap(const tinyobj::attrib_t &attrib,
+                                const CornerRange &corners,
+                                std::vector<ArcModel::Vertex> &vertices,
+                                std::vector<uint32_t> &indices)
+        {
+            std::unordered_map<ArcModel::Vertex, uint32_t> uniqueVertices{};
+            vertices.clear();
+            indices.clear();
+            corners.forEach(0, corners.cornerCount, [&](size_t, const tinyobj::index_t &idx)
+                            {
+                                ArcModel::Vertex vertex = makeVertex(attrib, idx);
+                                if (uniqueVertices.count(vertex) == 0)
+                                {
+                                    uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+                                    vertices.push_back(vertex);
+                                }
+                                indices.push_back(uniqueVertices[vertex]);
+                            });
+        }
+#endif
+
+        // Turns the parser's material runs, in file order, into one submesh per material.
+        // Triangles only move when a material is split over several runs, faces without a valid
+        // material share a default one.
+        void groupSubmeshes(ArcModel::Builder &builder)
+        {
+            uint32_t materialCount = static_cast<uint32_t>(builder.materials.size());
+            if (builder.submeshes.empty())
+            {
+                builder.submeshes.push_back({0, static_cast<uint32_t>(builder.indices.size()), UINT32_MAX});
+            }
+
+            // merge neighbouring runs of the same material and note where each material shows up first
+            std::vector<ArcModel::Submesh> runs{};
+            std::vector<uint32_t> firstRun(materialCount + 1, UINT32_MAX);
+            bool split = false;
+            for (auto run : builder.submeshes)
+            {
+                if (run.indexCount == 0)
+                    continue;
+                run.material = std::min(run.material, materialCount);
+                if (!runs.empty() && runs.back().material == run.material &&
+                    runs.back().firstIndex + runs.back().indexCount == run.firstIndex)
+                {
+                    runs.back().indexCount += run.indexCount;
+                    continue;
+                }
+                split = split || firstRun[run.material] != UINT32_MAX;
+                if (firstRun[run.material] == UINT32_MAX)
+                    firstRun[run.material] = static_cast<uint32_t>(runs.size());
+                runs.push_back(run);
+            }
+
+            if (firstRun[materialCount] != UINT32_MAX)
+            {
+                builder.materials.push_back(ArcModel::Material{});
+            }
+
+            builder.submeshes.clear();
+            if (!split)
+            {
+                builder.submeshes = std::move(runs);
+                return;
+            }
+
+            // copy the runs of each material together, materials in order of first use
+            std::vector<uint32_t> materialOrder{};
+            for (const auto &run : runs)
+            {
+                if (firstRun[run.material] != UINT32_MAX)
+                {
+                    materialOrder.push_back(run.material);
+                    firstRun[run.material] = UINT32_MAX;
+                }
+            }
+
+            std::vector<uint32_t> grouped{};
+            grouped.reserve(builder.indices.size());
+            for (uint32_t material : materialOrder)
+            {
+                ArcModel::Submesh submesh{static_cast<uint32_t>(grouped.size()), 0, material};
+                for (const auto &run : runs)
+                {
+                    if (run.material != material)
+                        continue;
+                    grouped.insert(grouped.end(), builder.indices.begin() + run.firstIndex,
+                                   builder.indices.begin() + run.firstIndex + run.indexCount);
+                }
+                submesh.indexCount = static_cast<uint32_t>(grouped.size()) - submesh.firstIndex;
+                builder.submeshes.push_back(submesh);
+            }
+            builder.indices = std::move(grouped);
+        }
+
+        // texture paths come relative to the model file, renderers load them relative to ENGINE_DIR
+        void resolveTexturePaths(ArcModel::Builder &builder, const std::string &filepath)
+        {
+            size_t slash = filepath.find_last_of("/\\");
+            std::string directory = slash == std::string::npos ? std::string{} : filepath.substr(0, slash + 1);
+            for (auto &material : builder.materials)
+            {
+                if (!material.diffuseTexture.empty())
+                {
+                    material.diffuseTexture = directory + material.diffuseTexture;
+                }
+            }
+        }
+
+        // vertex cache order within each submesh, triangles never cross into another material's range
+        void optimizeSubmeshes(std::vector<uint32_t> &indices, const std::vector<ArcModel::Submesh> &submeshes, size_t vertexCount)
+        {
+            if (submeshes.size() <= 1)
+            {
+                optimizeVertexCache(indices, vertexCount);
+                return;
+            }
+
+            std::vector<uint32_t> range{};
+            for (const auto &submesh : submeshes)
+            {
+                auto first = indices.begin() + submesh.firstIndex;
+                range.assign(first, first + submesh.indexCount);
+                optimizeVertexCache(range, vertexCount);
+                std::copy(range.begin(), range.end(), first);
+            }
+        }
+
+        uint32_t resolveThreadCount(uint32_t requested)
+        {
+            if (requested > 0)
+                return requested;
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        // reorder triangles for the post-transform cache, then vertices for fetch locality
+        void optimizeMeshLayout(ArcModel::Builder &builder, const std::string &filepath)
+        {
+            VertexCacheStats before = analyzeVertexCache(builder.indices, builder.vertices.size());
+
+            auto optimizeStart = std::chrono::high_resolution_clock::now();
+            optimizeSubmeshes(builder.indices, builder.submeshes, builder.vertices.size());
+            optimizeVertexFetch(builder.vertices, builder.indices);
+            double optimizeMs = elapsedMilliseconds(optimizeStart);
+
+            VertexCacheStats after = analyzeVertexCache(builder.indices, builder.vertices.size());
+            std::cout << "Optimized " << filepath << " in " << optimizeMs << " ms: ACMR "
+                      << before.acmr << " -> " << after.acmr << ", ATVR "
+                      << before.atvr << " -> " << after.atvr << '\n';
+        }
+
+        // simplify the full detail mesh once per lod setting, all levels reference the same vertices
+        // each submesh is simplified on its own, edges between materials are open borders there and stay put
+        void generateLods(ArcModel::Builder &builder, const std::string &filepath)
+        {
+            builder.lods.clear();
+            if (builder.indices.empty() || builder.lodSettings.empty())
+                return;
+
+            auto lodStart = std::chrono::high_resolution_clock::now();
+            size_t previousIndexCount = builder.indices.size();
+            std::vector<uint32_t> range{};
+            for (const auto &settings : builder.lodSettings)
+            {
+                ArcModel::Lod lod{};
+                for (const auto &submesh : builder.submeshes)
+                {
+                    const std::vector<uint32_t> *source = &builder.indices;
+                    if (builder.submeshes.size() > 1)
+                    {
+                        range.assign(builder.indices.begin() + submesh.firstIndex,
+                                     builder.indices.begin() + submesh.firstIndex + submesh.indexCount);
+                        source = &range;
+                    }
+
+                    size_t targetIndexCount = static_cast<size_t>(submesh.indexCount / 3 * settings.triangleRatio) * 3;
+                    float error = 0.0f;
+                    std::vector<uint32_t> simplified = simplifyMesh(*source, &builder.vertices[0].position.x, sizeof(ArcModel::Vertex),
+                                                                    builder.vertices.size(), targetIndexCount, settings.maxError, &error);
+                    if (simplified.empty())
+                        continue;
+
+                    lod.error = std::max(lod.error, error);
+                    lod.submeshes.push_back({static_cast<uint32_t>(lod.indices.size()), static_cast<uint32_t>(simplified.size()), submesh.material});
+                    lod.indices.insert(lod.indices.end(), simplified.begin(), simplified.end());
+                }
+                if (lod.indices.empty() || lod.indices.size() > previousIndexCount * MIN_LOD_REDUCTION)
+                    continue;
+
+                optimizeSubmeshes(lod.indices, lod.submeshes, builder.vertices.size());
+                previousIndexCount = lod.indices.size();
+                builder.lods.push_back(std::move(lod));
+            }
+
+            std::cout << "Generated " << builder.lods.size() << " lods for " << filepath << " in "
+                      << elapsedMilliseconds(lodStart) << " ms, triangles " << builder.indices.size() / 3;
+            for (const auto &lod : builder.lods)
+            {
+                std::cout << " -> " << lod.indices.size() / 3 << " (error " << lod.error << ")";
+            }
+            std::cout << '\n';
+        }
+
+        void parseObj(ArcModel::Builder &builder, const std::string &enginePath)
+        {
+            tinyobj::ObjReaderConfig readerConfig;
+            tinyobj::ObjReader reader;
+            readerConfig.mtl_search_path = "";
+
+            if (!reader.ParseFromFile(enginePath, readerConfig))
+            {
+                if (!reader.Error().empty())
+                {
+                    throw std::runtime_error(reader.Error());
+                }
+            }
+
+            if (!reader.Warning().empty())
+            {
+                std::cout << "TinyObjReader: " << reader.Warning() << '\n';
+            }
+
+            auto &attrib = reader.GetAttrib();
+            auto &shapes = reader.GetShapes();
+
+            CornerRange corners{shapes};
+            uint32_t threadCount = resolveThreadCount(builder.workerThreads);
+            weldCorners(attrib, corners, threadCount, builder.vertices, builder.indices);
+
+            // faces are triangulated, so face f of a shape starts at corner 3 * f
+            builder.materials.clear();
+            for (const auto &material : reader.GetMaterials())
+            {
+                builder.materials.push_back(makeMaterial(material));
+            }
+            builder.submeshes.clear();
+            for (size_t s = 0; s < shapes.size(); ++s)
+            {
+                const auto &materialIds = shapes[s].mesh.material_ids;
+                for (size_t f = 0; f < materialIds.size(); ++f)
+                {
+                    uint32_t material = materialIds[f] < 0 ? UINT32_MAX : static_cast<uint32_t>(materialIds[f]);
+                    if (builder.submeshes.empty() || builder.submeshes.back().material != material)
+                    {
+                        builder.submeshes.push_back({static_cast<uint32_t>(corners.shapeOffsets[s] + 3 * f), 0, material});
+                    }
+                    builder.submeshes.back().indexCount += 3;
+                }
+            }
+
+#ifdef ARC_BENCHMARKS
+            // weld table against the node based map, both on a single thread
+            {
+                std::vector<ArcModel::Vertex> mapVertices{};
+                std::vector<uint32_t> mapIndices{};
+                auto mapStart = std::chrono::high_resolution_clock::now();
+                weldCornersWithMap(attrib, corners, mapVertices, mapIndices);
+                double mapMs = elapsedMilliseconds(mapStart);
+
+                std::vector<ArcModel::Vertex> tableVertices{};
+                std::vector<uint32_t> tableIndices{};
+                auto tableStart = std::chrono::high_resolution_clock::now();
+                weldCorners(attrib, corners, 1, tableVertices, tableIndices);
+                double tableMs = elapsedMilliseconds(tableStart);
+
+                bool matches = mapVertices == tableVertices && mapIndices == tableIndices;
+                std::cout << "[benchmark] weld " << corners.cornerCount << " corners: unordered_map " << mapMs
+                          << " ms, weld table " << tableMs << " ms" << (matches ? "" : " (MISMATCH)") << '\n';
+            }
+
+            // welding scalability: 1, 2, 4, ... threads, checked against the single threaded result
+            {
+                std::vector<ArcModel::Vertex> referenceVertices{};
+                std::vector<uint32_t> referenceIndices{};
+                uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+                for (uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+                {
+                    std::vector<ArcModel::Vertex> benchVertices{};
+                    std::vector<uint32_t> benchIndices{};
+                    auto weldStart = std::chrono::high_resolution_clock::now();
+                    weldCorners(attrib, corners, threads, benchVertices, benchIndices);
+                    double weldMs = elapsedMilliseconds(weldStart);
+
+                    if (threads == 1)
+                    {
+                        referenceVertices = std::move(benchVertices);
+                        referenceIndices = std::move(benchIndices);
+                    }
+                    bool matches = threads == 1 ||
+                                   (benchVertices == referenceVertices && benchIndices == referenceIndices);
+                    std::cout << "[benchmark] weld " << corners.cornerCount << " corners on " << threads
+                              << " thread(s): " << weldMs << " ms" << (matches ? "" : " (MISMATCH)") << '\n';
+                }
+            }
+#endif
+        }
+
+        void streamObjFile(ArcModel::Builder &builder, const std::string &enginePath)
+        {
+            ArcObjStream stream{enginePath};
+            if (!stream.isOpen())
+            {
+                throw std::runtime_error("failed to open model file: " + enginePath);
+            }
+
+            // the chunks land in the builder's buffers, which are the only full copy of the mesh
+            builder.vertices.clear();
+            builder.indices.clear();
+            stream.read([&](const ArcObjStream::Chunk &chunk)
+                        {
+                            builder.vertices.insert(builder.vertices.end(), chunk.vertices, chunk.vertices + chunk.vertexCount);
+                            builder.indices.insert(builder.indices.end(), chunk.indices, chunk.indices + chunk.indexCount); });
+            builder.vertices.shrink_to_fit();
+            builder.indices.shrink_to_fit();
+
+            // material parameters come from the libraries, names the libraries don't define keep the defaults
+            std::map<std::string, int> materialMap{};
+            std::vector<tinyobj::material_t> libraryMaterials{};
+            size_t slash = enginePath.find_last_of("/\\");
+            std::string directory = slash == std::string::npos ? std::string{} : enginePath.substr(0, slash + 1);
+            for (const auto &library : stream.getMaterialLibraries())
+            {
+                std::ifstream file{directory + library};
+                if (!file.is_open())
+                {
+                    std::cout << "Material library " << library << " not found for " << enginePath << '\n';
+                    continue;
+                }
+                std::string warning{};
+                std::string error{};
+                tinyobj::LoadMtl(&materialMap, &libraryMaterials, &file, &warning, &error);
+            }
+
+            builder.materials.clear();
+            for (const auto &name : stream.getMaterialNames())
+            {
+                auto found = materialMap.find(name);
+                ArcModel::Material material = found == materialMap.end() ? ArcModel::Material{}
+                                                                         : makeMaterial(libraryMaterials[found->second]);
+                material.name = name;
+                builder.materials.push_back(std::move(material));
+            }
+            builder.submeshes = stream.getMaterialRuns();
+        }
+    }
+
     std::vector<VkVertexInputBindingDescription> ArcModel::Vertex::getBindingDescriptions()
     {
         std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
@@ -55,196 +854,455 @@ namespace arc
         return attributeDescriptions;
     }
 
-    ArcModel::ArcModel(ArcDevice &device, const ArcModel::Builder &builder)
-        : arcDevice{device}
+    std::vector<VkVertexInputBindingDescription> ArcModel::PackedVertex::getBindingDescriptions()
+    {
+        std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
+        bindingDescriptions[0].binding = 0;
+        bindingDescriptions[0].stride = sizeof(PackedVertex);
+        bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        return bindingDescriptions;
+    }
+
+    std::vector<VkVertexInputAttributeDescription> ArcModel::PackedVertex::getAttributeDescriptions()
+    {
+        std::vector<VkVertexInputAttributeDescription> attributeDescriptions{};
+
+        attributeDescriptions.push_back({0, 0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(PackedVertex, PackedVertex::position)});
+        attributeDescriptions.push_back({1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(PackedVertex, PackedVertex::color)});
+        attributeDescriptions.push_back({2, 0, VK_FORMAT_R16G16_SNORM, offsetof(PackedVertex, PackedVertex::normal)});
+        attributeDescriptions.push_back({3, 0, VK_FORMAT_R16G16_SFLOAT, offsetof(PackedVertex, PackedVertex::uv)});
+
+        return attributeDescriptions;
+    }
+
+    std::vector<VkVertexInputBindingDescription> ArcModel::PositionVertex::getBindingDescriptions()
+    {
+        std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
+        bindingDescriptions[0].binding = 0;
+        bindingDescriptions[0].stride = sizeof(PositionVertex);
+        bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        return bindingDescriptions;
+    }
+
+    std::vector<VkVertexInputAttributeDescription> ArcModel::PositionVertex::getAttributeDescriptions()
+    {
+        std::vector<VkVertexInputAttributeDescription> attributeDescriptions{};
+
+        attributeDescriptions.push_back({0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(PositionVertex, PositionVertex::position)});
+        attributeDescriptions.push_back({1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(PositionVertex, PositionVertex::normal)});
+
+        return attributeDescriptions;
+    }
+
+    std::vector<VkVertexInputBindingDescription> ArcModel::PackedPositionVertex::getBindingDescriptions()
+    {
+        std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
+        bindingDescriptions[0].binding = 0;
+        bindingDescriptions[0].stride = sizeof(PackedPositionVertex);
+        bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        return bindingDescriptions;
+    }
+
+    std::vector<VkVertexInputAttributeDescription> ArcModel::PackedPositionVertex::getAttributeDescriptions()
+    {
+        std::vector<VkVertexInputAttributeDescription> attributeDescriptions{};
+
+        attributeDescriptions.push_back({0, 0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(PackedPositionVertex, PackedPositionVertex::position)});
+        attributeDescriptions.push_back({1, 0, VK_FORMAT_R16G16_SNORM, offsetof(PackedPositionVertex, PackedPositionVertex::normal)});
+
+        return attributeDescriptions;
+    }
+
+    ArcModel::ArcModel(ArcDevice &device, ArcGeometryArena &arena, const ArcModel::Builder &builder)
+        : arcDevice{device}, geometryArena{arena}
+    {
+        // every buffer of the model goes through one staging allocation and one submit
+        ArcUploadBatch batch{arcDevice};
+        recordUpload(builder, batch);
+        batch.submit();
+        batch.wait();
+        ready = true;
+    }
+
+    ArcModel::ArcModel(ArcDevice &device, ArcGeometryArena &arena)
+        : arcDevice{device}, geometryArena{arena}
     {
-        createVertexBuffers(builder.vertices);
-        createIndexBuffers(builder.indices);
     }
 
     ArcModel::~ArcModel()
     {
+        geometryArena.free(geometry);
+        geometryArena.free(positionGeometry);
+    }
+
+    void ArcModel::recordUpload(const Builder &builder, ArcUploadBatch &batch)
+    {
+        createGeometry(builder, batch);
+        createMeshletBuffers(builder.meshlets, batch);
     }
 
-    void ArcModel::createVertexBuffers(const std::vector<Vertex> &vertices)
+    void ArcModel::createGeometry(const Builder &builder, ArcUploadBatch &batch)
     {
+        const std::vector<Vertex> &vertices = builder.vertices;
         vertexCount = static_cast<uint32_t>(vertices.size());
         assert(vertexCount >= 3 && "Vertex count must be at least 3");
 
-        VkDeviceSize bufferSize = sizeof(vertices[0]) * vertexCount;
-        uint32_t vertexSize = sizeof(vertices[0]);
+        bounds = builder.bounds.isValid()
+                     ? builder.bounds
+                     : arc::computeBounds(&vertices[0].position.x, sizeof(Vertex), vertices.size());
 
-        ArcBuffer stagingBuffer{
-            arcDevice,
-            vertexSize,
-            vertexCount,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT};
+        // the simplifier measures errors against the box diagonal, selectLod against the sphere diameter
+        float diameter = 2.0f * bounds.sphere.w;
+        float lodErrorScale = diameter > 0.0f ? glm::length(bounds.max - bounds.min) / diameter : 1.0f;
 
-        stagingBuffer.map();
-        stagingBuffer.writeToBuffer((void *)vertices.data());
+        std::vector<PackedVertex> packed{};
+        const void *vertexData = vertices.data();
+        uint32_t vertexSize = sizeof(Vertex);
+        if (builder.packVertices)
+        {
+            VertexQuantization quantization = computeVertexQuantization(vertices);
+            packed = arc::packVertices(vertices, quantization);
+            vertexData = packed.data();
+            vertexSize = sizeof(PackedVertex);
+            packedVertices = true;
+            dequantization = quantization.dequantization();
 
-        vertexBuffer = std::make_unique<ArcBuffer>(
-            arcDevice,
-            vertexSize,
-            vertexCount,
-            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            VertexQuantizationError error = measureQuantizationError(vertices, packed, quantization);
+            std::cout << "Packed vertices " << sizeof(Vertex) << " -> " << sizeof(PackedVertex)
+                      << " bytes, max error: position " << error.position
+                      << " (" << 100.0f * error.position / quantization.scale << "% of extent), normal "
+                      << error.normalDegrees << " deg, color " << error.color << ", uv " << error.uv << '\n';
+        }
+
+        // a builder without submeshes is drawn as one with a default material
+        materials = builder.materials;
+        std::vector<Submesh> submeshes = builder.submeshes;
+        if (submeshes.empty())
+        {
+            uint32_t count = builder.indices.empty() ? vertexCount : static_cast<uint32_t>(builder.indices.size());
+            submeshes.push_back({0, count, static_cast<uint32_t>(materials.size())});
+            materials.push_back(Material{});
+        }
+        materialKeys.clear();
+        for (const auto &material : materials)
+        {
+            uint64_t key = hashBytes(material.name.data(), material.name.size());
+            key = hashBytes(material.diffuseTexture.data(), material.diffuseTexture.size(), key);
+            materialKeys.push_back(hashBytes(&material.diffuse, sizeof(material.diffuse), key));
+        }
+
+        // all levels share one index range, each level drawn from its own first index
+        hasIndexBuffer = !builder.indices.empty();
+        lodRanges.clear();
+
+        std::vector<uint32_t> allIndices{};
+        if (hasIndexBuffer)
+        {
+            allIndices = builder.indices;
+            lodRanges.push_back({0, static_cast<uint32_t>(builder.indices.size()), 0.0f, std::move(submeshes)});
+            for (const auto &lod : builder.lods)
+            {
+                LodRange range{static_cast<uint32_t>(allIndices.size()), static_cast<uint32_t>(lod.indices.size()), lod.error * lodErrorScale, lod.submeshes};
+                for (auto &submesh : range.submeshes)
+                {
+                    submesh.firstIndex += range.firstIndex;
+                }
+                lodRanges.push_back(std::move(range));
+                allIndices.insert(allIndices.end(), lod.indices.begin(), lod.indices.end());
+            }
+        }
+        else
+        {
+            // ranges count vertices instead of indices
+            lodRanges.push_back({0, vertexCount, 0.0f, std::move(submeshes)});
+        }
+        uint32_t indexCount = static_cast<uint32_t>(allIndices.size());
+
+        // every index fits in 16 bits when there are at most 65536 vertices
+        std::vector<uint16_t> shortIndices{};
+        const void *indexData = allIndices.data();
+        indexType = VK_INDEX_TYPE_UINT32;
+        if (vertexCount <= 65536)
+        {
+            shortIndices.assign(allIndices.begin(), allIndices.end());
+            indexData = shortIndices.data();
+            indexType = VK_INDEX_TYPE_UINT16;
 
-        arcDevice.copyBuffer(stagingBuffer.getBuffer(), vertexBuffer->getBuffer(), bufferSize);
+            if (hasIndexBuffer)
+            {
+                std::cout << "Using 16-bit indices, saved " << (sizeof(uint32_t) - sizeof(uint16_t)) * indexCount << " bytes\n";
+            }
+        }
+
+        geometry = geometryArena.allocate(vertexData, vertexSize, vertexCount,
+                                          indexData, indexType, indexCount,
+                                          batch);
+        memoryUsage += static_cast<VkDeviceSize>(vertexSize) * vertexCount +
+                       static_cast<VkDeviceSize>(indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t)) * indexCount;
+
+        if (builder.positionStream)
+        {
+            createPositionStream(builder, packed, batch);
+        }
     }
 
-    void ArcModel::createIndexBuffers(const std::vector<uint32_t> &indices)
+    void ArcModel::createPositionStream(const Builder &builder, const std::vector<PackedVertex> &packed, ArcUploadBatch &batch)
     {
-        // std::cout << "indexCount : " << indices.size() << '\n';
-        indexCount = static_cast<uint32_t>(indices.size());
-        hasIndexBuffer = indexCount > 0;
+        // same vertex order as the main stream, so the model's indices address both
+        if (packedVertices)
+        {
+            std::vector<PackedPositionVertex> positions(packed.size());
+            for (size_t i = 0; i < packed.size(); ++i)
+            {
+                std::copy(std::begin(packed[i].position), std::end(packed[i].position), positions[i].position);
+                std::copy(std::begin(packed[i].normal), std::end(packed[i].normal), positions[i].normal);
+            }
+            positionGeometry = geometryArena.allocateVertices(positions.data(), sizeof(PackedPositionVertex), vertexCount, batch);
+            memoryUsage += static_cast<VkDeviceSize>(sizeof(PackedPositionVertex)) * vertexCount;
+        }
+        else
+        {
+            std::vector<PositionVertex> positions(builder.vertices.size());
+            for (size_t i = 0; i < builder.vertices.size(); ++i)
+            {
+                positions[i] = {builder.vertices[i].position, builder.vertices[i].normal};
+            }
+            positionGeometry = geometryArena.allocateVertices(positions.data(), sizeof(PositionVertex), vertexCount, batch);
+            memoryUsage += static_cast<VkDeviceSize>(sizeof(PositionVertex)) * vertexCount;
+        }
+    }
 
-        if (!hasIndexBuffer)
+    void ArcModel::createMeshletBuffers(const MeshletData &meshlets, ArcUploadBatch &batch)
+    {
+        meshletCount = static_cast<uint32_t>(meshlets.meshlets.size());
+        if (meshletCount == 0)
             return;
 
-        VkDeviceSize bufferSize = sizeof(indices[0]) * indexCount;
-        uint32_t indexSize = sizeof(indices[0]);
+        // triangles are read as packed uints on the GPU, buildMeshlets keeps them 4-byte aligned
+        assert(meshlets.triangles.size() % sizeof(uint32_t) == 0 && "Meshlet triangles must be 4-byte aligned");
 
-        ArcBuffer stagingBuffer{
-            arcDevice,
-            indexSize,
-            indexCount,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        };
+        meshletBuffer = createDeviceLocalBuffer(meshlets.meshlets.data(), sizeof(Meshlet), meshletCount,
+                                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, batch);
+        meshletBoundsBuffer = createDeviceLocalBuffer(meshlets.bounds.data(), sizeof(MeshletBounds), meshletCount,
+                                                      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, batch);
+        meshletVertexBuffer = createDeviceLocalBuffer(meshlets.vertices.data(), sizeof(uint32_t),
+                                                      static_cast<uint32_t>(meshlets.vertices.size()),
+                                                      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, batch);
+        meshletTriangleBuffer = createDeviceLocalBuffer(meshlets.triangles.data(), sizeof(uint32_t),
+                                                        static_cast<uint32_t>(meshlets.triangles.size() / sizeof(uint32_t)),
+                                                        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, batch);
+    }
 
-        stagingBuffer.map();
-        stagingBuffer.writeToBuffer((void *)indices.data());
+    std::unique_ptr<ArcBuffer> ArcModel::createDeviceLocalBuffer(const void *data,
+                                                                 uint32_t instanceSize,
+                                                                 uint32_t instanceCount,
+                                                                 VkBufferUsageFlags usage,
+                                                                 ArcUploadBatch &batch)
+    {
+        VkDeviceSize bufferSize = static_cast<VkDeviceSize>(instanceSize) * instanceCount;
 
-        indexBuffer = std::make_unique<ArcBuffer>(
+        auto buffer = std::make_unique<ArcBuffer>(
             arcDevice,
-            indexSize,
-            indexCount,
-            VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            instanceSize,
+            instanceCount,
+            usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-        arcDevice.copyBuffer(stagingBuffer.getBuffer(), indexBuffer->getBuffer(), bufferSize);
+        batch.uploadBuffer(buffer->getBuffer(), data, bufferSize);
+        memoryUsage += buffer->getBufferSize();
+        return buffer;
     }
 
-    std::unique_ptr<ArcModel> ArcModel::createModelFromFile(ArcDevice &device, const std::string &filepath)
+    std::unique_ptr<ArcModel> ArcModel::createModelFromFile(ArcDevice &device, ArcGeometryArena &arena, const std::string &filepath)
     {
         Builder builder{};
         builder.loadModel(filepath);
         std::cout << "Vertex count: " << builder.vertices.size() << '\n';
         std::cout << "Index count: " << builder.indices.size() << '\n';
-        return std::make_unique<ArcModel>(device, builder);
+        return std::make_unique<ArcModel>(device, arena, builder);
     }
 
-    void ArcModel::draw(VkCommandBuffer commandBuffer)
+    void ArcModel::draw(VkCommandBuffer commandBuffer, uint32_t lod)
     {
         if (hasIndexBuffer)
         {
-            vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, 0);
+            const LodRange &range = lodRanges[std::min<size_t>(lod, lodRanges.size() - 1)];
+            vkCmdDrawIndexed(commandBuffer, range.indexCount, 1,
+                             geometry.firstIndex + range.firstIndex,
+                             static_cast<int32_t>(geometry.vertexOffset), 0);
         }
         else
         {
-            vkCmdDraw(commandBuffer, vertexCount, 1, 0, 0);
+            vkCmdDraw(commandBuffer, vertexCount, 1, geometry.vertexOffset, 0);
         }
     }
 
-    void ArcModel::bind(VkCommandBuffer commandBuffer)
+    void ArcModel::drawSubmesh(VkCommandBuffer commandBuffer, uint32_t submesh, uint32_t lod)
     {
-        VkBuffer buffers[] = {vertexBuffer->getBuffer()};
-        VkDeviceSize offsets[] = {0};
-        vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+        const Submesh &range = getSubmeshes(lod)[submesh];
+        if (hasIndexBuffer)
+        {
+            vkCmdDrawIndexed(commandBuffer, range.indexCount, 1,
+                             geometry.firstIndex + range.firstIndex,
+                             static_cast<int32_t>(geometry.vertexOffset), 0);
+        }
+        else
+        {
+            vkCmdDraw(commandBuffer, range.indexCount, 1, geometry.vertexOffset + range.firstIndex, 0);
+        }
+    }
 
+    void ArcModel::drawPositions(VkCommandBuffer commandBuffer, uint32_t lod)
+    {
+        assert(hasPositionStream() && "Model was built without a position stream");
         if (hasIndexBuffer)
         {
-            vkCmdBindIndexBuffer(commandBuffer, indexBuffer->getBuffer(), 0, VK_INDEX_TYPE_UINT32);
+            const LodRange &range = lodRanges[std::min<size_t>(lod, lodRanges.size() - 1)];
+            vkCmdDrawIndexed(commandBuffer, range.indexCount, 1,
+                             geometry.firstIndex + range.firstIndex,
+                             static_cast<int32_t>(positionGeometry.vertexOffset), 0);
+        }
+        else
+        {
+            vkCmdDraw(commandBuffer, vertexCount, 1, positionGeometry.vertexOffset, 0);
         }
     }
 
-    void ArcModel::Builder::loadModel(const std::string &filepath)
+    uint32_t ArcModel::selectLod(float projectedRadius) const
+    {
+        // errors are fractions of the sphere diameter, which covers 2 * projectedRadius of the 2 unit high NDC range
+        uint32_t lod = 0;
+        for (uint32_t i = 1; i < lodRanges.size(); ++i)
+        {
+            if (lodRanges[i].error * projectedRadius > lodScreenError)
+                break;
+            lod = i;
+        }
+        return lod;
+    }
+
+    void ArcModel::bind(VkCommandBuffer commandBuffer)
     {
-        // tinyobj::attrib_t attrib;
-        // std::vector<tinyobj::shape_t> shapes;
-        // std::vector<tinyobj::material_t> materials;
-        // std::string warn, err;
+        geometryArena.bind(commandBuffer, geometry.block);
+    }
 
-        // std::string enginePath = ENGINE_DIR + filepath;
-        // if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, enginePath.c_str()))
-        // {
-        //     throw std::runtime_error(warn + err);
-        // }
+    void ArcModel::bindPositions(VkCommandBuffer commandBuffer)
+    {
+        geometryArena.bind(commandBuffer, positionGeometry.block, geometry.block);
+    }
 
+    void ArcModel::Builder::loadModel(const std::string &filepath)
+    {
         std::string enginePath = ENGINE_DIR + filepath;
-        tinyobj::ObjReaderConfig readerConfig;
-        tinyobj::ObjReader reader;
-        readerConfig.mtl_search_path = "";
+        std::string cachePath = enginePath + MESH_CACHE_EXTENSION;
+
+        auto startTime = std::chrono::high_resolution_clock::now();
 
-        if (!reader.ParseFromFile(enginePath, readerConfig))
+        uint64_t sourceHash = 0;
         {
-            if (!reader.Error().empty())
+            ArcMappedFile source{enginePath};
+            if (!source.isOpen())
             {
-                throw std::runtime_error(reader.Error());
+                throw std::runtime_error("failed to open model file: " + filepath);
             }
+            sourceHash = hashSource(source);
         }
 
-        if (!reader.Warning().empty())
+        if (useCache && readMeshCache(*this, cachePath, sourceHash))
         {
-            std::cout << "TinyObjReader: " << reader.Warning() << '\n';
+            std::cout << "Loaded " << filepath << " from mesh cache in " << elapsedMilliseconds(startTime) << " ms\n";
         }
+        else
+        {
+            if (isGlb(filepath))
+            {
+                readGlb(*this, enginePath);
+            }
+            else if (streamObj)
+            {
+                streamObjFile(*this, enginePath);
+            }
+            else
+            {
+                parseObj(*this, enginePath);
+            }
+            resolveTexturePaths(*this, filepath);
+            groupSubmeshes(*this);
+            std::cout << "Parsed " << filepath << " in " << elapsedMilliseconds(startTime) << " ms, "
+                      << submeshes.size() << " submesh(es)\n";
 
-        auto &attrib = reader.GetAttrib();
-        auto &shapes = reader.GetShapes();
+            if (optimizeMesh)
+            {
+                optimizeMeshLayout(*this, filepath);
+            }
 
-        vertices.clear();
-        indices.clear();
+            generateLods(*this, filepath);
 
-        std::unordered_map<Vertex, uint32_t> uniqueVertices{};
-        // loop over shapes
-        for (size_t s = 0; s < shapes.size(); ++s)
-        {
-            size_t indexOffset = 0;
-            for (size_t f = 0; f < shapes[s].mesh.num_face_vertices.size(); ++f)
+            if (useCache)
             {
-                size_t fv = size_t(shapes[s].mesh.num_face_vertices[f]);
+                writeMeshCache(*this, cachePath, sourceHash);
+            }
+        }
 
-                for (size_t v = 0; v < fv; v++)
-                {
-                    // access to vertex
-                    tinyobj::index_t idx = shapes[s].mesh.indices[indexOffset + v];
-                    Vertex vertex{};
-                    if (idx.vertex_index >= 0)
-                    {
-                        vertex.position.x = attrib.vertices[3 * size_t(idx.vertex_index) + 0];
-                        vertex.position.y = attrib.vertices[3 * size_t(idx.vertex_index) + 1];
-                        vertex.position.z = attrib.vertices[3 * size_t(idx.vertex_index) + 2];
+        computeBounds();
 
-                        vertex.color.x = attrib.colors[3 * size_t(idx.vertex_index) + 0];
-                        vertex.color.y = attrib.colors[3 * size_t(idx.vertex_index) + 1];
-                        vertex.color.z = attrib.colors[3 * size_t(idx.vertex_index) + 2];
-                    }
+        if (buildMeshlets && !indices.empty())
+        {
+            auto meshletStart = std::chrono::high_resolution_clock::now();
+            arc::buildMeshlets(meshlets, indices, &vertices[0].position.x, sizeof(Vertex));
+            std::cout << "Built " << meshlets.meshlets.size() << " meshlets for " << filepath << " in "
+                      << elapsedMilliseconds(meshletStart) << " ms\n";
+        }
 
-                    // Check if normal index
-                    if (idx.normal_index >= 0)
-                    {
-                        vertex.normal.x = attrib.normals[3 * size_t(idx.normal_index) + 0];
-                        vertex.normal.y = attrib.normals[3 * size_t(idx.normal_index) + 1];
-                        vertex.normal.z = attrib.normals[3 * size_t(idx.normal_index) + 2];
-                    }
+#ifdef ARC_BENCHMARKS
+        // startup benchmark: the cold build the cache saves, parse through lods, against a warm cache read of the same file
+        {
+            Builder cold{};
+            cold.workerThreads = workerThreads;
+            cold.optimizeMesh = optimizeMesh;
+            cold.lodSettings = lodSettings;
+            const char *reader = "obj";
+            auto coldStart = std::chrono::high_resolution_clock::now();
+            if (isGlb(filepath))
+            {
+                readGlb(cold, enginePath);
+                reader = "glb";
+            }
+            else if (streamObj)
+            {
+                streamObjFile(cold, enginePath);
+                reader = "streamed obj";
+            }
+            else
+            {
+                parseObj(cold, enginePath);
+            }
+            resolveTexturePaths(cold, filepath);
+            groupSubmeshes(cold);
+            if (optimizeMesh)
+            {
+                optimizeMeshLayout(cold, filepath);
+            }
+            generateLods(cold, filepath);
+            double coldMs = elapsedMilliseconds(coldStart);
 
-                    if (idx.texcoord_index >= 0)
-                    {
-                        vertex.uv.x = attrib.texcoords[2 * size_t(idx.texcoord_index) + 0];
-                        vertex.uv.y = 1.0f - attrib.texcoords[2 * size_t(idx.texcoord_index) + 1];
-                    }
+            // the cache only matches the options it was built with
+            Builder warm{};
+            warm.streamObj = streamObj;
+            warm.optimizeMesh = optimizeMesh;
+            warm.lodSettings = lodSettings;
+            auto warmStart = std::chrono::high_resolution_clock::now();
+            bool warmHit = readMeshCache(warm, cachePath, sourceHash);
+            double warmMs = elapsedMilliseconds(warmStart);
 
-                    if (uniqueVertices.count(vertex) == 0)
-                    {
-                        uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-                        vertices.push_back(vertex);
-                    }
-                    indices.push_back(uniqueVertices[vertex]);
-                }
-                indexOffset += fv;
-            }
+            std::cout << "[benchmark] " << filepath << ": cold " << reader << " build " << coldMs << " ms, warm cache "
+                      << (warmHit ? std::to_string(warmMs) + " ms" : std::string("miss")) << '\n';
         }
+#endif
+    }
+
+    void ArcModel::Builder::computeBounds()
+    {
+        bounds = vertices.empty() ? Bounds{} : arc::computeBounds(&vertices[0].position.x, sizeof(Vertex), vertices.size());
     }
-}
\ No newline at end of file
+}
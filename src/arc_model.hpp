@@ -2,7 +2,10 @@
 #define __ARC_MODEL_H__
 
 #include "arc_device.hpp"
+#include "arc_bounds.hpp"
 #include "arc_buffer.hpp"
+#include "arc_geometry_arena.hpp"
+#include "arc_meshlet.hpp"
 
 // libs
 #define GLM_FORCE_RADIANS
@@ -10,11 +13,18 @@
 #include <glm/glm.hpp>
 
 // std
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace arc
 {
+    class ArcAssetLoader;
+    class ArcUploadBatch;
+
     class ArcModel
     {
     public:
@@ -34,39 +44,222 @@ namespace arc
             }
         };
 
+        // Compact 20-byte layout, see arc_vertex_quantization.hpp for the encoding
+        struct PackedVertex
+        {
+            uint16_t position[4]; // unorm16, dequantized by the model's dequantization transform
+            int16_t normal[2];    // snorm16 octahedral
+            uint8_t color[4];     // unorm8
+            uint16_t uv[2];       // fp16
+
+            static std::vector<VkVertexInputBindingDescription> getBindingDescriptions();
+            static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
+        };
+
+        // Deinterleaved copies of the attributes depth and outline passes read, so those passes fetch
+        // 24 or 12 bytes per vertex instead of the whole vertex
+        struct PositionVertex
+        {
+            glm::vec3 position{};
+            glm::vec3 normal{};
+
+            static std::vector<VkVertexInputBindingDescription> getBindingDescriptions();
+            static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
+        };
+
+        // position stream of a model with packed vertices, encoded as in PackedVertex
+        struct PackedPositionVertex
+        {
+            uint16_t position[4];
+            int16_t normal[2];
+
+            static std::vector<VkVertexInputBindingDescription> getBindingDescriptions();
+            static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
+        };
+
+        // Surface parameters read from the source file, renderers decide how to bind them
+        struct Material
+        {
+            std::string name{};
+            glm::vec3 diffuse{1.0f};
+            std::string diffuseTexture{}; // relative to ENGINE_DIR, empty when untextured
+        };
+
+        // A run of triangles sharing one material inside an index list
+        struct Submesh
+        {
+            uint32_t firstIndex;
+            uint32_t indexCount;
+            uint32_t material; // into the model's materials
+        };
+
+        // One simplified level of detail, sharing the model's vertex buffer
+        struct LodSettings
+        {
+            float triangleRatio; // stop at this fraction of the full detail triangle count
+            float maxError;      // or once a collapse would move the surface further, relative to the bounding box diagonal
+        };
+
+        struct Lod
+        {
+            std::vector<uint32_t> indices{};
+            std::vector<Submesh> submeshes{};
+            float error = 0.0f; // relative to the bounding box diagonal
+        };
+
         struct Builder
         {
             std::vector<Vertex> vertices{};
             std::vector<uint32_t> indices{};
+            // one submesh per material covering every index, loadModel groups the triangles by material;
+            // left empty the whole mesh is one submesh with a default material
+            std::vector<Material> materials{};
+            std::vector<Submesh> submeshes{};
 
+            // reuse the binary mesh cache written next to the source file
+            bool useCache = true;
+            // threads used to weld OBJ corners, 0 picks the hardware concurrency
+            uint32_t workerThreads = 0;
+            // parse with ArcObjStream instead of tinyobj, for OBJ files too big to hold several copies of,
+            // welds corners by their v/vt/vn indices
+            bool streamObj = false;
+            // reorder triangles and vertices for vertex cache and fetch locality
+            bool optimizeMesh = true;
+            // upload PackedVertex instead of Vertex, drawn with the *_packed shader variants
+            bool packVertices = false;
+            // also upload a PositionVertex (or PackedPositionVertex) stream, drawn with bindPositions and drawPositions
+            bool positionStream = false;
+            // split the index buffer into meshlets with culling bounds, uploaded as storage buffers
+            bool buildMeshlets = false;
+            MeshletData meshlets{};
+            // coarser levels simplified from the full detail mesh, levels that barely reduce are dropped
+            std::vector<LodSettings> lodSettings{{0.5f, 0.005f}, {0.25f, 0.01f}, {0.1f, 0.02f}};
+            std::vector<Lod> lods{};
+
+            // model space extent, filled in by loadModel and computeBounds, computed on upload if still invalid
+            Bounds bounds{};
+
+            // .glb files go through readGlb, anything else is parsed as OBJ
             void loadModel(const std::string &filepath);
+            void computeBounds();
         };
 
-        ArcModel(ArcDevice &device, const ArcModel::Builder &builder);
+        // uploads the builder's geometry into the arena right away and waits for the copies
+        ArcModel(ArcDevice &device, ArcGeometryArena &arena, const ArcModel::Builder &builder);
         ~ArcModel();
 
         ArcModel(const ArcModel &) = delete;
         ArcModel operator=(const ArcModel &) = delete;
 
-        static std::unique_ptr<ArcModel> createModelFromFile(ArcDevice &device, const std::string &filepath);
+        static std::unique_ptr<ArcModel> createModelFromFile(ArcDevice &device, ArcGeometryArena &arena, const std::string &filepath);
+
+        // false while an asynchronous load is still parsing or uploading, see ArcAssetLoader
+        bool isReady() const { return ready; }
+        // true once an asynchronous load gave up, the model never turns ready then
+        bool hasFailed() const { return failed; }
 
+        // binds the arena block holding the model, models sharing a block only need one bind
         void bind(VkCommandBuffer commandBuffer);
-        void draw(VkCommandBuffer commandBuffer);
+        uint32_t getGeometryBlock() const { return geometry.block; }
+        void draw(VkCommandBuffer commandBuffer, uint32_t lod = 0);
+        // draws one material's triangles, the submeshes of a level together cover the same range as draw
+        void drawSubmesh(VkCommandBuffer commandBuffer, uint32_t submesh, uint32_t lod = 0);
+
+        // the position stream lives in its own vertex only block and is indexed by the model's indices
+        bool hasPositionStream() const { return positionGeometry.block != ArcGeometryArena::INVALID_BLOCK; }
+        uint32_t getPositionBlock() const { return positionGeometry.block; }
+        // binds the position stream at binding 0 with the model's index buffer
+        void bindPositions(VkCommandBuffer commandBuffer);
+        void drawPositions(VkCommandBuffer commandBuffer, uint32_t lod = 0);
+
+        const std::vector<Material> &getMaterials() const { return materials; }
+        // equal for materials with the same name and parameters, so draws can be sorted across models
+        uint64_t getMaterialKey(uint32_t material) const { return materialKeys[material]; }
+        // one per material, ranges are relative to the model
+        const std::vector<Submesh> &getSubmeshes(uint32_t lod = 0) const
+        {
+            return lodRanges[std::min<size_t>(lod, lodRanges.size() - 1)].submeshes;
+        }
+
+        // level 0 is the full detail mesh
+        uint32_t getLodCount() const { return static_cast<uint32_t>(lodRanges.size()); }
+        // the coarsest level whose error, projected onto the screen, stays below the screen error
+        // projectedRadius is the bounding sphere radius in NDC units, see ArcCamera::projectedRadius
+        uint32_t selectLod(float projectedRadius) const;
+        // largest tolerated error as a fraction of the screen height, about one pixel at 1080p by default
+        void setLodScreenError(float screenError) { lodScreenError = screenError; }
+        // model space box and sphere enclosing every vertex, see transformBounds for world space
+        const Bounds &getBounds() const { return bounds; }
+        glm::vec4 getBoundingSphere() const { return bounds.sphere; }
+
+        // device memory held by the model's geometry ranges and meshlet buffers
+        VkDeviceSize getMemoryUsage() const { return memoryUsage; }
+
+        bool hasPackedVertices() const { return packedVertices; }
+        // offset (xyz) and uniform scale (w) that take packed positions back to model space
+        glm::vec4 getDequantization() const { return dequantization; }
+
+        // storage buffers laid out as in arc_meshlet.hpp, null unless the builder produced meshlets
+        uint32_t getMeshletCount() const { return meshletCount; }
+        ArcBuffer *getMeshletBuffer() const { return meshletBuffer.get(); }
+        ArcBuffer *getMeshletBoundsBuffer() const { return meshletBoundsBuffer.get(); }
+        ArcBuffer *getMeshletVertexBuffer() const { return meshletVertexBuffer.get(); }
+        ArcBuffer *getMeshletTriangleBuffer() const { return meshletTriangleBuffer.get(); }
 
     private:
-        void createVertexBuffers(const std::vector<Vertex> &vertices);
-        void createIndexBuffers(const std::vector<uint32_t> &indices);
+        friend class ArcAssetLoader;
+
+        // empty model, filled in by recordUpload and marked ready by its owner once the batch completed
+        ArcModel(ArcDevice &device, ArcGeometryArena &arena);
+
+        void recordUpload(const Builder &builder, ArcUploadBatch &batch);
+        void createGeometry(const Builder &builder, ArcUploadBatch &batch);
+        void createPositionStream(const Builder &builder, const std::vector<PackedVertex> &packed, ArcUploadBatch &batch);
+        void createMeshletBuffers(const MeshletData &meshlets, ArcUploadBatch &batch);
+        std::unique_ptr<ArcBuffer> createDeviceLocalBuffer(const void *data,
+                                                           uint32_t instanceSize,
+                                                           uint32_t instanceCount,
+                                                           VkBufferUsageFlags usage,
+                                                           ArcUploadBatch &batch);
 
     private:
         ArcDevice &arcDevice;
+        ArcGeometryArena &geometryArena;
+        // set on the render thread, read from any thread
+        std::atomic<bool> ready{false};
+        std::atomic<bool> failed{false};
 
-        std::unique_ptr<ArcBuffer> vertexBuffer;
+        // vertices and every lod's indices, suballocated from the arena
+        ArcGeometryArena::Range geometry{};
+        // position stream, vertices only
+        ArcGeometryArena::Range positionGeometry{};
+        VkDeviceSize memoryUsage = 0;
         uint32_t vertexCount;
+        bool packedVertices = false;
+        glm::vec4 dequantization{0.0f, 0.0f, 0.0f, 1.0f};
+        Bounds bounds{};
 
         bool hasIndexBuffer = false;
+        VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+
+        // every level lives in the model's index range, level 0 first
+        struct LodRange
+        {
+            uint32_t firstIndex;
+            uint32_t indexCount;
+            float error;
+            std::vector<Submesh> submeshes;
+        };
+        std::vector<LodRange> lodRanges{};
+        std::vector<Material> materials{};
+        std::vector<uint64_t> materialKeys{};
+        float lodScreenError = 1.0f / 1080.0f;
 
-        std::unique_ptr<ArcBuffer> indexBuffer;
-        uint32_t indexCount;
+        uint32_t meshletCount = 0;
+        std::unique_ptr<ArcBuffer> meshletBuffer;
+        std::unique_ptr<ArcBuffer> meshletBoundsBuffer;
+        std::unique_ptr<ArcBuffer> meshletVertexBuffer;
+        std::unique_ptr<ArcBuffer> meshletTriangleBuffer;
     };
 }
 #endif // __ARC_MODEL_H__
\ No newline at end of file
@@ -0,0 +1,233 @@
+#include "arc_model_registry.hpp"
+#include "arc_swap_chain.hpp"
+#include "arc_utils.hpp"
+
+// std
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+#ifndef ENGINE_DIR
+#define ENGINE_DIR "../"
+#endif
+
+namespace arc
+{
+    ArcModelRegistry::ArcModelRegistry(ArcAssetLoader &loader, VkDeviceSize memoryBudget)
+        : assetLoader{loader}, memoryBudget{memoryBudget}
+    {
+    }
+
+    ArcModelRegistry::~ArcModelRegistry()
+    {
+    }
+
+    std::string ArcModelRegistry::canonicalPath(const std::string &filepath)
+    {
+        // "models/../models/vase.obj" and "models/vase.obj" are the same file
+        std::error_code error;
+        std::filesystem::path path = std::filesystem::weakly_canonical(ENGINE_DIR + filepath, error);
+        if (error)
+        {
+            path = std::filesystem::path{ENGINE_DIR + filepath}.lexically_normal();
+        }
+        return path.string();
+    }
+
+    std::string ArcModelRegistry::makeKey(const std::string &filepath, const ArcModel::Builder &builder)
+    {
+        // every option that changes what ends up on the GPU, the thread count and the disk cache do not
+        std::size_t options = 0;
+        hashCombine(options, builder.streamObj, builder.optimizeMesh, builder.packVertices, builder.positionStream, builder.buildMeshlets,
+                    hashBytes(builder.lodSettings.data(), builder.lodSettings.size() * sizeof(ArcModel::LodSettings)));
+
+        std::ostringstream key;
+        key << canonicalPath(filepath) << '#' << std::hex << options;
+        return key.str();
+    }
+
+    std::shared_ptr<ArcModel> ArcModelRegistry::getModel(const std::string &filepath, const ArcModel::Builder &builder)
+    {
+        std::string key = makeKey(filepath, builder);
+
+        std::lock_guard<std::mutex> lock{mutex};
+        auto it = entries.find(key);
+        if (it != entries.end())
+        {
+            stats.hits++;
+            it->second.lastUse = ++useCounter;
+            return it->second.model;
+        }
+
+        stats.misses++;
+        ArcModel::Builder options{};
+        options.useCache = builder.useCache;
+        options.workerThreads = builder.workerThreads;
+        options.streamObj = builder.streamObj;
+        options.optimizeMesh = builder.optimizeMesh;
+        options.packVertices = builder.packVertices;
+        options.positionStream = builder.positionStream;
+        options.buildMeshlets = builder.buildMeshlets;
+        options.lodSettings = builder.lodSettings;
+
+        auto model = assetLoader.loadModelAsync(filepath, options);
+        entries.emplace(key, Entry{model, ++useCounter, filepath, std::move(options)});
+
+        // make room for the new model once it is resident
+        trimLocked();
+        return model;
+    }
+
+    size_t ArcModelRegistry::reload(const std::string &filepath)
+    {
+        std::string prefix = canonicalPath(filepath) + '#';
+
+        std::lock_guard<std::mutex> lock{mutex};
+        size_t count = 0;
+        for (const auto &kv : entries)
+        {
+            if (kv.first.compare(0, prefix.size(), prefix) != 0)
+                continue;
+
+            // a newer reload of the same model supersedes one still loading
+            pendingReloads.erase(std::remove_if(pendingReloads.begin(), pendingReloads.end(),
+                                                [&](const PendingReload &pending)
+                                                { return pending.key == kv.first; }),
+                                 pendingReloads.end());
+            pendingReloads.push_back({kv.first, assetLoader.loadModelAsync(kv.second.filepath, kv.second.options)});
+            count++;
+        }
+        return count;
+    }
+
+    std::vector<ArcModelRegistry::Reload> ArcModelRegistry::collectReloads()
+    {
+        std::vector<Reload> reloads{};
+
+        std::lock_guard<std::mutex> lock{mutex};
+        for (auto it = pendingReloads.begin(); it != pendingReloads.end();)
+        {
+            if (it->model->hasFailed())
+            {
+                std::cout << "Reload of " << it->key << " failed, keeping the previous model\n";
+                it = pendingReloads.erase(it);
+                continue;
+            }
+            if (!it->model->isReady())
+            {
+                ++it;
+                continue;
+            }
+
+            // an entry evicted while its replacement loaded has nobody left to hand it to
+            auto entry = entries.find(it->key);
+            if (entry != entries.end())
+            {
+                reloads.push_back({entry->second.model, it->model});
+                entry->second.model = it->model;
+            }
+            it = pendingReloads.erase(it);
+        }
+        return reloads;
+    }
+
+    std::vector<std::string> ArcModelRegistry::getFilepaths() const
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        std::vector<std::string> filepaths{};
+        for (const auto &kv : entries)
+        {
+            if (std::find(filepaths.begin(), filepaths.end(), kv.second.filepath) == filepaths.end())
+            {
+                filepaths.push_back(kv.second.filepath);
+            }
+        }
+        return filepaths;
+    }
+
+    void ArcModelRegistry::trim()
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        trimLocked();
+    }
+
+    void ArcModelRegistry::trimLocked()
+    {
+        VkDeviceSize residentBytes = residentBytesLocked();
+        while (residentBytes > memoryBudget)
+        {
+            // only the registry holds an unused model, models still loading are left alone
+            auto victim = entries.end();
+            for (auto it = entries.begin(); it != entries.end(); ++it)
+            {
+                const auto &model = it->second.model;
+                if (model.use_count() != 1 || !model->isReady())
+                    continue;
+                if (victim == entries.end() || it->second.lastUse < victim->second.lastUse)
+                {
+                    victim = it;
+                }
+            }
+            if (victim == entries.end())
+                break;
+
+            std::cout << "Evicting " << victim->first << ", " << victim->second.model->getMemoryUsage() << " bytes\n";
+            residentBytes -= victim->second.model->getMemoryUsage();
+            // the model gives its arena range back when destroyed, a frame submitted so far may still draw it
+            retired.push_back({std::move(victim->second.model), frame + ArcSwapChain::MAX_FRAMES_IN_FLIGHT});
+            entries.erase(victim);
+            stats.evictions++;
+        }
+    }
+
+    void ArcModelRegistry::update()
+    {
+        std::vector<std::shared_ptr<ArcModel>> released{};
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            frame++;
+            while (!retired.empty() && retired.front().releaseFrame <= frame)
+            {
+                released.push_back(std::move(retired.front().model));
+                retired.pop_front();
+            }
+        }
+        // released goes out of scope after the lock, destroying a model frees its arena range
+    }
+
+    VkDeviceSize ArcModelRegistry::residentBytesLocked() const
+    {
+        VkDeviceSize bytes = 0;
+        for (const auto &kv : entries)
+        {
+            if (kv.second.model->isReady())
+            {
+                bytes += kv.second.model->getMemoryUsage();
+            }
+        }
+        return bytes;
+    }
+
+    void ArcModelRegistry::setMemoryBudget(VkDeviceSize budget)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        memoryBudget = budget;
+        trimLocked();
+    }
+
+    VkDeviceSize ArcModelRegistry::getMemoryBudget() const
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return memoryBudget;
+    }
+
+    ArcModelRegistry::Stats ArcModelRegistry::getStats() const
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        Stats result = stats;
+        result.models = static_cast<uint32_t>(entries.size());
+        result.residentBytes = residentBytesLocked();
+        return result;
+    }
+}
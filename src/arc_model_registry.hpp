@@ -0,0 +1,110 @@
+#ifndef __ARC_MODEL_REGISTRY_H__
+#define __ARC_MODEL_REGISTRY_H__
+
+#include "arc_asset_loader.hpp"
+#include "arc_model.hpp"
+
+// std
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace arc
+{
+    // Hands out one shared model per file and load options, so repeated requests skip the parse and the upload.
+    // Models nobody else holds on to stay cached until the resident memory exceeds the budget,
+    // then the least recently requested ones are evicted first. An evicted model is destroyed
+    // only after update() ran MAX_FRAMES_IN_FLIGHT more times, a frame still in flight may draw it.
+    // Safe to call from any thread, loads go through the asset loader.
+    class ArcModelRegistry
+    {
+    public:
+        struct Stats
+        {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t evictions = 0;
+            uint32_t models = 0;
+            // device memory of the cached models that finished loading
+            VkDeviceSize residentBytes = 0;
+        };
+
+        // a model replaced by reload and the model now cached in its place
+        struct Reload
+        {
+            std::shared_ptr<ArcModel> previous;
+            std::shared_ptr<ArcModel> current;
+        };
+
+        ArcModelRegistry(ArcAssetLoader &loader, VkDeviceSize memoryBudget = 256 * 1024 * 1024);
+        ~ArcModelRegistry();
+
+        ArcModelRegistry(const ArcModelRegistry &) = delete;
+        ArcModelRegistry &operator=(const ArcModelRegistry &) = delete;
+
+        // builder only carries load options, geometry in it is ignored
+        std::shared_ptr<ArcModel> getModel(const std::string &filepath, const ArcModel::Builder &builder = {});
+
+        // loads every cached model of filepath again with its original options, returns how many
+        // the cached models keep being handed out until their replacements are ready
+        size_t reload(const std::string &filepath);
+        // on the render thread, the reloads whose new model finished since the last call
+        // the caller swaps its own references and keeps previous alive until no frame draws it anymore
+        std::vector<Reload> collectReloads();
+        // files of every cached model, as they were requested
+        std::vector<std::string> getFilepaths() const;
+
+        // evicts unused models, least recently requested first, until the budget is met
+        void trim();
+        // call once per frame on the render thread, destroys evicted models no frame can draw anymore
+        void update();
+        void setMemoryBudget(VkDeviceSize budget);
+        VkDeviceSize getMemoryBudget() const;
+
+        Stats getStats() const;
+
+    private:
+        struct Entry
+        {
+            std::shared_ptr<ArcModel> model;
+            uint64_t lastUse;
+            std::string filepath;
+            ArcModel::Builder options;
+        };
+
+        struct Retired
+        {
+            std::shared_ptr<ArcModel> model;
+            uint64_t releaseFrame;
+        };
+
+        struct PendingReload
+        {
+            std::string key;
+            std::shared_ptr<ArcModel> model;
+        };
+
+        static std::string canonicalPath(const std::string &filepath);
+        static std::string makeKey(const std::string &filepath, const ArcModel::Builder &builder);
+        void trimLocked();
+        VkDeviceSize residentBytesLocked() const;
+
+        ArcAssetLoader &assetLoader;
+
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, Entry> entries{};
+        std::vector<PendingReload> pendingReloads{};
+        // evicted models whose geometry a submitted frame may still read
+        std::deque<Retired> retired{};
+        uint64_t frame = 0;
+        VkDeviceSize memoryBudget;
+        uint64_t useCounter = 0;
+        Stats stats{};
+    };
+}
+
+#endif // __ARC_MODEL_REGISTRY_H__
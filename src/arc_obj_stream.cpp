@@ -0,0 +1,371 @@
+#include "arc_obj_stream.hpp"
+
+// std
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+namespace arc
+{
+    namespace
+    {
+        constexpr size_t MIN_CORNER_CAPACITY = 1024;
+        // consumed file pages are dropped from the resident set in steps of this size
+        constexpr size_t DISCARD_STEP = 4 * 1024 * 1024;
+
+        inline bool isSpace(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        inline const char *skipSpace(const char *cursor, const char *end)
+        {
+            while (cursor < end && isSpace(*cursor))
+                ++cursor;
+            return cursor;
+        }
+
+        // reads up to count floats, returns how many were present
+        int parseFloats(const char *&cursor, const char *end, float *values, int count)
+        {
+            int parsed = 0;
+            while (parsed < count)
+            {
+                cursor = skipSpace(cursor, end);
+                if (cursor < end && *cursor == '+')
+                    ++cursor;
+                auto result = std::from_chars(cursor, end, values[parsed]);
+                if (result.ec != std::errc{})
+                    break;
+                cursor = result.ptr;
+                parsed++;
+            }
+            return parsed;
+        }
+
+        // one based, negative counts back from the attributes read so far, 0 means absent
+        inline int32_t resolveIndex(int32_t index, size_t count)
+        {
+            if (index > 0)
+                return index - 1;
+            if (index < 0)
+                return static_cast<int32_t>(count) + index;
+            return -1;
+        }
+
+        // rest of the line without surrounding whitespace
+        inline std::string readName(const char *cursor, const char *end)
+        {
+            cursor = skipSpace(cursor, end);
+            while (end > cursor && isSpace(end[-1]))
+                --end;
+            return std::string{cursor, end};
+        }
+
+        inline bool isKeyword(const char *token, const char *end, const char *keyword)
+        {
+            size_t length = std::strlen(keyword);
+            return static_cast<size_t>(end - token) > length && std::memcmp(token, keyword, length) == 0 && isSpace(token[length]);
+        }
+
+        inline uint64_t hashCorner(int32_t position, int32_t texcoord, int32_t normal)
+        {
+            const uint64_t m = 0x9e3779b97f4a7c15ull;
+            uint64_t h = (static_cast<uint64_t>(static_cast<uint32_t>(position)) * m) ^ static_cast<uint32_t>(texcoord);
+            h = (h * m) ^ static_cast<uint32_t>(normal);
+            h *= m;
+            h ^= h >> 32;
+            return h;
+        }
+    }
+
+    uint32_t ArcObjStream::CornerTable::insert(const Corner &corner, uint32_t id, bool &inserted)
+    {
+        // load factor at or below one half
+        if ((count + 1) * 2 > slots.size())
+        {
+            rehash(std::max(MIN_CORNER_CAPACITY, slots.size() * 2));
+        }
+
+        size_t mask = slots.size() - 1;
+        size_t slot = hashCorner(corner.position, corner.texcoord, corner.normal) & mask;
+        while (slots[slot].id != EMPTY_SLOT)
+        {
+            if (slots[slot].corner == corner)
+            {
+                inserted = false;
+                return slots[slot].id;
+            }
+            slot = (slot + 1) & mask;
+        }
+
+        slots[slot] = {corner, id};
+        count++;
+        inserted = true;
+        return id;
+    }
+
+    void ArcObjStream::CornerTable::rehash(size_t capacity)
+    {
+        std::vector<Slot> old{};
+        old.swap(slots);
+        slots.assign(capacity, Slot{{0, 0, 0}, EMPTY_SLOT});
+
+        size_t mask = capacity - 1;
+        for (const auto &entry : old)
+        {
+            if (entry.id == EMPTY_SLOT)
+                continue;
+            size_t slot = hashCorner(entry.corner.position, entry.corner.texcoord, entry.corner.normal) & mask;
+            while (slots[slot].id != EMPTY_SLOT)
+                slot = (slot + 1) & mask;
+            slots[slot] = entry;
+        }
+    }
+
+    ArcObjStream::ArcObjStream(const std::string &filepath, size_t chunkVertices)
+        : file{filepath}, chunkVertices{std::max<size_t>(chunkVertices, 1)}
+    {
+    }
+
+    const char *ArcObjStream::parseCorner(const char *cursor, const char *end, Corner &corner) const
+    {
+        // v, v/vt, v//vn or v/vt/vn
+        int32_t values[3] = {0, 0, 0};
+        for (int i = 0; i < 3; ++i)
+        {
+            if (cursor < end && *cursor != '/')
+            {
+                auto result = std::from_chars(cursor, end, values[i]);
+                if (result.ec != std::errc{})
+                {
+                    throw std::runtime_error("failed to parse face index in obj file!");
+                }
+                cursor = result.ptr;
+            }
+            if (i == 2 || cursor >= end || *cursor != '/')
+                break;
+            ++cursor;
+        }
+
+        corner.position = resolveIndex(values[0], positions.size() / 3);
+        corner.texcoord = resolveIndex(values[1], texcoords.size() / 2);
+        corner.normal = resolveIndex(values[2], normals.size() / 3);
+
+        if (corner.position < 0 || static_cast<size_t>(corner.position) >= positions.size() / 3 ||
+            static_cast<size_t>(corner.texcoord + 1) > texcoords.size() / 2 ||
+            static_cast<size_t>(corner.normal + 1) > normals.size() / 3)
+        {
+            throw std::runtime_error("obj face refers to a missing vertex attribute!");
+        }
+        return cursor;
+    }
+
+    uint32_t ArcObjStream::weldCorner(const Corner &corner)
+    {
+        bool inserted = false;
+        uint32_t id = corners.insert(corner, vertexCount, inserted);
+        if (!inserted)
+            return id;
+
+        ArcModel::Vertex vertex{};
+        size_t p = 3 * static_cast<size_t>(corner.position);
+        vertex.position = {positions[p + 0], positions[p + 1], positions[p + 2]};
+        vertex.color = colors.empty() ? glm::vec3{1.0f} : glm::vec3{colors[p + 0], colors[p + 1], colors[p + 2]};
+        if (corner.normal >= 0)
+        {
+            size_t n = 3 * static_cast<size_t>(corner.normal);
+            vertex.normal = {normals[n + 0], normals[n + 1], normals[n + 2]};
+        }
+        if (corner.texcoord >= 0)
+        {
+            size_t t = 2 * static_cast<size_t>(corner.texcoord);
+            vertex.uv = {texcoords[t + 0], 1.0f - texcoords[t + 1]};
+        }
+
+        chunkVertexData.push_back(vertex);
+        return vertexCount++;
+    }
+
+    void ArcObjStream::emitTriangle(uint32_t a, uint32_t b, uint32_t c, const ChunkHandler &onChunk)
+    {
+        chunkIndexData.push_back(a);
+        chunkIndexData.push_back(b);
+        chunkIndexData.push_back(c);
+        indexCount += 3;
+
+        // chunks end on whole triangles, so every index refers to a vertex handed out already
+        if (chunkVertexData.size() >= chunkVertices || chunkIndexData.size() >= 3 * chunkVertices)
+        {
+            flush(onChunk);
+        }
+    }
+
+    void ArcObjStream::flush(const ChunkHandler &onChunk)
+    {
+        if (chunkVertexData.empty() && chunkIndexData.empty())
+            return;
+
+        onChunk({chunkFirstVertex,
+                 chunkVertexData.data(), chunkVertexData.size(),
+                 chunkIndexData.data(), chunkIndexData.size()});
+
+        chunkFirstVertex = vertexCount;
+        chunkVertexData.clear();
+        chunkIndexData.clear();
+    }
+
+    void ArcObjStream::useMaterial(const std::string &name)
+    {
+        auto found = std::find(materialNames.begin(), materialNames.end(), name);
+        uint32_t material = static_cast<uint32_t>(found - materialNames.begin());
+        if (found == materialNames.end())
+        {
+            materialNames.push_back(name);
+        }
+
+        if (!materialRuns.empty() && materialRuns.back().material == material)
+            return;
+        closeMaterialRun();
+        materialRuns.push_back({static_cast<uint32_t>(indexCount), 0, material});
+    }
+
+    void ArcObjStream::closeMaterialRun()
+    {
+        if (materialRuns.empty())
+            return;
+        materialRuns.back().indexCount = static_cast<uint32_t>(indexCount - materialRuns.back().firstIndex);
+        // a switch without faces in between leaves nothing to draw
+        if (materialRuns.back().indexCount == 0)
+        {
+            materialRuns.pop_back();
+        }
+    }
+
+    void ArcObjStream::read(const ChunkHandler &onChunk)
+    {
+        if (!file.isOpen())
+        {
+            throw std::runtime_error("failed to open obj file!");
+        }
+
+        positions.clear();
+        colors.clear();
+        normals.clear();
+        texcoords.clear();
+        corners = CornerTable{};
+        chunkVertexData.clear();
+        chunkVertexData.reserve(chunkVertices);
+        chunkIndexData.clear();
+        chunkIndexData.reserve(3 * chunkVertices + 3);
+        chunkFirstVertex = 0;
+        vertexCount = 0;
+        indexCount = 0;
+        materialRuns.clear();
+        materialNames.clear();
+        materialLibraries.clear();
+        materialRuns.push_back({0, 0, UINT32_MAX});
+
+        const char *fileBegin = reinterpret_cast<const char *>(file.data());
+        const char *fileEnd = fileBegin + file.size();
+        const char *cursor = fileBegin;
+        size_t discarded = 0;
+        while (cursor < fileEnd)
+        {
+            size_t consumed = static_cast<size_t>(cursor - fileBegin);
+            if (consumed - discarded >= DISCARD_STEP)
+            {
+                file.discard(discarded, consumed - discarded);
+                discarded = consumed;
+            }
+
+            const char *lineEnd = static_cast<const char *>(std::memchr(cursor, '\n', fileEnd - cursor));
+            if (lineEnd == nullptr)
+                lineEnd = fileEnd;
+
+            const char *token = skipSpace(cursor, lineEnd);
+            cursor = lineEnd + 1;
+            if (lineEnd - token < 2)
+                continue;
+
+            if (token[0] == 'v' && isSpace(token[1]))
+            {
+                // x y z with an optional r g b, colors default to white like tinyobj
+                float values[6] = {0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f};
+                const char *p = token + 2;
+                int count = parseFloats(p, lineEnd, values, 6);
+                if (count < 3)
+                {
+                    throw std::runtime_error("failed to parse vertex position in obj file!");
+                }
+                positions.insert(positions.end(), values, values + 3);
+
+                // most files carry no colors, the array only exists once the first one shows up
+                if (count == 6 && colors.empty())
+                {
+                    colors.assign(positions.size() - 3, 1.0f);
+                }
+                if (!colors.empty())
+                {
+                    colors.insert(colors.end(), values + 3, values + 6);
+                }
+            }
+            else if (token[0] == 'v' && token[1] == 'n')
+            {
+                float values[3] = {0.0f, 0.0f, 0.0f};
+                const char *p = token + 2;
+                parseFloats(p, lineEnd, values, 3);
+                normals.insert(normals.end(), values, values + 3);
+            }
+            else if (token[0] == 'v' && token[1] == 't')
+            {
+                float values[2] = {0.0f, 0.0f};
+                const char *p = token + 2;
+                parseFloats(p, lineEnd, values, 2);
+                texcoords.insert(texcoords.end(), values, values + 2);
+            }
+            else if (token[0] == 'f' && isSpace(token[1]))
+            {
+                // fan around the first corner
+                uint32_t first = 0;
+                uint32_t previous = 0;
+                uint32_t cornerCount = 0;
+                const char *p = skipSpace(token + 2, lineEnd);
+                while (p < lineEnd)
+                {
+                    Corner corner{};
+                    p = skipSpace(parseCorner(p, lineEnd, corner), lineEnd);
+                    uint32_t id = weldCorner(corner);
+
+                    if (cornerCount == 0)
+                        first = id;
+                    else if (cornerCount >= 2)
+                        emitTriangle(first, previous, id, onChunk);
+                    previous = id;
+                    cornerCount++;
+                }
+            }
+            else if (isKeyword(token, lineEnd, "usemtl"))
+            {
+                useMaterial(readName(token + 6, lineEnd));
+            }
+            else if (isKeyword(token, lineEnd, "mtllib"))
+            {
+                materialLibraries.push_back(readName(token + 6, lineEnd));
+            }
+        }
+
+        flush(onChunk);
+        closeMaterialRun();
+
+        // the attributes are only needed while faces can still refer to them
+        std::vector<float>().swap(positions);
+        std::vector<float>().swap(colors);
+        std::vector<float>().swap(normals);
+        std::vector<float>().swap(texcoords);
+        corners = CornerTable{};
+        std::vector<ArcModel::Vertex>().swap(chunkVertexData);
+        std::vector<uint32_t>().swap(chunkIndexData);
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef __ARC_OBJ_STREAM_H__
+#define __ARC_OBJ_STREAM_H__
+
+#include "arc_model.hpp"
+#include "arc_mapped_file.hpp"
+
+// std
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace arc
+{
+    // Single pass OBJ reader over a memory mapped file
+    // only the v / vt / vn attribute arrays and a v/vt/vn -> vertex id table are kept while reading,
+    // welded vertices and triangle indices leave in fixed size chunks as soon as they are complete.
+    // Corners are welded by their index triple, identical attributes under different indices stay apart.
+    // Polygons are fan triangulated, groups and objects are ignored. usemtl switches are recorded as
+    // runs of indices, the material libraries themselves are left to the caller.
+    class ArcObjStream
+    {
+    public:
+        // new vertices get consecutive ids starting at firstVertex, indices may refer to any earlier chunk
+        struct Chunk
+        {
+            uint32_t firstVertex;
+            const ArcModel::Vertex *vertices;
+            size_t vertexCount;
+            const uint32_t *indices;
+            size_t indexCount;
+        };
+        using ChunkHandler = std::function<void(const Chunk &chunk)>;
+
+        ArcObjStream(const std::string &filepath, size_t chunkVertices = 16 * 1024);
+
+        ArcObjStream(const ArcObjStream &) = delete;
+        ArcObjStream &operator=(const ArcObjStream &) = delete;
+
+        bool isOpen() const { return file.isOpen(); }
+
+        // throws on a face that points outside the attributes read so far
+        void read(const ChunkHandler &onChunk);
+
+        // totals of the last read
+        uint32_t getVertexCount() const { return vertexCount; }
+        size_t getIndexCount() const { return indexCount; }
+        // in file order, material indexes getMaterialNames, UINT32_MAX for faces before the first usemtl
+        const std::vector<ArcModel::Submesh> &getMaterialRuns() const { return materialRuns; }
+        // in order of first use
+        const std::vector<std::string> &getMaterialNames() const { return materialNames; }
+        // mtllib file names as written, relative to the OBJ file
+        const std::vector<std::string> &getMaterialLibraries() const { return materialLibraries; }
+
+    private:
+        struct Corner
+        {
+            int32_t position;
+            int32_t texcoord;
+            int32_t normal;
+
+            bool operator==(const Corner &other) const
+            {
+                return position == other.position && texcoord == other.texcoord && normal == other.normal;
+            }
+        };
+
+        // open addressing, the corner is stored next to its id so a probe never touches vertex data
+        class CornerTable
+        {
+        public:
+            // returns the id of corner, id is taken when the corner is new
+            uint32_t insert(const Corner &corner, uint32_t id, bool &inserted);
+
+        private:
+            struct Slot
+            {
+                Corner corner;
+                uint32_t id;
+            };
+            static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+            void rehash(size_t capacity);
+
+            std::vector<Slot> slots{};
+            size_t count = 0;
+        };
+
+        const char *parseCorner(const char *cursor, const char *end, Corner &corner) const;
+        uint32_t weldCorner(const Corner &corner);
+        void emitTriangle(uint32_t a, uint32_t b, uint32_t c, const ChunkHandler &onChunk);
+        void flush(const ChunkHandler &onChunk);
+        void useMaterial(const std::string &name);
+        void closeMaterialRun();
+
+        ArcMappedFile file;
+        size_t chunkVertices;
+
+        std::vector<float> positions{};
+        std::vector<float> colors{};
+        std::vector<float> normals{};
+        std::vector<float> texcoords{};
+        CornerTable corners{};
+
+        std::vector<ArcModel::Vertex> chunkVertexData{};
+        std::vector<uint32_t> chunkIndexData{};
+        uint32_t chunkFirstVertex = 0;
+        uint32_t vertexCount = 0;
+        size_t indexCount = 0;
+
+        std::vector<ArcModel::Submesh> materialRuns{};
+        std::vector<std::string> materialNames{};
+        std::vector<std::string> materialLibraries{};
+    };
+}
+
+#endif // __ARC_OBJ_STREAM_H__
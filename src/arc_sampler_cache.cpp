@@ -0,0 +1,111 @@
+#include "arc_sampler_cache.hpp"
+
+// std
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+namespace arc
+{
+    namespace
+    {
+        uint32_t bits(float value)
+        {
+            uint32_t result;
+            std::memcpy(&result, &value, sizeof(result));
+            return result;
+        }
+    }
+
+    ArcSampler::ArcSampler(VkDevice device, const VkSamplerCreateInfo &info)
+        : device{device}
+    {
+        if (vkCreateSampler(device, &info, nullptr, &sampler) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create texture sampler!");
+        }
+    }
+
+    ArcSampler::~ArcSampler()
+    {
+        vkDestroySampler(device, sampler, nullptr);
+    }
+
+    ArcSamplerCache::ArcSamplerCache(VkDevice device)
+        : device{device}
+    {
+    }
+
+    size_t ArcSamplerCache::KeyHash::operator()(const Key &key) const
+    {
+        // FNV-1a over the fields
+        uint64_t hash = 14695981039346656037ull;
+        for (uint32_t field : key)
+        {
+            hash = (hash ^ field) * 1099511628211ull;
+        }
+        return static_cast<size_t>(hash);
+    }
+
+    ArcSamplerCache::Key ArcSamplerCache::makeKey(const VkSamplerCreateInfo &info)
+    {
+        return {static_cast<uint32_t>(info.flags),
+                static_cast<uint32_t>(info.magFilter),
+                static_cast<uint32_t>(info.minFilter),
+                static_cast<uint32_t>(info.mipmapMode),
+                static_cast<uint32_t>(info.addressModeU),
+                static_cast<uint32_t>(info.addressModeV),
+                static_cast<uint32_t>(info.addressModeW),
+                bits(info.mipLodBias),
+                static_cast<uint32_t>(info.anisotropyEnable),
+                bits(info.maxAnisotropy),
+                static_cast<uint32_t>(info.compareEnable),
+                static_cast<uint32_t>(info.compareOp),
+                bits(info.minLod),
+                bits(info.maxLod),
+                static_cast<uint32_t>(info.borderColor),
+                static_cast<uint32_t>(info.unnormalizedCoordinates)};
+    }
+
+    std::shared_ptr<ArcSampler> ArcSamplerCache::acquire(const VkSamplerCreateInfo &info)
+    {
+        if (info.pNext != nullptr)
+        {
+            throw std::runtime_error("sampler cache can't key create infos with a pNext chain!");
+        }
+
+        Key key = makeKey(info);
+        std::lock_guard<std::mutex> lock{mutex};
+        std::weak_ptr<ArcSampler> &cached = samplers[key];
+        if (auto sampler = cached.lock())
+        {
+            stats.reused++;
+            return sampler;
+        }
+
+        auto sampler = std::make_shared<ArcSampler>(device, info);
+        cached = sampler;
+        stats.created++;
+
+        // entries of samplers nobody holds anymore
+        for (auto it = samplers.begin(); it != samplers.end();)
+        {
+            it = it->second.expired() ? samplers.erase(it) : std::next(it);
+        }
+        return sampler;
+    }
+
+    ArcSamplerCache::Stats ArcSamplerCache::getStats() const
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        Stats result = stats;
+        for (const auto &kv : samplers)
+        {
+            if (!kv.second.expired())
+            {
+                result.live++;
+            }
+        }
+        return result;
+    }
+}
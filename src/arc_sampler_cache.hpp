@@ -0,0 +1,75 @@
+#ifndef __ARC_SAMPLER_CACHE_H__
+#define __ARC_SAMPLER_CACHE_H__
+
+// libs
+#include <vulkan/vulkan.h>
+
+// std
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace arc
+{
+    // A VkSampler destroyed together with its last reference
+    class ArcSampler
+    {
+    public:
+        ArcSampler(VkDevice device, const VkSamplerCreateInfo &info);
+        ~ArcSampler();
+
+        ArcSampler(const ArcSampler &) = delete;
+        ArcSampler &operator=(const ArcSampler &) = delete;
+
+        VkSampler getSampler() const { return sampler; }
+
+    private:
+        VkDevice device;
+        VkSampler sampler{};
+    };
+
+    // Hands out one shared sampler per distinct VkSamplerCreateInfo, drivers cap how many samplers may exist
+    // safe to call from any thread
+    class ArcSamplerCache
+    {
+    public:
+        struct Stats
+        {
+            uint64_t created = 0;
+            uint64_t reused = 0;
+            // samplers somebody still holds
+            uint32_t live = 0;
+        };
+
+        ArcSamplerCache(VkDevice device);
+
+        ArcSamplerCache(const ArcSamplerCache &) = delete;
+        ArcSamplerCache &operator=(const ArcSamplerCache &) = delete;
+
+        // info can't carry a pNext chain, those aren't compared
+        std::shared_ptr<ArcSampler> acquire(const VkSamplerCreateInfo &info);
+
+        Stats getStats() const;
+
+    private:
+        // every field after pNext is 32 bits wide
+        using Key = std::array<uint32_t, 16>;
+
+        struct KeyHash
+        {
+            size_t operator()(const Key &key) const;
+        };
+
+        static Key makeKey(const VkSamplerCreateInfo &info);
+
+        VkDevice device;
+
+        mutable std::mutex mutex;
+        std::unordered_map<Key, std::weak_ptr<ArcSampler>, KeyHash> samplers{};
+        Stats stats{};
+    };
+}
+
+#endif // __ARC_SAMPLER_CACHE_H__
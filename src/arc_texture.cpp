@@ -1,12 +1,20 @@
 
 #include "arc_texture.hpp"
 #include "arc_buffer.hpp"
+#include "arc_ktx2.hpp"
+#include "arc_mip_chain.hpp"
+#include "arc_upload_batch.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
-// stb
+// std
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
 #include <stdexcept>
+#include <vector>
 
 #ifndef ENGINE_DIR
 #define ENGINE_DIR "../"
@@ -14,84 +22,264 @@
 
 namespace arc
 {
+    namespace
+    {
+        constexpr VkFormat TEXTURE_FORMAT = VK_FORMAT_R8G8B8A8_SRGB;
+        // gray images are sRGB encoded like any other image file, nothing tells a gray albedo from a mask
+        constexpr VkFormat GRAY_FORMAT = VK_FORMAT_R8_SRGB;
+        constexpr VkFormat GRAY_ALPHA_FORMAT = VK_FORMAT_R8G8_SRGB;
+        // gray in rgb and alpha in a, so shaders read them as they read an RGBA texture
+        constexpr VkComponentMapping GRAY_SWIZZLE = {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R,
+                                                     VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_ONE};
+        constexpr VkComponentMapping GRAY_ALPHA_SWIZZLE = {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R,
+                                                           VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G};
+        // a blitted mip chain reads and writes every level with a linear filter
+        constexpr VkFormatFeatureFlags MIP_BLIT_FEATURES = VK_FORMAT_FEATURE_BLIT_SRC_BIT |
+                                                           VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                                                           VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    }
+
     ArcTexture::ArcTexture(ArcDevice &arcDevice, const std::string &imagepath)
         : arcDevice{arcDevice}
     {
         arcImage = std::make_unique<ArcImage>(arcDevice);
-        createTextureImage(imagepath);
-        createImageView(VK_FORMAT_R8G8B8A8_SRGB);
+        ArcUploadBatch batch{arcDevice};
+        createTextureImage(imagepath, batch);
+        batch.submit();
+        createTextureSampler();
+        batch.wait();
+    }
+
+    ArcTexture::ArcTexture(ArcDevice &arcDevice, const std::string &imagepath, ArcUploadBatch &batch)
+        : arcDevice{arcDevice}
+    {
+        arcImage = std::make_unique<ArcImage>(arcDevice);
+        createTextureImage(imagepath, batch);
         createTextureSampler();
     }
 
     ArcTexture::~ArcTexture()
     {
         // the order matters
-        vkDestroySampler(arcDevice.device(), textureSampler, nullptr);
         // vkDestroyImageView(arcDevice.device(), textureImageView, nullptr);
         // vkDestroyImage(arcDevice.device(), textureImage, nullptr);
         // vkFreeMemory(arcDevice.device(), textureImageMemory, nullptr);
     }
 
-    void ArcTexture::createTextureImage(const std::string &imagepath)
+    ArcTexture::ArcTexture(ArcDevice &arcDevice)
+        : arcDevice{arcDevice}
     {
-        int texWidth, texHeight, texChannels;
+        arcImage = std::make_unique<ArcImage>(arcDevice);
+    }
+
+    void ArcTexture::createTextureImage(const std::string &imagepath, ArcUploadBatch &batch)
+    {
+        // decoded straight into the batch's staging memory, the batch does the layout transitions around the copy
+        UploadPlan plan = planUpload(imagepath);
+        VkDeviceSize stagingOffset;
+        decode(plan, batch.allocateStaging(plan.stagingSize, stagingOffset));
+        recordUpload(plan, batch, stagingOffset);
+    }
+
+    ArcTexture::UploadPlan ArcTexture::planUpload(const std::string &imagepath)
+    {
+        UploadPlan plan{};
+        plan.imagepath = imagepath;
         std::string enginePath = ENGINE_DIR + imagepath;
-        stbi_uc *pixels = stbi_load(enginePath.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
 
-        if (!pixels)
+        if (std::filesystem::path{imagepath}.extension() == ".ktx2")
+        {
+            plan.ktx = std::make_shared<Ktx2Texture>(readKtx2(enginePath));
+            const Ktx2Texture &ktx = *plan.ktx;
+            plan.width = width = ktx.width;
+            plan.height = height = ktx.height;
+            mipLevels = static_cast<uint32_t>(ktx.levelOffsets.size());
+
+            bool srgb = false;
+            if (!blockFormatOf(ktx.format, plan.blockFormat, srgb))
+            {
+                throw std::runtime_error(imagepath + ": only BC1, BC3 and BC7 KTX2 textures are supported!");
+            }
+            for (uint32_t level = 0; level < mipLevels; ++level)
+            {
+                if (ktx.levelSizes[level] < compressedSize(plan.blockFormat, std::max(ktx.width >> level, 1u),
+                                                           std::max(ktx.height >> level, 1u)))
+                {
+                    throw std::runtime_error(imagepath + ": truncated KTX2 level!");
+                }
+            }
+
+            bool sampleable = arcDevice.supportsTextureCompressionBC() &&
+                              arcDevice.supportsFormatFeatures(ktx.format, VK_IMAGE_TILING_OPTIMAL,
+                                                               VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+                                                                   VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
+            if (sampleable)
+            {
+                imageFormat = ktx.format;
+            }
+            else
+            {
+                std::cout << "Device can't sample " << imagepath << ", decoding it to RGBA8\n";
+                imageFormat = srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+                plan.decodeBlocks = true;
+            }
+            return planLevels(plan, 0);
+        }
+
+        int texWidth, texHeight, texChannels;
+        if (!stbi_info(enginePath.c_str(), &texWidth, &texHeight, &texChannels))
         {
             throw std::runtime_error("failed to load image resource from " + imagepath);
         }
 
-        // mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
+        plan.width = width = static_cast<uint32_t>(texWidth);
+        plan.height = height = static_cast<uint32_t>(texHeight);
+        mipLevels = mipLevelCount(plan.width, plan.height);
+
+        // one and two channel images keep their channel count where the device samples their sRGB format,
+        // RGB has no widely supported 8 bit format
+        constexpr VkFormatFeatureFlags sampledFeatures = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+                                                         VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        if (texChannels == STBI_grey &&
+            arcDevice.supportsFormatFeatures(GRAY_FORMAT, VK_IMAGE_TILING_OPTIMAL, sampledFeatures))
+        {
+            plan.channels = 1;
+            imageFormat = GRAY_FORMAT;
+            components = GRAY_SWIZZLE;
+        }
+        else if (texChannels == STBI_grey_alpha &&
+                 arcDevice.supportsFormatFeatures(GRAY_ALPHA_FORMAT, VK_IMAGE_TILING_OPTIMAL, sampledFeatures))
+        {
+            plan.channels = 2;
+            imageFormat = GRAY_ALPHA_FORMAT;
+            components = GRAY_ALPHA_SWIZZLE;
+        }
+        else
+        {
+            plan.channels = 4;
+            imageFormat = TEXTURE_FORMAT;
+            components = {};
+        }
 
-        VkDeviceSize imageSize = texWidth * texHeight * 4;
-        ArcBuffer stagingBuffer{
-            arcDevice,
-            imageSize,
-            1,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        };
+        if (!arcDevice.supportsFormatFeatures(imageFormat, VK_IMAGE_TILING_OPTIMAL, MIP_BLIT_FEATURES))
+        {
+            return planLevels(plan, 0);
+        }
 
-        stagingBuffer.map();
-        stagingBuffer.writeToBuffer((void *)pixels);
+        // every level is blitted from the one above it in the upload's command buffer
+        plan.blitMips = true;
+        plan.levelOffsets = {0};
+        plan.stagingSize = levelBytes(plan, 0);
+        return plan;
+    }
+
+    ArcTexture::UploadPlan ArcTexture::planLevels(const UploadPlan &plan, uint32_t baseLevel) const
+    {
+        UploadPlan levels = plan;
+        levels.baseLevel = baseLevel;
+        levels.blitMips = false;
+        levels.levelOffsets.clear();
+        levels.stagingSize = 0;
+        for (uint32_t level = baseLevel; level < mipLevels; ++level)
+        {
+            levels.levelOffsets.push_back(levels.stagingSize);
+            levels.stagingSize += levelBytes(plan, level);
+        }
+        return levels;
+    }
+
+    VkDeviceSize ArcTexture::levelBytes(const UploadPlan &plan, uint32_t level) const
+    {
+        if (plan.ktx && !plan.decodeBlocks)
+        {
+            return plan.ktx->levelSizes[level];
+        }
+        uint32_t texelBytes = plan.ktx ? 4 : plan.channels;
+        return static_cast<VkDeviceSize>(std::max(plan.width >> level, 1u)) * std::max(plan.height >> level, 1u) * texelBytes;
+    }
+
+    void ArcTexture::decode(UploadPlan &plan, uint8_t *staging)
+    {
+        if (plan.ktx)
+        {
+            const Ktx2Texture &ktx = *plan.ktx;
+            for (size_t i = 0; i < plan.levelOffsets.size(); ++i)
+            {
+                size_t level = plan.baseLevel + i;
+                const uint8_t *blocks = ktx.data + ktx.levelOffsets[level];
+                if (!plan.decodeBlocks)
+                {
+                    std::memcpy(staging + plan.levelOffsets[i], blocks, ktx.levelSizes[level]);
+                    continue;
+                }
+                std::vector<uint8_t> texels = decompressBlocks(blocks, std::max(ktx.width >> level, 1u),
+                                                               std::max(ktx.height >> level, 1u), plan.blockFormat);
+                std::memcpy(staging + plan.levelOffsets[i], texels.data(), texels.size());
+            }
+            // the mapping isn't needed once the levels are staged
+            plan.ktx.reset();
+            return;
+        }
+
+        int texWidth, texHeight, texChannels;
+        std::string enginePath = ENGINE_DIR + plan.imagepath;
+        stbi_uc *pixels = stbi_load(enginePath.c_str(), &texWidth, &texHeight, &texChannels, static_cast<int>(plan.channels));
+
+        if (!pixels)
+        {
+            throw std::runtime_error("failed to load image resource from " + plan.imagepath);
+        }
+        if (static_cast<uint32_t>(texWidth) != plan.width || static_cast<uint32_t>(texHeight) != plan.height)
+        {
+            stbi_image_free(pixels);
+            throw std::runtime_error(plan.imagepath + " changed while it was loading!");
+        }
+
+        if (plan.blitMips)
+        {
+            std::memcpy(staging, pixels, plan.stagingSize);
+        }
+        else
+        {
+            // the chain is tightly packed like the plan, so the staged levels are its tail
+            std::vector<VkDeviceSize> levelOffsets{};
+            std::vector<uint8_t> chain = buildMipChain(pixels, plan.width, plan.height,
+                                                       plan.baseLevel + static_cast<uint32_t>(plan.levelOffsets.size()),
+                                                       plan.srgb, levelOffsets, plan.channels);
+            std::memcpy(staging, chain.data() + levelOffsets[plan.baseLevel], plan.stagingSize);
+        }
 
         // clean up pixel
         stbi_image_free(pixels);
+    }
+
+    void ArcTexture::recordUpload(const UploadPlan &plan, ArcUploadBatch &batch, VkDeviceSize stagingOffset)
+    {
+        arcImage = recordImage(plan, batch, stagingOffset);
+        residentLevel = plan.baseLevel;
+    }
 
-        // createImage(texWidth, texHeight,
-        //             VK_FORMAT_R8G8B8A8_SRGB,
-        //             VK_IMAGE_TILING_OPTIMAL,
-        //             VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-        //             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        //             textureImage, textureImageMemory);
-        arcImage->createImage(texWidth, texHeight,
-                              VK_FORMAT_R8G8B8A8_SRGB,
-                              1, 1,
-                              VK_IMAGE_TILING_OPTIMAL,
-                              VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-                              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-        // transitionImageLayout(textureImage,
-        //                       VK_FORMAT_R8G8B8A8_SRGB,
-        //                       VK_IMAGE_LAYOUT_UNDEFINED,
-        //                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-        arcImage->transitionImageLayout(VK_FORMAT_R8G8B8A8_SRGB,
-                                        VK_IMAGE_LAYOUT_UNDEFINED,
-                                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-        stagingBuffer.writeToImage(arcImage->getImage(),
-                                   static_cast<uint32_t>(texWidth),
-                                   static_cast<uint32_t>(texHeight));
-
-        // transitionImageLayout(textureImage,
-        //                       VK_FORMAT_R8G8B8A8_SRGB,
-        //                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        //                       VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-        arcImage->transitionImageLayout(VK_FORMAT_R8G8B8A8_SRGB,
-                                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    std::unique_ptr<ArcImage> ArcTexture::recordImage(const UploadPlan &plan, ArcUploadBatch &batch, VkDeviceSize stagingOffset) const
+    {
+        uint32_t imageWidth = std::max(plan.width >> plan.baseLevel, 1u);
+        uint32_t imageHeight = std::max(plan.height >> plan.baseLevel, 1u);
+        uint32_t imageLevels = mipLevels - plan.baseLevel;
+
+        VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        if (plan.blitMips)
+        {
+            usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        }
+        auto image = std::make_unique<ArcImage>(arcDevice);
+        image->createImage(imageWidth, imageHeight,
+                           imageFormat,
+                           imageLevels, 1,
+                           VK_IMAGE_TILING_OPTIMAL,
+                           usage,
+                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        image->createImageView(imageFormat, components);
+        batch.copyImage(image->getImage(), stagingOffset, imageWidth, imageHeight, plan.levelOffsets, imageLevels);
+        return image;
     }
 
     // void ArcTexture::createImage(uint32_t width, uint32_t height, VkFormat format,
@@ -200,29 +388,6 @@ namespace arc
     //     arcDevice.endSingleTimeCommands(commandBuffer);
     // }
 
-    void ArcTexture::createImageView(VkFormat format)
-    {
-        // VkImageViewCreateInfo viewInfo{};
-        // viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-        // viewInfo.image = image;
-        // viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        // viewInfo.format = format;
-        // viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        // viewInfo.subresourceRange.baseMipLevel = 0;
-        // viewInfo.subresourceRange.levelCount = 1;
-        // viewInfo.subresourceRange.baseArrayLayer = 0;
-        // viewInfo.subresourceRange.layerCount = 1;
-
-        arcImage->createImageView(format);
-
-        // VkImageView imageView;
-        // if (vkCreateImageView(arcDevice.device(), &viewInfo, nullptr, &imageView) != VK_SUCCESS)
-        // {
-        //     throw std::runtime_error("failed to create texture image view!");
-        // }
-        // return imageView;
-    }
-
     // void ArcTexture::createTextureImageView()
     // {
     //     textureImageView = createImageView(textureImage, VK_FORMAT_R8G8B8A8_SRGB);
@@ -254,12 +419,10 @@ namespace arc
         samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
         samplerInfo.mipLodBias = 0.f;
         samplerInfo.minLod = 0.f;
-        samplerInfo.maxLod = 0.f;
-        // create sampler
-        if (vkCreateSampler(arcDevice.device(), &samplerInfo, nullptr, &textureSampler) != VK_SUCCESS)
-        {
-            throw std::runtime_error("failed to create texture sampler!");
-        }
+        // the view limits the levels, so textures with different chain lengths can share the sampler
+        samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+        sampler = arcDevice.getSamplerCache().acquire(samplerInfo);
+        textureSampler = sampler->getSampler();
     }
 
     VkDescriptorImageInfo ArcTexture::descriptorInfo()
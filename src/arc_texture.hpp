@@ -1,18 +1,25 @@
 #ifndef __ARC_TEXTURE_H__
 #define __ARC_TEXTURE_H__
 
+#include "arc_block_compression.hpp"
 #include "arc_device.hpp"
 #include "arc_image.hpp"
 // std
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace arc
 {
+    class ArcUploadBatch;
+    struct Ktx2Texture;
+
     class ArcTexture
     {
     public:
         ArcTexture(ArcDevice &arcDevice, const std::string &imagepath);
+        // records the pixel upload into batch, the texture can be sampled once the batch completed
+        ArcTexture(ArcDevice &arcDevice, const std::string &imagepath, ArcUploadBatch &batch);
         ~ArcTexture();
 
         ArcTexture(const ArcTexture &) = delete;
@@ -21,12 +28,56 @@ namespace arc
         VkDescriptorImageInfo descriptorInfo();
 
         VkSampler getSampler() const { return textureSampler; }
+        uint32_t getMipLevels() const { return mipLevels; }
+        uint32_t getResidentLevel() const { return residentLevel; }
+        uint32_t getWidth() const { return width; }
+        uint32_t getHeight() const { return height; }
 
     private:
-        void createTextureImage(const std::string &imagepath);
+        friend class ArcTextureLoader;
+        friend class ArcTextureStreamer;
+
+        // what an upload stages, worked out from the file's header without decoding it
+        struct UploadPlan
+        {
+            std::string imagepath;
+            // size of the full chain's level 0
+            uint32_t width = 0;
+            uint32_t height = 0;
+            // staged levels start at this level of the full chain and run to its end, unless blitMips
+            uint32_t baseLevel = 0;
+            // levels decode() writes, relative to its staging pointer
+            std::vector<VkDeviceSize> levelOffsets{};
+            VkDeviceSize stagingSize = 0;
+            // only level 0 is staged, the rest of the chain is blitted from it
+            bool blitMips = false;
+            // 8 bit channels per texel of a decoded PNG or JPEG
+            uint32_t channels = 4;
+            // color channels are sRGB encoded, alpha never is
+            bool srgb = true;
+            // KTX2 files are read through their mapping, BC levels are decoded to RGBA8 if decodeBlocks is set
+            std::shared_ptr<Ktx2Texture> ktx{};
+            bool decodeBlocks = false;
+            BlockFormat blockFormat = BlockFormat::BC1;
+        };
+
+        // an empty texture ArcTextureLoader or ArcTextureStreamer fills in
+        ArcTexture(ArcDevice &arcDevice);
 
-        // helper function
-        void createImageView(VkFormat format);
+        void createTextureImage(const std::string &imagepath, ArcUploadBatch &batch);
+        // sets mipLevels, imageFormat and components from the header, a KTX2 file's prebuilt chain is decoded to RGBA8
+        // if the device can't sample its BC format
+        UploadPlan planUpload(const std::string &imagepath);
+        // the same source restaged as levels baseLevel to the end of the chain, nothing blitted
+        UploadPlan planLevels(const UploadPlan &plan, uint32_t baseLevel) const;
+        // device memory of one level of the full chain
+        VkDeviceSize levelBytes(const UploadPlan &plan, uint32_t level) const;
+        // writes plan.stagingSize bytes to staging, touches nothing else so it may run on any thread
+        static void decode(UploadPlan &plan, uint8_t *staging);
+        // creates the image and records its upload from the staged bytes at stagingOffset
+        void recordUpload(const UploadPlan &plan, ArcUploadBatch &batch, VkDeviceSize stagingOffset);
+        // a new image holding the plan's levels with its view, the upload recorded into batch, safe on any thread
+        std::unique_ptr<ArcImage> recordImage(const UploadPlan &plan, ArcUploadBatch &batch, VkDeviceSize stagingOffset) const;
 
         // Sampler
         void createTextureSampler();
@@ -38,7 +89,17 @@ namespace arc
         // The sampler is a distinct object that provides an interface to extract colors from a texture
         // It can be applied to any image we want
         VkSampler textureSampler{};
-        uint32_t mipLevels;
+        // shared with every texture sampled the same way, textureSampler is its handle
+        std::shared_ptr<ArcSampler> sampler{};
+        // full chain down to 1x1, or whatever a KTX2 file holds
+        uint32_t mipLevels = 1;
+        // level of the full chain the image starts at, above 0 while a streamed texture's large mips aren't resident
+        uint32_t residentLevel = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        VkFormat imageFormat = VK_FORMAT_R8G8B8A8_SRGB;
+        // gray formats are swizzled so shaders see RGBA
+        VkComponentMapping components{};
     };
 }
 
@@ -0,0 +1,214 @@
+#include "arc_texture_loader.hpp"
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <thread>
+
+namespace arc
+{
+    namespace
+    {
+        // a multiple of every texel and BC block size, as buffer to image copies require
+        constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+        VkDeviceSize alignStaging(VkDeviceSize size)
+        {
+            return (size + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+        }
+
+        double elapsedMilliseconds(std::chrono::high_resolution_clock::time_point startTime)
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        }
+
+        // runs job(i) for i in [begin, end) on up to threadCount threads, the calling thread included
+        template <typename Job>
+        void parallelFor(uint32_t threadCount, size_t begin, size_t end, const Job &job)
+        {
+            std::atomic<size_t> next{begin};
+            auto worker = [&]()
+            {
+                for (size_t i = next++; i < end; i = next++)
+                {
+                    job(i);
+                }
+            };
+
+            size_t count = end - begin;
+            std::vector<std::thread> threads{};
+            for (uint32_t t = 1; t < threadCount && t < count; ++t)
+            {
+                threads.emplace_back(worker);
+            }
+            worker();
+            for (auto &thread : threads)
+            {
+                thread.join();
+            }
+        }
+    }
+
+    ArcTextureLoader::ArcTextureLoader(ArcDevice &device, uint32_t workerThreads, VkDeviceSize ringSize)
+        : arcDevice{device}, workerThreads{workerThreads}
+    {
+        if (this->workerThreads == 0)
+        {
+            this->workerThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        createRing(ringSize);
+    }
+
+    ArcTextureLoader::~ArcTextureLoader()
+    {
+        waitForUploads();
+    }
+
+    void ArcTextureLoader::createRing(VkDeviceSize size)
+    {
+        waitForUploads();
+        halfSize = alignStaging(size / 2);
+        ring = std::make_unique<ArcBuffer>(
+            arcDevice,
+            halfSize * 2,
+            1,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        // stays mapped, workers write into it directly
+        ring->map();
+        nextHalf = 0;
+    }
+
+    void ArcTextureLoader::waitForUploads()
+    {
+        for (auto &upload : uploads)
+        {
+            upload.reset();
+        }
+    }
+
+    std::vector<std::shared_ptr<ArcTexture>> ArcTextureLoader::loadTextures(const std::vector<std::string> &imagepaths)
+    {
+        stats = {};
+        stats.threads = workerThreads;
+        uint64_t samplersCreated = arcDevice.getSamplerCache().getStats().created;
+
+        size_t count = imagepaths.size();
+        std::vector<std::shared_ptr<ArcTexture>> textures(count);
+        std::vector<ArcTexture::UploadPlan> plans(count);
+        std::vector<uint8_t> failed(count, 0);
+
+        // headers first, they size every texture's share of the ring
+        auto decodeStart = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < count; ++i)
+        {
+            textures[i] = std::shared_ptr<ArcTexture>(new ArcTexture(arcDevice));
+        }
+        parallelFor(workerThreads, 0, count, [&](size_t i)
+                    {
+                        try
+                        {
+                            plans[i] = textures[i]->planUpload(imagepaths[i]);
+                        }
+                        catch (const std::exception &e)
+                        {
+                            std::cout << "Failed to load " << imagepaths[i] << ": " << e.what() << '\n';
+                            failed[i] = 1;
+                        } });
+        stats.decodeMilliseconds += elapsedMilliseconds(decodeStart);
+
+        VkDeviceSize largest = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!failed[i])
+            {
+                largest = std::max(largest, alignStaging(plans[i].stagingSize));
+            }
+        }
+        if (largest > halfSize)
+        {
+            createRing(largest * 2);
+        }
+
+        uint8_t *mapped = static_cast<uint8_t *>(ring->getMappedMemory());
+        std::vector<VkDeviceSize> offsets(count, 0);
+        for (size_t groupBegin = 0; groupBegin < count;)
+        {
+            // as many textures as fit in one half of the ring go into one command buffer
+            VkDeviceSize halfOffset = nextHalf * halfSize;
+            VkDeviceSize used = 0;
+            size_t groupEnd = groupBegin;
+            for (; groupEnd < count; ++groupEnd)
+            {
+                if (failed[groupEnd])
+                    continue;
+                VkDeviceSize size = alignStaging(plans[groupEnd].stagingSize);
+                if (used + size > halfSize)
+                    break;
+                offsets[groupEnd] = halfOffset + used;
+                used += size;
+            }
+
+            // the batch that last read from this half has to finish before it's overwritten
+            auto uploadStart = std::chrono::high_resolution_clock::now();
+            uploads[nextHalf].reset();
+            stats.uploadMilliseconds += elapsedMilliseconds(uploadStart);
+
+            decodeStart = std::chrono::high_resolution_clock::now();
+            parallelFor(workerThreads, groupBegin, groupEnd, [&](size_t i)
+                        {
+                            if (failed[i])
+                                return;
+                            try
+                            {
+                                ArcTexture::decode(plans[i], mapped + offsets[i]);
+                            }
+                            catch (const std::exception &e)
+                            {
+                                std::cout << "Failed to load " << imagepaths[i] << ": " << e.what() << '\n';
+                                failed[i] = 1;
+                            } });
+            stats.decodeMilliseconds += elapsedMilliseconds(decodeStart);
+
+            uploadStart = std::chrono::high_resolution_clock::now();
+            auto batch = std::make_unique<ArcUploadBatch>(arcDevice, *ring);
+            for (size_t i = groupBegin; i < groupEnd; ++i)
+            {
+                if (failed[i])
+                    continue;
+                textures[i]->recordUpload(plans[i], *batch, offsets[i]);
+                stats.textures++;
+                stats.stagedBytes += plans[i].stagingSize;
+            }
+            batch->submit();
+            for (size_t i = groupBegin; i < groupEnd; ++i)
+            {
+                if (failed[i])
+                    continue;
+                textures[i]->createTextureSampler();
+            }
+            uploads[nextHalf] = std::move(batch);
+            nextHalf ^= 1;
+            stats.uploadMilliseconds += elapsedMilliseconds(uploadStart);
+
+            groupBegin = groupEnd;
+        }
+
+        auto uploadStart = std::chrono::high_resolution_clock::now();
+        waitForUploads();
+        stats.uploadMilliseconds += elapsedMilliseconds(uploadStart);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (failed[i])
+            {
+                textures[i].reset();
+            }
+        }
+        stats.samplersCreated = arcDevice.getSamplerCache().getStats().created - samplersCreated;
+        return textures;
+    }
+}
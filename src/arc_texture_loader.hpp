@@ -0,0 +1,72 @@
+#ifndef __ARC_TEXTURE_LOADER_H__
+#define __ARC_TEXTURE_LOADER_H__
+
+#include "arc_buffer.hpp"
+#include "arc_device.hpp"
+#include "arc_texture.hpp"
+#include "arc_upload_batch.hpp"
+
+// std
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace arc
+{
+    // Loads many textures at once
+    // files are decoded on worker threads straight into a persistent staging ring, and every texture staged
+    // in one half of the ring is uploaded by a single command buffer, so decoding into one half overlaps the
+    // GPU copying out of the other. Call from the thread that owns the device's command pool.
+    class ArcTextureLoader
+    {
+    public:
+        static constexpr VkDeviceSize DEFAULT_RING_SIZE = 64 * 1024 * 1024;
+
+        struct Stats
+        {
+            uint32_t threads = 0;
+            uint32_t textures = 0;
+            VkDeviceSize stagedBytes = 0;
+            // samplers the textures created rather than shared from the device's cache
+            uint64_t samplersCreated = 0;
+            // wall time spent reading headers and decoding
+            double decodeMilliseconds = 0.0;
+            // wall time spent recording, submitting and waiting on uploads that decoding didn't hide
+            double uploadMilliseconds = 0.0;
+        };
+
+        // workerThreads 0 picks the hardware concurrency, the ring grows if a texture doesn't fit half of it
+        ArcTextureLoader(ArcDevice &device, uint32_t workerThreads = 0, VkDeviceSize ringSize = DEFAULT_RING_SIZE);
+        ~ArcTextureLoader();
+
+        ArcTextureLoader(const ArcTextureLoader &) = delete;
+        ArcTextureLoader &operator=(const ArcTextureLoader &) = delete;
+
+        // paths relative to ENGINE_DIR, one texture per path in the same order, null where a file failed to load
+        // the textures can be sampled once this returns
+        std::vector<std::shared_ptr<ArcTexture>> loadTextures(const std::vector<std::string> &imagepaths);
+
+        // timings of the last loadTextures call
+        const Stats &getStats() const { return stats; }
+        uint32_t getWorkerThreads() const { return workerThreads; }
+
+    private:
+        void createRing(VkDeviceSize size);
+        void waitForUploads();
+
+        ArcDevice &arcDevice;
+        uint32_t workerThreads;
+
+        std::unique_ptr<ArcBuffer> ring{};
+        VkDeviceSize halfSize = 0;
+        // the batch still reading from each half of the ring
+        std::array<std::unique_ptr<ArcUploadBatch>, 2> uploads{};
+        uint32_t nextHalf = 0;
+
+        Stats stats{};
+    };
+}
+
+#endif // __ARC_TEXTURE_LOADER_H__
@@ -0,0 +1,207 @@
+#include "arc_texture_registry.hpp"
+
+// std
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+
+namespace arc
+{
+    ArcTextureRegistry::ArcTextureRegistry(ArcDevice &device, std::shared_ptr<ArcTexture> defaultTexture)
+        : arcDevice{device}
+    {
+        bindless = device.supportsDescriptorIndexing() && device.getMaxBindlessTextures() > FALLBACK_CAPACITY;
+        // an array indexed by a push constant needs dynamic indexing, otherwise each slot gets a set of its own
+        perObject = !device.supportsSampledImageArrayDynamicIndexing();
+        capacity = bindless ? std::min(BINDLESS_CAPACITY, device.getMaxBindlessTextures()) : FALLBACK_CAPACITY;
+        uint32_t arraySize = perObject ? 1 : capacity;
+        setsPerFrame = perObject ? capacity : 1;
+
+        // sets are still rewritten only between their frames, update after bind is there for its
+        // descriptor limits, which are the ones large enough for a bindless array on most devices
+        VkDescriptorBindingFlags bindingFlags = 0;
+        VkDescriptorSetLayoutCreateFlags layoutFlags = 0;
+        VkDescriptorPoolCreateFlags poolFlags = 0;
+        if (bindless)
+        {
+            bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+            layoutFlags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+            poolFlags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        }
+
+        setLayout = ArcDescriptorSetLayout::Builder(arcDevice)
+                        .addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, arraySize, bindingFlags)
+                        .setLayoutFlags(layoutFlags)
+                        .build();
+        uint32_t setCount = setsPerFrame * ArcSwapChain::MAX_FRAMES_IN_FLIGHT;
+        pool = ArcDescriptorPool::Builder(arcDevice)
+                   .setMaxSets(setCount)
+                   .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, arraySize * setCount)
+                   .setPoolFlags(poolFlags)
+                   .build();
+        descriptorSets.resize(setCount);
+        for (auto &set : descriptorSets)
+        {
+            if (!pool->allocateDescriptor(setLayout->getDescriptorSetLayout(), set))
+            {
+                throw std::runtime_error("failed to allocate texture descriptor set!");
+            }
+        }
+
+        specialization.textureCount = arraySize;
+        specialization.perObjectTextures = perObject ? VK_TRUE : VK_FALSE;
+        specializationEntries[0].constantID = TEXTURE_COUNT_CONSTANT_ID;
+        specializationEntries[0].offset = offsetof(Specialization, textureCount);
+        specializationEntries[0].size = sizeof(specialization.textureCount);
+        specializationEntries[1].constantID = PER_OBJECT_TEXTURES_CONSTANT_ID;
+        specializationEntries[1].offset = offsetof(Specialization, perObjectTextures);
+        specializationEntries[1].size = sizeof(specialization.perObjectTextures);
+        specializationInfo.mapEntryCount = static_cast<uint32_t>(specializationEntries.size());
+        specializationInfo.pMapEntries = specializationEntries.data();
+        specializationInfo.dataSize = sizeof(specialization);
+        specializationInfo.pData = &specialization;
+
+        textures.push_back(std::move(defaultTexture));
+        // without partially bound descriptors every element has to be valid before the set is used
+        if (bindless)
+        {
+            markDirty(0);
+        }
+        else
+        {
+            textures.resize(capacity);
+            for (uint32_t index = capacity - 1; index > 0; --index)
+            {
+                freeSlots.push_back(index);
+            }
+            refresh();
+        }
+
+        std::cout << "Texture registry: " << capacity << " slots, "
+                  << (bindless ? "bindless" : perObject ? "bound per object" : "fallback") << '\n';
+    }
+
+    uint32_t ArcTextureRegistry::add(std::shared_ptr<ArcTexture> texture)
+    {
+        uint32_t index;
+        if (!freeSlots.empty())
+        {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else if (textures.size() < capacity)
+        {
+            index = static_cast<uint32_t>(textures.size());
+            textures.emplace_back();
+        }
+        else
+        {
+            throw std::runtime_error("texture registry is full!");
+        }
+
+        textures[index] = std::move(texture);
+        markDirty(index);
+        return index;
+    }
+
+    void ArcTextureRegistry::replace(uint32_t index, std::shared_ptr<ArcTexture> texture)
+    {
+        if (index >= textures.size() || textures[index] == nullptr)
+        {
+            throw std::runtime_error("replacing a texture that isn't registered!");
+        }
+
+        // a frame submitted so far may still sample the previous texture
+        retired.push_back({std::move(textures[index]), frame + ArcSwapChain::MAX_FRAMES_IN_FLIGHT});
+        textures[index] = std::move(texture);
+        markDirty(index);
+    }
+
+    void ArcTextureRegistry::remove(uint32_t index)
+    {
+        if (index == 0 || index >= textures.size() || textures[index] == nullptr)
+        {
+            throw std::runtime_error("removing a texture that isn't registered!");
+        }
+
+        retired.push_back({std::move(textures[index]), frame + ArcSwapChain::MAX_FRAMES_IN_FLIGHT});
+        textures[index] = nullptr;
+        freeSlots.push_back(index);
+        markDirty(index);
+    }
+
+    void ArcTextureRegistry::refresh()
+    {
+        for (uint32_t index = 0; index < textures.size(); ++index)
+        {
+            // free slots of a bindless array are never sampled
+            if (textures[index] != nullptr || !bindless)
+            {
+                markDirty(index);
+            }
+        }
+    }
+
+    void ArcTextureRegistry::markDirty(uint32_t index)
+    {
+        for (auto &slots : dirtySlots)
+        {
+            slots.push_back(index);
+        }
+    }
+
+    void ArcTextureRegistry::update(int frameIndex)
+    {
+        // the set of this frame was the last one that could reference a texture retired MAX_FRAMES_IN_FLIGHT frames ago
+        frame++;
+        while (!retired.empty() && retired.front().releaseFrame <= frame)
+        {
+            retired.pop_front();
+        }
+
+        auto &slots = dirtySlots[frameIndex];
+        if (slots.empty())
+            return;
+
+        std::sort(slots.begin(), slots.end());
+        slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+
+        // the writer keeps pointers to the infos until overwrite, so they're all gathered first
+        std::vector<VkDescriptorImageInfo> imageInfos{};
+        imageInfos.reserve(slots.size());
+        for (uint32_t index : slots)
+        {
+            auto &texture = textures[index] != nullptr ? textures[index] : textures[0];
+            imageInfos.push_back(texture->descriptorInfo());
+        }
+
+        if (perObject)
+        {
+            // each slot is element 0 of its own set
+            for (size_t i = 0; i < slots.size(); ++i)
+            {
+                ArcDescriptorWriter(*setLayout, *pool)
+                    .writeImage(0, &imageInfos[i])
+                    .overwrite(descriptorSets[frameIndex * setsPerFrame + slots[i]]);
+            }
+            slots.clear();
+            return;
+        }
+
+        // consecutive slots go into one write
+        ArcDescriptorWriter writer{*setLayout, *pool};
+        for (size_t first = 0; first < slots.size();)
+        {
+            size_t last = first + 1;
+            while (last < slots.size() && slots[last] == slots[last - 1] + 1)
+            {
+                ++last;
+            }
+            writer.writeImages(0, slots[first], static_cast<uint32_t>(last - first), &imageInfos[first]);
+            first = last;
+        }
+        writer.overwrite(descriptorSets[frameIndex * setsPerFrame]);
+        slots.clear();
+    }
+}
@@ -0,0 +1,114 @@
+#ifndef __ARC_TEXTURE_REGISTRY_H__
+#define __ARC_TEXTURE_REGISTRY_H__
+
+#include "arc_descriptors.hpp"
+#include "arc_device.hpp"
+#include "arc_swap_chain.hpp"
+#include "arc_texture.hpp"
+
+// std
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace arc
+{
+    // Gives every texture a stable index into one sampler2D array, so a frame binds its textures once
+    // and objects pick theirs with ArcGameObject::textureIndex. With descriptor indexing the array is
+    // partially bound and updated after bind, holding up to BINDLESS_CAPACITY textures, without it the
+    // array holds FALLBACK_CAPACITY and every free slot shows the default texture. Devices that can't
+    // index sampler arrays dynamically get one single texture set per slot instead, bound per object.
+    // Each frame in flight has its own sets, a change is written into them at the start of that frame,
+    // and removed textures are kept alive until no frame in flight can sample them anymore.
+    //
+    // shaders declare the array as
+    //      layout (constant_id = 8) const int TEXTURE_COUNT = 1;
+    //      layout (constant_id = 9) const bool PER_OBJECT_TEXTURES = false;
+    //      layout (set = 1, binding = 0) uniform sampler2D textures[TEXTURE_COUNT];
+    // sample textures[0] when PER_OBJECT_TEXTURES is set, and get both from getSpecializationInfo()
+    class ArcTextureRegistry
+    {
+    public:
+        static constexpr uint32_t BINDLESS_CAPACITY = 4096;
+        // the least maxPerStageDescriptorSamplers every device supports
+        static constexpr uint32_t FALLBACK_CAPACITY = 16;
+        static constexpr uint32_t TEXTURE_COUNT_CONSTANT_ID = 8;
+        static constexpr uint32_t PER_OBJECT_TEXTURES_CONSTANT_ID = 9;
+
+        // the default texture takes index 0
+        ArcTextureRegistry(ArcDevice &device, std::shared_ptr<ArcTexture> defaultTexture);
+
+        ArcTextureRegistry(const ArcTextureRegistry &) = delete;
+        ArcTextureRegistry &operator=(const ArcTextureRegistry &) = delete;
+
+        // throws once every slot is taken
+        uint32_t add(std::shared_ptr<ArcTexture> texture);
+        // points index at another texture, e.g. a reloaded one
+        void replace(uint32_t index, std::shared_ptr<ArcTexture> texture);
+        // index shows the default texture until it is handed out again
+        void remove(uint32_t index);
+        // rewrites every slot, call when the textures' image views changed, see ArcTextureStreamer::update
+        void refresh();
+
+        // call once per frame after beginFrame, before the frame's set is bound
+        void update(int frameIndex);
+
+        // the set holding index, the same set for every index unless bindsPerObject()
+        VkDescriptorSet getDescriptorSet(int frameIndex, uint32_t index = 0) const
+        {
+            return descriptorSets[frameIndex * setsPerFrame + (perObject ? index : 0)];
+        }
+        VkDescriptorSetLayout getDescriptorSetLayout() const { return setLayout->getDescriptorSetLayout(); }
+        // specializes TEXTURE_COUNT and PER_OBJECT_TEXTURES, pass it to the fragment stage of pipelines sampling the array
+        const VkSpecializationInfo &getSpecializationInfo() const { return specializationInfo; }
+        // how many textures may be registered at once
+        uint32_t getCapacity() const { return capacity; }
+        // elements of the sampler array, 1 when bound per object
+        uint32_t getArraySize() const { return specialization.textureCount; }
+        bool isBindless() const { return bindless; }
+        // without dynamic indexing the set has to be rebound for each object's texture
+        bool bindsPerObject() const { return perObject; }
+
+    private:
+        struct Retired
+        {
+            std::shared_ptr<ArcTexture> texture;
+            uint64_t releaseFrame;
+        };
+
+        void markDirty(uint32_t index);
+
+        struct Specialization
+        {
+            uint32_t textureCount;
+            VkBool32 perObjectTextures;
+        };
+
+        ArcDevice &arcDevice;
+        bool bindless;
+        bool perObject;
+        uint32_t capacity;
+
+        std::unique_ptr<ArcDescriptorSetLayout> setLayout;
+        std::unique_ptr<ArcDescriptorPool> pool;
+        // setsPerFrame sets for each frame in flight, one per slot when bound per object
+        uint32_t setsPerFrame;
+        std::vector<VkDescriptorSet> descriptorSets{};
+
+        Specialization specialization{};
+        std::array<VkSpecializationMapEntry, 2> specializationEntries{};
+        VkSpecializationInfo specializationInfo{};
+
+        // slot 0 is the default texture, free slots are null
+        std::vector<std::shared_ptr<ArcTexture>> textures{};
+        std::vector<uint32_t> freeSlots{};
+        // slots each frame's set still has to rewrite
+        std::array<std::vector<uint32_t>, ArcSwapChain::MAX_FRAMES_IN_FLIGHT> dirtySlots{};
+        std::deque<Retired> retired{};
+        uint64_t frame = 0;
+    };
+}
+
+#endif // __ARC_TEXTURE_REGISTRY_H__
@@ -0,0 +1,311 @@
+#include "arc_texture_streamer.hpp"
+#include "arc_swap_chain.hpp"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace arc
+{
+    ArcTextureStreamer::ArcTextureStreamer(ArcDevice &device, VkDeviceSize budget)
+        : arcDevice{device}, budget{budget}
+    {
+        streamThread = std::thread{&ArcTextureStreamer::streamLoop, this};
+    }
+
+    ArcTextureStreamer::~ArcTextureStreamer()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            stopping = true;
+            jobQueue.clear();
+        }
+        workAvailable.notify_all();
+        streamThread.join();
+    }
+
+    struct ArcTextureStreamer::PendingLoad
+    {
+        std::shared_ptr<ArcTexture> texture;
+        Streamed streamed;
+        std::unique_ptr<ArcUploadBatch> batch;
+    };
+
+    std::shared_ptr<ArcTexture> ArcTextureStreamer::load(const std::string &imagepath)
+    {
+        // the tail is small enough to wait for, the texture can be drawn as soon as this returns
+        auto pending = prepareLoad(imagepath);
+        pending->batch->submit();
+        pending->batch->wait();
+        return finishLoad(*pending);
+    }
+
+    std::shared_ptr<ArcTextureStreamer::PendingLoad> ArcTextureStreamer::prepareLoad(const std::string &imagepath)
+    {
+        auto texture = std::shared_ptr<ArcTexture>(new ArcTexture(arcDevice));
+        Streamed streamed{};
+        streamed.texture = texture;
+        streamed.source = texture->planUpload(imagepath);
+
+        uint32_t mipLevels = texture->getMipLevels();
+        streamed.residentSizes.assign(mipLevels + 1, 0);
+        for (uint32_t level = mipLevels; level-- > 0;)
+        {
+            streamed.residentSizes[level] = streamed.residentSizes[level + 1] + texture->levelBytes(streamed.source, level);
+        }
+        while (streamed.tailLevel + 1 < mipLevels &&
+               std::max(texture->getWidth() >> streamed.tailLevel, texture->getHeight() >> streamed.tailLevel) > TAIL_SIZE)
+        {
+            streamed.tailLevel++;
+        }
+        streamed.targetLevel = streamed.tailLevel;
+        streamed.requestedLevel = streamed.tailLevel;
+
+        ArcTexture::UploadPlan tail = texture->planLevels(streamed.source, streamed.tailLevel);
+        auto batch = std::make_unique<ArcUploadBatch>(arcDevice);
+        VkDeviceSize stagingOffset;
+        ArcTexture::decode(tail, batch->allocateStaging(tail.stagingSize, stagingOffset));
+        texture->recordUpload(tail, *batch, stagingOffset);
+        texture->createTextureSampler();
+
+        return std::make_shared<PendingLoad>(PendingLoad{std::move(texture), std::move(streamed), std::move(batch)});
+    }
+
+    std::shared_ptr<ArcTexture> ArcTextureStreamer::finishLoad(PendingLoad &pending)
+    {
+        // the batch is recorded and submitted on the render thread
+        if (!pending.batch->isSubmitted())
+            pending.batch->submit();
+        if (!pending.batch->isComplete())
+            return nullptr;
+
+        releaseExpired();
+        pending.streamed.lastRequested = frame;
+        residentBytes += pending.streamed.residentSizes[pending.streamed.tailLevel];
+        textures[pending.texture.get()] = std::move(pending.streamed);
+        return pending.texture;
+    }
+
+    void ArcTextureStreamer::request(const ArcTexture &texture, float pixels)
+    {
+        auto found = textures.find(&texture);
+        if (found == textures.end())
+            return;
+        Streamed &streamed = found->second;
+
+        // the first level with at least as many texels as the texture covers pixels
+        uint32_t level = streamed.tailLevel;
+        if (pixels > 0.0f)
+        {
+            float ratio = std::max(texture.getWidth(), texture.getHeight()) / pixels;
+            level = ratio <= 1.0f ? 0 : std::min(static_cast<uint32_t>(std::floor(std::log2(ratio))), streamed.tailLevel);
+        }
+
+        if (streamed.lastRequested != frame)
+        {
+            streamed.requestedLevel = level;
+            streamed.lastRequested = frame;
+        }
+        else
+        {
+            streamed.requestedLevel = std::min(streamed.requestedLevel, level);
+        }
+    }
+
+    void ArcTextureStreamer::releaseExpired()
+    {
+        // a texture with a change in flight is kept alive by its job
+        for (auto it = textures.begin(); it != textures.end();)
+        {
+            if (!it->second.busy && it->second.texture.expired())
+            {
+                residentBytes -= it->second.residentSizes[it->second.targetLevel];
+                it = textures.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    bool ArcTextureStreamer::update()
+    {
+        frame++;
+        while (!retired.empty() && retired.front().releaseFrame <= frame)
+        {
+            retired.pop_front();
+        }
+        releaseExpired();
+
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            for (auto &job : readyJobs)
+            {
+                activeJobs.push_back(std::move(job));
+            }
+            readyJobs.clear();
+        }
+
+        bool changed = false;
+        for (auto it = activeJobs.begin(); it != activeJobs.end();)
+        {
+            Job &job = **it;
+            Streamed &streamed = textures.at(job.key);
+            if (job.failed)
+            {
+                // residency stays where it was
+                uint32_t residentLevel = job.texture->getResidentLevel();
+                residentBytes = residentBytes - streamed.residentSizes[streamed.targetLevel] + streamed.residentSizes[residentLevel];
+                streamed.targetLevel = residentLevel;
+            }
+            else
+            {
+                // the batch is recorded and submitted on the render thread
+                if (!job.batch->isSubmitted())
+                    job.batch->submit();
+                if (!job.batch->isComplete())
+                {
+                    ++it;
+                    continue;
+                }
+
+                // frames recorded so far may still sample the old image
+                retired.push_back({std::move(job.texture->arcImage), frame + ArcSwapChain::MAX_FRAMES_IN_FLIGHT});
+                job.texture->arcImage = std::move(job.image);
+                job.texture->residentLevel = job.plan.baseLevel;
+                changed = true;
+            }
+            streamed.busy = false;
+            jobsInFlight--;
+            it = activeJobs.erase(it);
+        }
+
+        // requests of the frame recorded since the last update, larger shortfalls first
+        std::vector<std::pair<const ArcTexture *, uint32_t>> promotions{};
+        for (auto &kv : textures)
+        {
+            Streamed &streamed = kv.second;
+            bool requested = streamed.lastRequested + 1 == frame;
+            if (!streamed.busy && requested && streamed.requestedLevel < streamed.targetLevel)
+            {
+                promotions.emplace_back(kv.first, streamed.requestedLevel);
+            }
+        }
+        std::sort(promotions.begin(), promotions.end(), [&](const auto &a, const auto &b)
+                  { return textures.at(a.first).targetLevel - a.second > textures.at(b.first).targetLevel - b.second; });
+
+        for (const auto &promotion : promotions)
+        {
+            if (jobsInFlight >= MAX_JOBS_IN_FLIGHT)
+                break;
+            Streamed &streamed = textures.at(promotion.first);
+            auto texture = streamed.texture.lock();
+            if (!texture)
+                continue;
+
+            uint32_t level = promotion.second;
+            VkDeviceSize growth = streamed.residentSizes[level] - streamed.residentSizes[streamed.targetLevel];
+            if (residentBytes + growth > budget)
+            {
+                evict(residentBytes + growth - budget);
+            }
+            // as much of the request as the budget allows
+            while (level < streamed.targetLevel &&
+                   residentBytes + streamed.residentSizes[level] - streamed.residentSizes[streamed.targetLevel] > budget)
+            {
+                level++;
+            }
+            if (level < streamed.targetLevel && jobsInFlight < MAX_JOBS_IN_FLIGHT)
+            {
+                schedule(streamed, texture, level);
+            }
+        }
+        return changed;
+    }
+
+    void ArcTextureStreamer::evict(VkDeviceSize bytes)
+    {
+        // textures not requested for a while drop to their tail, least recently requested first
+        std::vector<Streamed *> candidates{};
+        for (auto &kv : textures)
+        {
+            Streamed &streamed = kv.second;
+            if (!streamed.busy && streamed.targetLevel < streamed.tailLevel &&
+                frame - streamed.lastRequested > EVICT_AFTER_FRAMES)
+            {
+                candidates.push_back(&streamed);
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Streamed *a, const Streamed *b)
+                  { return a->lastRequested < b->lastRequested; });
+
+        VkDeviceSize freed = 0;
+        for (Streamed *streamed : candidates)
+        {
+            if (freed >= bytes || jobsInFlight >= MAX_JOBS_IN_FLIGHT)
+                break;
+            auto texture = streamed->texture.lock();
+            if (!texture)
+                continue;
+            freed += streamed->residentSizes[streamed->targetLevel] - streamed->residentSizes[streamed->tailLevel];
+            schedule(*streamed, texture, streamed->tailLevel);
+        }
+    }
+
+    void ArcTextureStreamer::schedule(Streamed &streamed, const std::shared_ptr<ArcTexture> &texture, uint32_t level)
+    {
+        // the budget counts a change as done from the moment it's scheduled
+        residentBytes = residentBytes - streamed.residentSizes[streamed.targetLevel] + streamed.residentSizes[level];
+        streamed.targetLevel = level;
+        streamed.busy = true;
+        jobsInFlight++;
+
+        auto job = std::make_unique<Job>();
+        job->key = texture.get();
+        job->texture = texture;
+        job->plan = texture->planLevels(streamed.source, level);
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            jobQueue.push_back(std::move(job));
+        }
+        workAvailable.notify_one();
+    }
+
+    void ArcTextureStreamer::streamLoop()
+    {
+        while (true)
+        {
+            std::unique_ptr<Job> job{};
+            {
+                std::unique_lock<std::mutex> lock{mutex};
+                workAvailable.wait(lock, [&]()
+                                   { return stopping || !jobQueue.empty(); });
+                if (stopping)
+                    return;
+
+                job = std::move(jobQueue.front());
+                jobQueue.pop_front();
+            }
+
+            // decoded straight into the batch's staging memory, the image is only swapped in once its upload completed
+            try
+            {
+                job->batch = std::make_unique<ArcUploadBatch>(arcDevice);
+                VkDeviceSize stagingOffset;
+                ArcTexture::decode(job->plan, job->batch->allocateStaging(job->plan.stagingSize, stagingOffset));
+                job->image = job->texture->recordImage(job->plan, *job->batch, stagingOffset);
+            }
+            catch (const std::exception &e)
+            {
+                std::cout << "Failed to stream " << job->plan.imagepath << ": " << e.what() << '\n';
+                job->failed = true;
+            }
+
+            std::lock_guard<std::mutex> lock{mutex};
+            readyJobs.push_back(std::move(job));
+        }
+    }
+}
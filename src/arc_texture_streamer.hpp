@@ -0,0 +1,126 @@
+#ifndef __ARC_TEXTURE_STREAMER_H__
+#define __ARC_TEXTURE_STREAMER_H__
+
+#include "arc_device.hpp"
+#include "arc_image.hpp"
+#include "arc_texture.hpp"
+#include "arc_upload_batch.hpp"
+
+// std
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace arc
+{
+    // Keeps the mips of streamed textures resident as far as they are visible, within a device memory budget
+    // a texture loads with only its small mips, so it can be drawn right away. Its larger mips follow on a
+    // background thread once request() reports it large enough on screen, and textures that weren't requested
+    // for a while drop back to their small mips when the budget runs out. Changing residency builds a new
+    // image holding the new range of levels and swaps it in once its upload completed, so descriptors
+    // referencing a streamed texture have to be rewritten whenever update() returns true.
+    class ArcTextureStreamer
+    {
+    public:
+        // mips up to this size always stay resident
+        static constexpr uint32_t TAIL_SIZE = 64;
+        // frames without a request after which a texture's large mips may be evicted
+        static constexpr uint64_t EVICT_AFTER_FRAMES = 120;
+        // residency changes being prepared or uploaded at once
+        static constexpr size_t MAX_JOBS_IN_FLIGHT = 4;
+
+        // budget covers the resident mips of every streamed texture, a change in flight briefly holds both images
+        ArcTextureStreamer(ArcDevice &device, VkDeviceSize budget);
+        ~ArcTextureStreamer();
+
+        ArcTextureStreamer(const ArcTextureStreamer &) = delete;
+        ArcTextureStreamer &operator=(const ArcTextureStreamer &) = delete;
+
+        // a texture whose mip tail is decoded and staged, waiting for its upload
+        struct PendingLoad;
+
+        // imagepath relative to ENGINE_DIR, uploads the mip tail and waits for it
+        std::shared_ptr<ArcTexture> load(const std::string &imagepath);
+        // the decoding part of load(), safe on any thread, throws like load()
+        std::shared_ptr<PendingLoad> prepareLoad(const std::string &imagepath);
+        // on the render thread, submits the tail's upload and returns the texture once it completed, null before
+        std::shared_ptr<ArcTexture> finishLoad(PendingLoad &pending);
+
+        // the texture covers about pixels screen pixels along its larger side in the frame being recorded
+        void request(const ArcTexture &texture, float pixels);
+
+        // call once per frame on the render thread, before writing descriptors
+        // true when a texture's image changed, and with it its descriptorInfo()
+        bool update();
+
+        VkDeviceSize getResidentBytes() const { return residentBytes; }
+        VkDeviceSize getBudget() const { return budget; }
+
+    private:
+        struct Streamed
+        {
+            std::weak_ptr<ArcTexture> texture;
+            // the whole chain of the source, restaged for every residency change
+            ArcTexture::UploadPlan source;
+            // bytes of every level from that level to the end of the chain
+            std::vector<VkDeviceSize> residentSizes{};
+            uint32_t tailLevel = 0;
+            // level the image will start at once the change in flight completed
+            uint32_t targetLevel = 0;
+            // most detailed level requested in the current frame
+            uint32_t requestedLevel = 0;
+            uint64_t lastRequested = 0;
+            bool busy = false;
+        };
+
+        struct Job
+        {
+            const ArcTexture *key;
+            std::shared_ptr<ArcTexture> texture;
+            ArcTexture::UploadPlan plan;
+            // filled in on the streaming thread
+            std::unique_ptr<ArcUploadBatch> batch{};
+            std::unique_ptr<ArcImage> image{};
+            bool failed = false;
+        };
+
+        struct Retired
+        {
+            std::unique_ptr<ArcImage> image;
+            uint64_t releaseFrame;
+        };
+
+        void releaseExpired();
+        // schedules textures not requested for a while down to their tail until bytes are freed
+        void evict(VkDeviceSize bytes);
+        void schedule(Streamed &streamed, const std::shared_ptr<ArcTexture> &texture, uint32_t level);
+        void streamLoop();
+
+        ArcDevice &arcDevice;
+        VkDeviceSize budget;
+
+        // render thread only
+        std::unordered_map<const ArcTexture *, Streamed> textures{};
+        std::vector<std::unique_ptr<Job>> activeJobs{};
+        std::deque<Retired> retired{};
+        VkDeviceSize residentBytes = 0;
+        uint64_t frame = 0;
+        size_t jobsInFlight = 0;
+
+        std::thread streamThread;
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        bool stopping = false;
+        // guarded by mutex
+        std::deque<std::unique_ptr<Job>> jobQueue{};
+        std::vector<std::unique_ptr<Job>> readyJobs{};
+    };
+}
+
+#endif // __ARC_TEXTURE_STREAMER_H__
@@ -0,0 +1,335 @@
+#include "arc_upload_batch.hpp"
+
+// std
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace arc
+{
+    namespace
+    {
+        // satisfies the offset rules of buffer copies and of every uncompressed texel size
+        constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+        // staging chunks double from the first size up to the last, an allocation larger than that gets a chunk to itself
+        constexpr VkDeviceSize MIN_STAGING_CHUNK = 1024 * 1024;
+        constexpr VkDeviceSize MAX_STAGING_CHUNK = 64 * 1024 * 1024;
+
+        VkImageMemoryBarrier imageBarrier(VkImage image, uint32_t baseMipLevel, uint32_t levelCount,
+                                          VkImageLayout oldLayout, VkImageLayout newLayout,
+                                          VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask)
+        {
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.oldLayout = oldLayout;
+            barrier.newLayout = newLayout;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = image;
+            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            barrier.subresourceRange.baseMipLevel = baseMipLevel;
+            barrier.subresourceRange.levelCount = levelCount;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount = 1;
+            barrier.srcAccessMask = srcAccessMask;
+            barrier.dstAccessMask = dstAccessMask;
+            return barrier;
+        }
+
+        int32_t mipExtent(uint32_t extent, uint32_t level)
+        {
+            return static_cast<int32_t>(std::max(extent >> level, 1u));
+        }
+    }
+
+    ArcUploadBatch::ArcUploadBatch(ArcDevice &device)
+        : arcDevice{device}
+    {
+    }
+
+    ArcUploadBatch::ArcUploadBatch(ArcDevice &device, ArcBuffer &staging)
+        : arcDevice{device}, externalStaging{&staging}
+    {
+    }
+
+    ArcUploadBatch::~ArcUploadBatch()
+    {
+        if (fence != VK_NULL_HANDLE)
+        {
+            vkWaitForFences(arcDevice.device(), 1, &fence, VK_TRUE, UINT64_MAX);
+            vkDestroyFence(arcDevice.device(), fence, nullptr);
+        }
+        if (commandBuffer != VK_NULL_HANDLE)
+        {
+            VkCommandPool commandPool = arcDevice.getCommandPool();
+            vkFreeCommandBuffers(arcDevice.device(), commandPool, 1, &commandBuffer);
+        }
+    }
+
+    VkDeviceSize ArcUploadBatch::stage(const void *data, VkDeviceSize size)
+    {
+        VkDeviceSize offset;
+        std::memcpy(allocateStaging(size, offset), data, size);
+        return offset;
+    }
+
+    uint8_t *ArcUploadBatch::allocateStaging(VkDeviceSize size, VkDeviceSize &offset)
+    {
+        if (submitted)
+        {
+            throw std::runtime_error("upload batch was already submitted!");
+        }
+        if (externalStaging != nullptr)
+        {
+            throw std::runtime_error("upload batch reads from an external staging buffer!");
+        }
+
+        offset = (stagingBytes + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+        if (stagingChunks.empty() ||
+            offset + size > stagingChunks.back().base + stagingChunks.back().buffer->getBufferSize())
+        {
+            // the rest of the current chunk stays unused, the new one starts at this allocation
+            VkDeviceSize chunkSize = std::min(MIN_STAGING_CHUNK << std::min<size_t>(stagingChunks.size(), 6), MAX_STAGING_CHUNK);
+            auto buffer = std::make_unique<ArcBuffer>(
+                arcDevice,
+                std::max(size, chunkSize),
+                1,
+                VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+            if (buffer->map() != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to map upload staging buffer!");
+            }
+            stagingChunks.push_back({offset, std::move(buffer)});
+        }
+        stagingBytes = offset + size;
+
+        const StagingChunk &chunk = stagingChunks.back();
+        return static_cast<uint8_t *>(chunk.buffer->getMappedMemory()) + (offset - chunk.base);
+    }
+
+    VkBuffer ArcUploadBatch::stagingBufferAt(VkDeviceSize &stagingOffset) const
+    {
+        if (externalStaging != nullptr)
+        {
+            return externalStaging->getBuffer();
+        }
+
+        // the last chunk starting at or before the offset
+        auto chunk = std::upper_bound(stagingChunks.begin(), stagingChunks.end(), stagingOffset,
+                                      [](VkDeviceSize offset, const StagingChunk &chunk)
+                                      { return offset < chunk.base; });
+        --chunk;
+        stagingOffset -= chunk->base;
+        return chunk->buffer->getBuffer();
+    }
+
+    void ArcUploadBatch::uploadBuffer(VkBuffer buffer, const void *data, VkDeviceSize size, VkDeviceSize bufferOffset)
+    {
+        if (size == 0)
+            return;
+        bufferCopies.push_back({buffer, stage(data, size), bufferOffset, size});
+    }
+
+    void ArcUploadBatch::uploadImage(VkImage image, const void *pixels, VkDeviceSize size, uint32_t width, uint32_t height,
+                                     uint32_t mipLevels)
+    {
+        imageCopies.push_back({image, stage(pixels, size), width, height, std::max(mipLevels, 1u), {0}});
+    }
+
+    void ArcUploadBatch::uploadImageLevels(VkImage image, const void *pixels, VkDeviceSize size, uint32_t width, uint32_t height,
+                                           const std::vector<VkDeviceSize> &levelOffsets)
+    {
+        if (levelOffsets.empty())
+        {
+            throw std::runtime_error("image upload without mip levels!");
+        }
+        imageCopies.push_back({image, stage(pixels, size), width, height,
+                               static_cast<uint32_t>(levelOffsets.size()), levelOffsets});
+    }
+
+    void ArcUploadBatch::copyImage(VkImage image, VkDeviceSize stagingOffset, uint32_t width, uint32_t height,
+                                   const std::vector<VkDeviceSize> &levelOffsets, uint32_t mipLevels)
+    {
+        if (submitted)
+        {
+            throw std::runtime_error("upload batch was already submitted!");
+        }
+        if (levelOffsets.empty())
+        {
+            throw std::runtime_error("image upload without mip levels!");
+        }
+        imageCopies.push_back({image, stagingOffset, width, height,
+                               std::max(mipLevels, static_cast<uint32_t>(levelOffsets.size())), levelOffsets});
+    }
+
+    void ArcUploadBatch::submit()
+    {
+        if (submitted)
+            return;
+        submitted = true;
+        if (empty())
+            return;
+
+        commandBuffer = arcDevice.beginSingleTimeCommands();
+
+        // images become transfer destinations before any copy runs
+        std::vector<VkImageMemoryBarrier> imageBarriers{};
+        for (const auto &copy : imageCopies)
+        {
+            imageBarriers.push_back(imageBarrier(copy.image, 0, copy.mipLevels,
+                                                 VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                 0, VK_ACCESS_TRANSFER_WRITE_BIT));
+        }
+        if (!imageBarriers.empty())
+        {
+            vkCmdPipelineBarrier(commandBuffer,
+                                 VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 0,
+                                 0, nullptr,
+                                 0, nullptr,
+                                 static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+        }
+
+        for (const auto &copy : bufferCopies)
+        {
+            VkBufferCopy copyRegion{};
+            copyRegion.srcOffset = copy.stagingOffset;
+            VkBuffer staging = stagingBufferAt(copyRegion.srcOffset);
+            copyRegion.dstOffset = copy.bufferOffset;
+            copyRegion.size = copy.size;
+            vkCmdCopyBuffer(commandBuffer, staging, copy.buffer, 1, &copyRegion);
+        }
+
+        for (const auto &copy : imageCopies)
+        {
+            // every level of an image was staged by one allocation
+            VkDeviceSize stagingOffset = copy.stagingOffset;
+            VkBuffer staging = stagingBufferAt(stagingOffset);
+            std::vector<VkBufferImageCopy> regions(copy.levelOffsets.size());
+            for (uint32_t level = 0; level < regions.size(); ++level)
+            {
+                VkBufferImageCopy &region = regions[level];
+                region.bufferOffset = stagingOffset + copy.levelOffsets[level];
+                region.bufferRowLength = 0;
+                region.bufferImageHeight = 0;
+                region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                region.imageSubresource.mipLevel = level;
+                region.imageSubresource.baseArrayLayer = 0;
+                region.imageSubresource.layerCount = 1;
+                region.imageOffset = {0, 0, 0};
+                region.imageExtent = {static_cast<uint32_t>(mipExtent(copy.width, level)),
+                                      static_cast<uint32_t>(mipExtent(copy.height, level)), 1};
+            }
+            vkCmdCopyBufferToImage(commandBuffer,
+                                   staging,
+                                   copy.image,
+                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                   static_cast<uint32_t>(regions.size()),
+                                   regions.data());
+        }
+
+        // the rest of each mip chain, every level filtered down from the one above it
+        imageBarriers.clear();
+        for (const auto &copy : imageCopies)
+        {
+            uint32_t copiedLevels = static_cast<uint32_t>(copy.levelOffsets.size());
+            if (copiedLevels >= copy.mipLevels)
+            {
+                imageBarriers.push_back(imageBarrier(copy.image, 0, copy.mipLevels,
+                                                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                                     VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT));
+                continue;
+            }
+
+            for (uint32_t level = copiedLevels; level < copy.mipLevels; ++level)
+            {
+                VkImageMemoryBarrier source = imageBarrier(copy.image, level - 1, 1,
+                                                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                                           VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+                vkCmdPipelineBarrier(commandBuffer,
+                                     VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                     0,
+                                     0, nullptr,
+                                     0, nullptr,
+                                     1, &source);
+
+                VkImageBlit blit{};
+                blit.srcOffsets[1] = {mipExtent(copy.width, level - 1), mipExtent(copy.height, level - 1), 1};
+                blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                blit.srcSubresource.mipLevel = level - 1;
+                blit.srcSubresource.baseArrayLayer = 0;
+                blit.srcSubresource.layerCount = 1;
+                blit.dstOffsets[1] = {mipExtent(copy.width, level), mipExtent(copy.height, level), 1};
+                blit.dstSubresource = blit.srcSubresource;
+                blit.dstSubresource.mipLevel = level;
+                vkCmdBlitImage(commandBuffer,
+                               copy.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                               copy.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               1, &blit,
+                               VK_FILTER_LINEAR);
+            }
+
+            // levels that were copied but not blitted from, the blit sources and the last level
+            if (copiedLevels > 1)
+            {
+                imageBarriers.push_back(imageBarrier(copy.image, 0, copiedLevels - 1,
+                                                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                                     VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT));
+            }
+            imageBarriers.push_back(imageBarrier(copy.image, copiedLevels - 1, copy.mipLevels - copiedLevels,
+                                                 VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                                 VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT));
+            imageBarriers.push_back(imageBarrier(copy.image, copy.mipLevels - 1, 1,
+                                                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                                 VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT));
+        }
+
+        // later submissions read the buffers as vertices, indices or storage and sample the images
+        VkMemoryBarrier memoryBarrier{};
+        memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0,
+                             bufferCopies.empty() ? 0 : 1, &memoryBarrier,
+                             0, nullptr,
+                             static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+
+        vkEndCommandBuffer(commandBuffer);
+
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vkCreateFence(arcDevice.device(), &fenceInfo, nullptr, &fence) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create upload fence!");
+        }
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+        if (vkQueueSubmit(arcDevice.graphicsQueue(), 1, &submitInfo, fence) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to submit upload batch!");
+        }
+    }
+
+    bool ArcUploadBatch::isComplete() const
+    {
+        if (!submitted)
+            return false;
+        return fence == VK_NULL_HANDLE || vkGetFenceStatus(arcDevice.device(), fence) == VK_SUCCESS;
+    }
+
+    void ArcUploadBatch::wait()
+    {
+        if (fence != VK_NULL_HANDLE)
+        {
+            vkWaitForFences(arcDevice.device(), 1, &fence, VK_TRUE, UINT64_MAX);
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef __ARC_UPLOAD_BATCH_H__
+#define __ARC_UPLOAD_BATCH_H__
+
+#include "arc_buffer.hpp"
+#include "arc_device.hpp"
+
+// std
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace arc
+{
+    // Gathers buffer and image uploads, then copies all of them with one command buffer and one submit,
+    // signalling a fence instead of waiting for the queue to go idle
+    // data is staged straight into mapped host visible chunks, each larger than the one before
+    // record and submit on the thread that owns the device's command pool
+    class ArcUploadBatch
+    {
+    public:
+        ArcUploadBatch(ArcDevice &device);
+        // copies read from staging, a host visible buffer the caller fills and keeps alive until the batch completed
+        // only the copy* calls work in this mode
+        ArcUploadBatch(ArcDevice &device, ArcBuffer &staging);
+        // waits for a submitted batch, the staging memory may still be read by the GPU
+        ~ArcUploadBatch();
+
+        ArcUploadBatch(const ArcUploadBatch &) = delete;
+        ArcUploadBatch &operator=(const ArcUploadBatch &) = delete;
+
+        // data is copied into the batch right away, the caller's memory can be released afterwards
+        void uploadBuffer(VkBuffer buffer, const void *data, VkDeviceSize size, VkDeviceSize bufferOffset = 0);
+        // tightly packed texels for mip level 0, the image goes from UNDEFINED to SHADER_READ_ONLY_OPTIMAL
+        // levels 1 to mipLevels - 1 are blitted down from level 0 in the same command buffer, which needs
+        // TRANSFER_SRC usage and a format with linear filtered blit support
+        void uploadImage(VkImage image, const void *pixels, VkDeviceSize size, uint32_t width, uint32_t height,
+                         uint32_t mipLevels = 1);
+        // a prebuilt mip chain, level i starts at levelOffsets[i] in pixels
+        // each offset has to be a multiple of the format's texel or block size
+        void uploadImageLevels(VkImage image, const void *pixels, VkDeviceSize size, uint32_t width, uint32_t height,
+                               const std::vector<VkDeviceSize> &levelOffsets);
+
+        // size bytes of staging memory the caller writes in place, e.g. decoding straight into it
+        // the pointer stays valid until the batch is destroyed, offset is what copyImage takes
+        uint8_t *allocateStaging(VkDeviceSize size, VkDeviceSize &offset);
+        // uploads texels already in staging at stagingOffset, laid out as for uploadImageLevels
+        // levels past levelOffsets.size() up to mipLevels are blitted as in uploadImage
+        void copyImage(VkImage image, VkDeviceSize stagingOffset, uint32_t width, uint32_t height,
+                       const std::vector<VkDeviceSize> &levelOffsets, uint32_t mipLevels);
+
+        void submit();
+        bool isSubmitted() const { return submitted; }
+        // true once every copy of a submitted batch finished
+        bool isComplete() const;
+        void wait();
+
+        bool empty() const { return bufferCopies.empty() && imageCopies.empty(); }
+        VkDeviceSize stagingSize() const { return stagingBytes; }
+
+    private:
+        struct BufferCopy
+        {
+            VkBuffer buffer;
+            VkDeviceSize stagingOffset;
+            VkDeviceSize bufferOffset;
+            VkDeviceSize size;
+        };
+
+        struct ImageCopy
+        {
+            VkImage image;
+            VkDeviceSize stagingOffset;
+            uint32_t width;
+            uint32_t height;
+            uint32_t mipLevels;
+            // levels copied from staging, relative to stagingOffset, the remaining levels are blitted
+            std::vector<VkDeviceSize> levelOffsets;
+        };
+
+        // a mapped staging buffer holding the offsets from base on
+        struct StagingChunk
+        {
+            VkDeviceSize base;
+            std::unique_ptr<ArcBuffer> buffer;
+        };
+
+        VkDeviceSize stage(const void *data, VkDeviceSize size);
+        // the buffer an allocation at stagingOffset lives in, with stagingOffset made relative to it
+        VkBuffer stagingBufferAt(VkDeviceSize &stagingOffset) const;
+
+        ArcDevice &arcDevice;
+
+        VkDeviceSize stagingBytes = 0;
+        std::vector<BufferCopy> bufferCopies{};
+        std::vector<ImageCopy> imageCopies{};
+
+        // allocations never straddle two chunks
+        std::vector<StagingChunk> stagingChunks{};
+        ArcBuffer *externalStaging = nullptr;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+        bool submitted = false;
+    };
+}
+
+#endif // __ARC_UPLOAD_BATCH_H__
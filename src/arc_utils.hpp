@@ -1,6 +1,8 @@
 #ifndef __ARC_UTILS_H__
 #define __ARC_UTILS_H__
 
+#include <cstdint>
+#include <cstring>
 #include <functional>
 
 namespace arc
@@ -13,6 +15,40 @@ namespace arc
         seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
         (int[]){0, (hashCombine(seed, std::forward<Rest>(rest)), 0)...};
     }
+
+    // 64-bit hash over raw bytes, eight bytes per step with a murmur3 style finalizer
+    // the result is stable across runs, so it can be stored on disk
+    inline uint64_t hashBytes(const void *data, size_t size, uint64_t seed = 0)
+    {
+        const uint64_t m = 0x9e3779b97f4a7c15ull;
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+
+        uint64_t hash = seed ^ (size * m);
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, bytes + i, 8);
+            word *= m;
+            word ^= word >> 32;
+            hash = (hash ^ word) * m;
+        }
+        if (i < size)
+        {
+            uint64_t word = 0;
+            std::memcpy(&word, bytes + i, size - i);
+            word *= m;
+            word ^= word >> 32;
+            hash = (hash ^ word) * m;
+        }
+
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ull;
+        hash ^= hash >> 33;
+        return hash;
+    }
 }
 
-#endif // __ARC_UTILS_H__
\ No newline at end of file
+#endif // __ARC_UTILS_H__
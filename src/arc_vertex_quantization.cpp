@@ -0,0 +1,174 @@
+#include "arc_vertex_quantization.hpp"
+
+// libs
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/packing.hpp>
+
+// std
+#include <algorithm>
+#include <cmath>
+
+namespace arc
+{
+    namespace
+    {
+        constexpr float UNORM16_MAX = 65535.0f;
+        constexpr float SNORM16_MAX = 32767.0f;
+        constexpr float UNORM8_MAX = 255.0f;
+
+        glm::vec2 signNotZero(glm::vec2 v)
+        {
+            return glm::vec2{v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f};
+        }
+
+        // octahedral mapping of a unit vector onto [-1, 1]^2 (Cigolle et al. 2014)
+        glm::vec2 octahedralEncode(glm::vec3 n)
+        {
+            float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+            if (l1 == 0.0f)
+                return glm::vec2{0.0f};
+
+            glm::vec2 p = glm::vec2{n.x, n.y} / l1;
+            if (n.z < 0.0f)
+            {
+                p = (1.0f - glm::abs(glm::vec2{p.y, p.x})) * signNotZero(p);
+            }
+            return p;
+        }
+
+        glm::vec3 octahedralDecode(glm::vec2 e)
+        {
+            glm::vec3 n{e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y)};
+            if (n.z < 0.0f)
+            {
+                glm::vec2 xy = (1.0f - glm::abs(glm::vec2{n.y, n.x})) * signNotZero(glm::vec2{n.x, n.y});
+                n.x = xy.x;
+                n.y = xy.y;
+            }
+            return glm::normalize(n);
+        }
+
+        uint16_t toUnorm16(float v)
+        {
+            return static_cast<uint16_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * UNORM16_MAX));
+        }
+
+        int16_t toSnorm16(float v)
+        {
+            return static_cast<int16_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * SNORM16_MAX));
+        }
+
+        uint8_t toUnorm8(float v)
+        {
+            return static_cast<uint8_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * UNORM8_MAX));
+        }
+
+        // matches the Vulkan SNORM conversion rule, -32768 and -32767 both map to -1
+        float fromSnorm16(int16_t v)
+        {
+            return std::max(float(v) / SNORM16_MAX, -1.0f);
+        }
+    }
+
+    VertexQuantization computeVertexQuantization(const std::vector<ArcModel::Vertex> &vertices)
+    {
+        VertexQuantization quantization{};
+        if (vertices.empty())
+            return quantization;
+
+        glm::vec3 minPosition = vertices[0].position;
+        glm::vec3 maxPosition = vertices[0].position;
+        for (const auto &vertex : vertices)
+        {
+            minPosition = glm::min(minPosition, vertex.position);
+            maxPosition = glm::max(maxPosition, vertex.position);
+        }
+
+        glm::vec3 extent = maxPosition - minPosition;
+        float scale = std::max(extent.x, std::max(extent.y, extent.z));
+
+        quantization.offset = minPosition;
+        quantization.scale = scale > 0.0f ? scale : 1.0f;
+        return quantization;
+    }
+
+    ArcModel::PackedVertex packVertex(const ArcModel::Vertex &vertex, const VertexQuantization &quantization)
+    {
+        ArcModel::PackedVertex packed{};
+
+        glm::vec3 position = (vertex.position - quantization.offset) / quantization.scale;
+        packed.position[0] = toUnorm16(position.x);
+        packed.position[1] = toUnorm16(position.y);
+        packed.position[2] = toUnorm16(position.z);
+        packed.position[3] = 0;
+
+        glm::vec2 normal = octahedralEncode(vertex.normal);
+        packed.normal[0] = toSnorm16(normal.x);
+        packed.normal[1] = toSnorm16(normal.y);
+
+        packed.color[0] = toUnorm8(vertex.color.x);
+        packed.color[1] = toUnorm8(vertex.color.y);
+        packed.color[2] = toUnorm8(vertex.color.z);
+        packed.color[3] = toUnorm8(1.0f);
+
+        packed.uv[0] = glm::packHalf1x16(vertex.uv.x);
+        packed.uv[1] = glm::packHalf1x16(vertex.uv.y);
+        return packed;
+    }
+
+    ArcModel::Vertex unpackVertex(const ArcModel::PackedVertex &packed, const VertexQuantization &quantization)
+    {
+        ArcModel::Vertex vertex{};
+
+        glm::vec3 position{float(packed.position[0]), float(packed.position[1]), float(packed.position[2])};
+        vertex.position = quantization.offset + position / UNORM16_MAX * quantization.scale;
+
+        vertex.normal = octahedralDecode(glm::vec2{fromSnorm16(packed.normal[0]), fromSnorm16(packed.normal[1])});
+
+        vertex.color = glm::vec3{float(packed.color[0]), float(packed.color[1]), float(packed.color[2])} / UNORM8_MAX;
+
+        vertex.uv.x = glm::unpackHalf1x16(packed.uv[0]);
+        vertex.uv.y = glm::unpackHalf1x16(packed.uv[1]);
+        return vertex;
+    }
+
+    std::vector<ArcModel::PackedVertex> packVertices(const std::vector<ArcModel::Vertex> &vertices, const VertexQuantization &quantization)
+    {
+        std::vector<ArcModel::PackedVertex> packedVertices(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i)
+        {
+            packedVertices[i] = packVertex(vertices[i], quantization);
+        }
+        return packedVertices;
+    }
+
+    VertexQuantizationError measureQuantizationError(const std::vector<ArcModel::Vertex> &vertices,
+                                                     const std::vector<ArcModel::PackedVertex> &packedVertices,
+                                                     const VertexQuantization &quantization)
+    {
+        VertexQuantizationError error{};
+        for (size_t i = 0; i < vertices.size() && i < packedVertices.size(); ++i)
+        {
+            const ArcModel::Vertex &original = vertices[i];
+            ArcModel::Vertex decoded = unpackVertex(packedVertices[i], quantization);
+
+            glm::vec3 positionError = glm::abs(decoded.position - original.position);
+            error.position = std::max(error.position, std::max(positionError.x, std::max(positionError.y, positionError.z)));
+
+            // zero length normals have no direction to preserve
+            float normalLength = glm::length(original.normal);
+            if (normalLength > 0.0f)
+            {
+                float cosAngle = std::clamp(glm::dot(decoded.normal, original.normal / normalLength), -1.0f, 1.0f);
+                error.normalDegrees = std::max(error.normalDegrees, std::acos(cosAngle) * 180.0f / glm::pi<float>());
+            }
+
+            glm::vec3 colorError = glm::abs(decoded.color - original.color);
+            error.color = std::max(error.color, std::max(colorError.x, std::max(colorError.y, colorError.z)));
+
+            glm::vec2 uvError = glm::abs(decoded.uv - original.uv);
+            error.uv = std::max(error.uv, std::max(uvError.x, uvError.y));
+        }
+        return error;
+    }
+}
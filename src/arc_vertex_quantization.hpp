@@ -0,0 +1,44 @@
+#ifndef __ARC_VERTEX_QUANTIZATION_H__
+#define __ARC_VERTEX_QUANTIZATION_H__
+
+#include "arc_model.hpp"
+
+// std
+#include <vector>
+
+namespace arc
+{
+    // Per-model transform from unorm16 positions back to model space: position = offset + unorm * scale
+    // the scale is uniform so normals don't need a matching correction
+    struct VertexQuantization
+    {
+        glm::vec3 offset{0.0f};
+        float scale = 1.0f;
+
+        // packed into the spare column of the normal matrix push constant
+        glm::vec4 dequantization() const { return glm::vec4{offset, scale}; }
+    };
+
+    // Largest absolute decode error per attribute over a whole mesh
+    struct VertexQuantizationError
+    {
+        float position = 0.0f; // model space units
+        float normalDegrees = 0.0f;
+        float color = 0.0f;
+        float uv = 0.0f;
+    };
+
+    VertexQuantization computeVertexQuantization(const std::vector<ArcModel::Vertex> &vertices);
+
+    ArcModel::PackedVertex packVertex(const ArcModel::Vertex &vertex, const VertexQuantization &quantization);
+    // CPU mirror of the packed vertex shader decode
+    ArcModel::Vertex unpackVertex(const ArcModel::PackedVertex &vertex, const VertexQuantization &quantization);
+
+    std::vector<ArcModel::PackedVertex> packVertices(const std::vector<ArcModel::Vertex> &vertices, const VertexQuantization &quantization);
+
+    VertexQuantizationError measureQuantizationError(const std::vector<ArcModel::Vertex> &vertices,
+                                                     const std::vector<ArcModel::PackedVertex> &packedVertices,
+                                                     const VertexQuantization &quantization);
+}
+
+#endif // __ARC_VERTEX_QUANTIZATION_H__
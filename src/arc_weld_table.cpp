@@ -0,0 +1,113 @@
+#include "arc_weld_table.hpp"
+
+// std
+#include <cstring>
+
+namespace arc
+{
+    namespace
+    {
+        constexpr size_t MIN_WELD_CAPACITY = 64;
+        constexpr size_t VERTEX_WORDS = sizeof(ArcModel::Vertex) / sizeof(uint32_t);
+        static_assert(sizeof(ArcModel::Vertex) % sizeof(uint32_t) == 0, "Vertex must be made of 32-bit floats");
+
+        size_t nextPowerOfTwo(size_t value)
+        {
+            size_t result = MIN_WELD_CAPACITY;
+            while (result < value)
+                result <<= 1;
+            return result;
+        }
+    }
+
+    ArcWeldTable::ArcWeldTable(std::vector<ArcModel::Vertex> &vertices, size_t expectedVertices)
+        : vertices{vertices}
+    {
+        reserve(expectedVertices + vertices.size());
+
+        // ids already in the list are welded against as well
+        for (size_t i = 0; i < vertices.size(); ++i)
+        {
+            uint64_t h = hash(vertices[i]);
+            size_t slot = h & mask;
+            while (slots[slot].id != EMPTY_SLOT)
+                slot = (slot + 1) & mask;
+            slots[slot] = {static_cast<uint32_t>(h >> 32), static_cast<uint32_t>(i)};
+        }
+    }
+
+    uint64_t ArcWeldTable::hash(const ArcModel::Vertex &vertex)
+    {
+        uint32_t words[VERTEX_WORDS];
+        std::memcpy(words, &vertex, sizeof(words));
+
+        const uint64_t m = 0x9e3779b97f4a7c15ull;
+        uint64_t h = 0;
+        for (size_t i = 0; i < VERTEX_WORDS; ++i)
+        {
+            // -0.0 compares equal to 0.0, so both must land in the same bucket
+            uint32_t word = words[i] == 0x80000000u ? 0u : words[i];
+            h = (h ^ word) * m;
+            h ^= h >> 29;
+        }
+        h ^= h >> 32;
+        h *= 0xd6e8feb86659fd93ull;
+        h ^= h >> 32;
+        return h;
+    }
+
+    uint32_t ArcWeldTable::weld(const ArcModel::Vertex &vertex)
+    {
+        // keep the load factor at or below one half so probe runs stay short
+        if ((vertices.size() + 1) * 2 > slots.size())
+        {
+            rehash(slots.size() * 2);
+        }
+
+        uint64_t h = hash(vertex);
+        uint32_t tag = static_cast<uint32_t>(h >> 32);
+        size_t slot = h & mask;
+
+        while (slots[slot].id != EMPTY_SLOT)
+        {
+            if (slots[slot].tag == tag && vertices[slots[slot].id] == vertex)
+            {
+                return slots[slot].id;
+            }
+            slot = (slot + 1) & mask;
+        }
+
+        uint32_t id = static_cast<uint32_t>(vertices.size());
+        slots[slot] = {tag, id};
+        vertices.push_back(vertex);
+        return id;
+    }
+
+    void ArcWeldTable::reserve(size_t expectedVertices)
+    {
+        size_t capacity = nextPowerOfTwo(expectedVertices * 2);
+        if (capacity > slots.size())
+        {
+            rehash(capacity);
+        }
+        vertices.reserve(expectedVertices);
+    }
+
+    void ArcWeldTable::rehash(size_t capacity)
+    {
+        std::vector<Slot> oldSlots = std::move(slots);
+        slots.assign(nextPowerOfTwo(capacity), Slot{0, EMPTY_SLOT});
+        mask = slots.size() - 1;
+
+        for (const Slot &old : oldSlots)
+        {
+            if (old.id == EMPTY_SLOT)
+                continue;
+
+            size_t slot = hash(vertices[old.id]) & mask;
+            while (slots[slot].id != EMPTY_SLOT)
+                slot = (slot + 1) & mask;
+            slots[slot] = old;
+        }
+    }
+}
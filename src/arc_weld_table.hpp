@@ -0,0 +1,48 @@
+#ifndef __ARC_WELD_TABLE_H__
+#define __ARC_WELD_TABLE_H__
+
+#include "arc_model.hpp"
+
+// std
+#include <cstdint>
+#include <vector>
+
+namespace arc
+{
+    // Flat open-addressing table used to weld identical vertices
+    // slots hold a vertex id into the welded vertex list plus 32 bits of its hash,
+    // so a probe only touches the 44-byte vertex when the hash bits already match
+    class ArcWeldTable
+    {
+    public:
+        ArcWeldTable(std::vector<ArcModel::Vertex> &vertices, size_t expectedVertices = 0);
+
+        ArcWeldTable(const ArcWeldTable &) = delete;
+        ArcWeldTable &operator=(const ArcWeldTable &) = delete;
+
+        // returns the id of a vertex equal to `vertex`, appending it to the vertex list if it is new
+        uint32_t weld(const ArcModel::Vertex &vertex);
+
+        void reserve(size_t expectedVertices);
+        size_t size() const { return vertices.size(); }
+
+        // hash over the raw float bits, with -0.0 folded onto 0.0 to agree with Vertex::operator==
+        static uint64_t hash(const ArcModel::Vertex &vertex);
+
+    private:
+        struct Slot
+        {
+            uint32_t tag;
+            uint32_t id;
+        };
+        static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+        void rehash(size_t capacity);
+
+        std::vector<ArcModel::Vertex> &vertices;
+        std::vector<Slot> slots{};
+        size_t mask = 0;
+    };
+}
+
+#endif // __ARC_WELD_TABLE_H__
@@ -8,7 +8,11 @@
 #include "systems/stencil_system.hpp"
 #include "keyboard_movement_controller.hpp"
 #include "arc_frame_info.hpp"
+#include "arc_hot_reload.hpp"
 #include "arc_texture.hpp"
+#include "arc_texture_loader.hpp"
+#include "arc_texture_registry.hpp"
+#include "arc_texture_streamer.hpp"
 
 // libs
 #define GLM_FORCE_RADIANS
@@ -21,6 +25,8 @@
 #include <chrono>
 #include <stdexcept>
 #include <array>
+#include <algorithm>
+#include <thread>
 
 namespace arc
 {
@@ -30,7 +36,6 @@ namespace arc
         globalPool = ArcDescriptorPool::Builder(arcDevice)
                          .setMaxSets(ArcSwapChain::MAX_FRAMES_IN_FLIGHT)
                          .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, ArcSwapChain::MAX_FRAMES_IN_FLIGHT)
-                         .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, ArcSwapChain::MAX_FRAMES_IN_FLIGHT)
                          .build();
 
         loadGameObjects();
@@ -44,7 +49,36 @@ namespace arc
     {
         std::vector<std::unique_ptr<ArcBuffer>> globalUboBuffers(ArcSwapChain::MAX_FRAMES_IN_FLIGHT);
         // ArcTexture arcTeture{arcDevice, "images/texture.jpg"};
-        ArcTexture arcTeture{arcDevice, "images/viking_room.png"};
+        const std::string texturePath = "images/viking_room.png";
+        // device memory for the mips of streamed textures, their small mips are always resident
+        constexpr VkDeviceSize textureBudget = 256 * 1024 * 1024;
+        ArcTextureStreamer textureStreamer{arcDevice, textureBudget};
+        auto arcTeture = textureStreamer.load(texturePath);
+        // every texture is bound once per frame through the registry, game objects default to this one
+        ArcTextureRegistry textureRegistry{arcDevice, arcTeture};
+#ifdef ARC_BENCHMARKS
+        // texture batch benchmark: decode and upload wall time from one thread up to every core
+        {
+            std::vector<std::string> imagepaths{};
+            for (int i = 0; i < 32; ++i)
+            {
+                imagepaths.push_back("images/viking_room.png");
+                imagepaths.push_back("images/texture.jpg");
+            }
+            uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+            for (uint32_t threads = 1;; threads = std::min(threads * 2, maxThreads))
+            {
+                ArcTextureLoader loader{arcDevice, threads};
+                loader.loadTextures(imagepaths);
+                const auto &stats = loader.getStats();
+                std::cout << "[benchmark] " << stats.textures << " textures, " << (stats.stagedBytes >> 20) << " MB staged, "
+                          << threads << " threads: decode " << stats.decodeMilliseconds << " ms, upload "
+                          << stats.uploadMilliseconds << " ms, " << stats.samplersCreated << " samplers created\n";
+                if (threads == maxThreads)
+                    break;
+            }
+        }
+#endif
         for (int i = 0; i < globalUboBuffers.size(); ++i)
         {
             globalUboBuffers[i] = std::make_unique<ArcBuffer>(
@@ -58,7 +92,6 @@ namespace arc
 
         auto globalSetLayout = ArcDescriptorSetLayout::Builder(arcDevice)
                                    .addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
-                                   .addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
                                    .build();
 
         std::vector<VkDescriptorSet> globalDescriptorSets(ArcSwapChain::MAX_FRAMES_IN_FLIGHT);
@@ -66,18 +99,44 @@ namespace arc
         {
             auto bufferInfo = globalUboBuffers[i]->descriptorInfo();
 
-            VkDescriptorImageInfo imageInfo = arcTeture.descriptorInfo();
-
             ArcDescriptorWriter(*globalSetLayout, *globalPool)
                 .writeBuffer(0, &bufferInfo)
-                .writeImage(1, &imageInfo)
                 .build(globalDescriptorSets[i]);
         }
 
-        // SimpleRenderSystem simpleRenderSystem{arcDevice, arcRenderer.getSwapChainRenderPass(), globalSetLayout->getDescriptorSetLayout()};
+        // SimpleRenderSystem simpleRenderSystem{arcDevice, arcRenderer.getSwapChainRenderPass(), globalSetLayout->getDescriptorSetLayout(), textureRegistry};
         PointLightSystem pointLightSystem{arcDevice, arcRenderer.getSwapChainRenderPass(), globalSetLayout->getDescriptorSetLayout()};
-        // SpecializationConstantSystem specializationConstantSystem{arcDevice, arcRenderer.getSwapChainRenderPass(), globalSetLayout->getDescriptorSetLayout()};
+        // SpecializationConstantSystem specializationConstantSystem{arcDevice, arcRenderer.getSwapChainRenderPass(), globalSetLayout->getDescriptorSetLayout(), textureRegistry};
         StencilSystem stencilSystem{arcDevice, arcRenderer.getSwapChainRenderPass(), globalSetLayout->getDescriptorSetLayout()};
+
+        // changed assets are rebuilt in the background and swapped in between frames,
+        // declared after everything its callbacks touch so it goes away first
+        ArcHotReload hotReload{{"models", "images", "shaders"}};
+        pointLightSystem.watchShaders(hotReload);
+        stencilSystem.watchShaders(hotReload);
+        for (const auto &filepath : modelRegistry.getFilepaths())
+        {
+            hotReload.watch(filepath, [this, filepath]() -> ArcHotReload::Swap
+                            {
+                                modelRegistry.reload(filepath);
+                                return {}; });
+        }
+
+        hotReload.watch(texturePath, [&]() -> ArcHotReload::Swap
+                        {
+                            // the new mip tail is decoded on the reload thread, the larger mips stream in after it
+                            auto pending = textureStreamer.prepareLoad(texturePath);
+                            return [&, pending]()
+                            {
+                                auto texture = textureStreamer.finishLoad(*pending);
+                                if (!texture)
+                                    return false;
+
+                                // the registry keeps the previous texture until no frame samples it
+                                textureRegistry.replace(0, texture);
+                                arcTeture = texture;
+                                return true;
+                            }; });
         ArcCamera camera{};
         // camera.setViewDirection(glm::vec3{0.f}, glm::vec3(0.5f, 0.f, 1.f));
 
@@ -89,6 +148,27 @@ namespace arc
         while (!arcWindow.shouldClose())
         {
             glfwPollEvents();
+            // models finishing their background load show up from this frame on
+            assetLoader.update();
+            // evicted models go away once no frame in flight draws them
+            modelRegistry.update();
+            hotReload.update();
+            // a streamed texture whose mips changed has a new image view
+            if (textureStreamer.update())
+            {
+                textureRegistry.refresh();
+            }
+            for (auto &reload : modelRegistry.collectReloads())
+            {
+                for (auto &kv : gameObjects)
+                {
+                    if (kv.second.model == reload.previous)
+                    {
+                        kv.second.model = reload.current;
+                    }
+                }
+                hotReload.retire(std::move(reload.previous));
+            }
 
             // calculate the delta time for game loop
             auto newTime = std::chrono::high_resolution_clock::now();
@@ -101,18 +181,30 @@ namespace arc
             float aspect = arcRenderer.getAspectRatio();
             // camera.setOrthographicProjection(-aspect, aspect, -1, 1, -1, 1);
             camera.setPerspectiveProjection(glm::radians(50.0f), aspect, 0.1f, 10.f);
+
+            // every model samples the global texture, it needs as much detail as the largest one on screen
+            float screenHeight = static_cast<float>(arcWindow.getExtent().height);
+            for (auto &kv : gameObjects)
+            {
+                if (kv.second.model == nullptr)
+                    continue;
+                glm::vec4 sphere = kv.second.getWorldBounds().sphere;
+                textureStreamer.request(*arcTeture, camera.projectedRadius(glm::vec3{sphere}, sphere.w) * screenHeight);
+            }
             // each update advanced game time by a certain time
             // it taks a certain amount of real time to process that
             if (auto commandBuffer = arcRenderer.beginFrame())
             {
                 int frameIndex = arcRenderer.getFrameIndex();
+                textureRegistry.update(frameIndex);
                 FrameInfo frameInfo{
                     frameIndex,
                     frameTime,
                     commandBuffer,
                     camera,
                     globalDescriptorSets[frameIndex],
-                    gameObjects};
+                    gameObjects,
+                    &textureRegistry};
 
                 // update
                 GlobalUbo ubo{};
@@ -135,9 +227,13 @@ namespace arc
         }
 
         vkDeviceWaitIdle(arcDevice.device());
+
+        auto samplerStats = arcDevice.getSamplerCache().getStats();
+        std::cout << "Sampler cache: " << samplerStats.created << " created, " << samplerStats.reused << " reused, "
+                  << samplerStats.live << " live\n";
     }
 
-    std::unique_ptr<ArcModel> createCubeModel(ArcDevice &device, glm::vec3 offset)
+    std::unique_ptr<ArcModel> createCubeModel(ArcDevice &device, ArcGeometryArena &arena, glm::vec3 offset)
     {
         ArcModel::Builder modelBuilder{};
         modelBuilder.vertices = {
@@ -185,41 +281,45 @@ namespace arc
 
         modelBuilder.indices = {0, 1, 2, 0, 3, 1, 4, 5, 6, 4, 7, 5, 8, 9, 10, 8, 11, 9, 12, 13, 14, 12, 15, 13, 16, 17, 18, 16, 19, 17, 20, 21, 22, 20, 23, 21};
 
-        return std::make_unique<ArcModel>(device, modelBuilder);
+        modelBuilder.computeBounds();
+        return std::make_unique<ArcModel>(device, arena, modelBuilder);
     }
 
     void FirstApp::loadGameObjects()
     {
         std::shared_ptr<ArcModel> arcModel;
-        // arcModel= ArcModel::createModelFromFile(arcDevice, "models/smooth_vase.obj");
+        // arcModel= ArcModel::createModelFromFile(arcDevice, geometryArena, "models/smooth_vase.obj");
         //  auto gameObj = ArcGameObject::createGameObject();
         //  gameObj.model = arcModel;
         //  gameObj.transform.translation = {0.f, 0.5f, 0.f};
         //  gameObj.transform.scale = {1.0f, 1.5f, 1.0f};
         //  gameObjects.emplace(gameObj.getID(), std::move(gameObj));
 
-        // arcModel = ArcModel::createModelFromFile(arcDevice, "models/flat_vase.obj");
+        // arcModel = ArcModel::createModelFromFile(arcDevice, geometryArena, "models/flat_vase.obj");
         // auto flatVase = ArcGameObject::createGameObject();
         // flatVase.model = arcModel;
         // flatVase.transform.translation = {.5f, .5f, 1.f};
         // flatVase.transform.scale = {3.0f, 1.6f, 3.f};
         // gameObjects.emplace(flatVase.getID(), std::move(flatVase));
 
-        // arcModel = ArcModel::createModelFromFile(arcDevice, "models/quad.obj");
+        // arcModel = ArcModel::createModelFromFile(arcDevice, geometryArena, "models/quad.obj");
         // auto floor = ArcGameObject::createGameObject();
         // floor.model = arcModel;
         // floor.transform.translation = {0.f, .5f, 1.f};
         // floor.transform.scale = {3.0f, 1.f, 3.f};
         // gameObjects.emplace(floor.getID(), std::move(floor));
 
-        arcModel = ArcModel::createModelFromFile(arcDevice, "models/venus.obj");
+        // outlined by the stencil system, which then only fetches positions and normals
+        ArcModel::Builder outlinedOptions{};
+        outlinedOptions.positionStream = true;
+        arcModel = modelRegistry.getModel("models/venus.obj", outlinedOptions);
         auto venus = ArcGameObject::createGameObject();
         venus.model = arcModel;
         venus.transform.translation = {1.f, 0.f, 1.f};
         // venus.transform.rotation = {0.f, -1.f, 0.f};
         gameObjects.emplace(venus.getID(), std::move(venus));
 
-        // arcModel = ArcModel::createModelFromFile(arcDevice, "models/viking_room.obj");
+        // arcModel = ArcModel::createModelFromFile(arcDevice, geometryArena, "models/viking_room.obj");
         // auto vikingRoom = ArcGameObject::createGameObject();
         // vikingRoom.model = arcModel;
         // vikingRoom.transform.translation = {1.f, 0.f, 0.f};
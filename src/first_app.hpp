@@ -2,6 +2,8 @@
 
 #include "arc_window.hpp"
 #include "arc_device.hpp"
+#include "arc_asset_loader.hpp"
+#include "arc_model_registry.hpp"
 #include "arc_game_object.hpp"
 #include "arc_renderer.hpp"
 #include "arc_descriptors.hpp"
@@ -33,6 +35,9 @@ namespace arc
         ArcWindow arcWindow{WIDTH, HEIGHT, "Hello Vulkan!"};
         ArcDevice arcDevice{arcWindow};
         ArcRenderer arcRenderer{arcWindow, arcDevice};
+        ArcGeometryArena geometryArena{arcDevice};
+        ArcAssetLoader assetLoader{arcDevice, geometryArena};
+        ArcModelRegistry modelRegistry{assetLoader};
 
         std::unique_ptr<ArcDescriptorPool> globalPool{};
         ArcGameObject::Map gameObjects;
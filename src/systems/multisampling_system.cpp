@@ -24,13 +24,20 @@ namespace arc
             &frameInfo.globalDescriptorSet,
             0, nullptr);
 
+        // models sharing an arena block share their vertex and index buffers
+        uint32_t boundBlock = ArcGeometryArena::INVALID_BLOCK;
         for (auto &kv : frameInfo.gameObjects)
         {
             auto &obj = kv.second;
-            if (obj.model == nullptr)
+            // this system has no pipeline for the packed vertex layout
+            if (obj.model == nullptr || !obj.model->isReady() || obj.model->hasPackedVertices())
                 continue;
-            obj.model->bind(frameInfo.commandBuffer);
-            obj.model->draw(frameInfo.commandBuffer);
+            if (obj.model->getGeometryBlock() != boundBlock)
+            {
+                obj.model->bind(frameInfo.commandBuffer);
+                boundBlock = obj.model->getGeometryBlock();
+            }
+            obj.model->draw(frameInfo.commandBuffer, obj.selectLod(frameInfo.camera));
         }
     }
 
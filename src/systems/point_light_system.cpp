@@ -19,11 +19,17 @@ namespace arc
         float radius;
     };
 
+    namespace
+    {
+        constexpr const char *POINT_LIGHT_VERT_SHADER = "shaders/point_light.vert.spv";
+        constexpr const char *POINT_LIGHT_FRAG_SHADER = "shaders/point_light.frag.spv";
+    }
+
     PointLightSystem::PointLightSystem(ArcDevice &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout)
-        : arcDevice{device}
+        : arcDevice{device}, renderPass{renderPass}
     {
         createPipelineLayout(globalSetLayout);
-        createPipeline(renderPass);
+        arcPipeline = createPipeline();
     }
 
     PointLightSystem::~PointLightSystem()
@@ -53,7 +59,7 @@ namespace arc
         }
     }
 
-    void PointLightSystem::createPipeline(VkRenderPass renderPass)
+    std::shared_ptr<ArcPipeline> PointLightSystem::createPipeline() const
     {
 
         assert(pipelineLayout != nullptr && "Cannot craete pipeline before pipeline layout!");
@@ -69,14 +75,30 @@ namespace arc
         PipelineShaderConfigInfo shaderConfig{};
         shaderConfig.stageInfo.pSpecializationInfo = nullptr;
         // pipelineConfig.multisampleInfo.rasterizationSamples = VK_SAMPLE_COUNT_2_BIT;
-        arcPipeline = std::make_unique<ArcPipeline>(
+        return std::make_shared<ArcPipeline>(
             arcDevice,
-            "shaders/point_light.vert.spv",
-            "shaders/point_light.frag.spv",
+            POINT_LIGHT_VERT_SHADER,
+            POINT_LIGHT_FRAG_SHADER,
             pipelineConfig,
             shaderConfig);
     }
 
+    void PointLightSystem::watchShaders(ArcHotReload &hotReload)
+    {
+        auto rebuild = [this, &hotReload]() -> ArcHotReload::Swap
+        {
+            auto pipeline = createPipeline();
+            return [this, &hotReload, pipeline]()
+            {
+                hotReload.retire(std::move(arcPipeline));
+                arcPipeline = pipeline;
+                return true;
+            };
+        };
+        hotReload.watch(POINT_LIGHT_VERT_SHADER, rebuild);
+        hotReload.watch(POINT_LIGHT_FRAG_SHADER, rebuild);
+    }
+
     void PointLightSystem::update(FrameInfo &frameInfo, GlobalUbo &ubo)
     {
         auto rotateLight = glm::rotate(glm::mat4(1.f), .5f * frameInfo.frameTime, {0.f, -1.f, 0.f});
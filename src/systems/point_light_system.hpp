@@ -5,6 +5,7 @@
 #include "arc_device.hpp"
 #include "arc_game_object.hpp"
 #include "arc_frame_info.hpp"
+#include "arc_hot_reload.hpp"
 
 // std
 #include <vector>
@@ -23,13 +24,17 @@ namespace arc
         void update(FrameInfo &frameInfo, GlobalUbo &ubo);
         void render(FrameInfo &frameInfo);
 
+        // rebuilds the pipeline whenever one of its SPIR-V files changes, the system has to outlive hotReload
+        void watchShaders(ArcHotReload &hotReload);
+
     private:
         void createPipelineLayout(VkDescriptorSetLayout globalSetLayout);
-        void createPipeline(VkRenderPass renderPass);
+        std::shared_ptr<ArcPipeline> createPipeline() const;
 
     private:
         ArcDevice &arcDevice;
-        std::unique_ptr<ArcPipeline> arcPipeline;
+        VkRenderPass renderPass;
+        std::shared_ptr<ArcPipeline> arcPipeline;
         VkPipelineLayout pipelineLayout;
     };
 } // namespace arc
@@ -17,12 +17,12 @@ namespace arc
         glm::mat4 normalMatrix{1.0f};
     };
 
-    SimpleRenderSystem::SimpleRenderSystem(ArcDevice &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout)
+    SimpleRenderSystem::SimpleRenderSystem(ArcDevice &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout, const ArcTextureRegistry &textureRegistry)
         : arcDevice{device}
 
     {
-        createPipelineLayout(globalSetLayout);
-        createPipeline(renderPass);
+        createPipelineLayout(globalSetLayout, textureRegistry.getDescriptorSetLayout());
+        createPipeline(renderPass, textureRegistry);
     }
 
     SimpleRenderSystem::~SimpleRenderSystem()
@@ -30,14 +30,15 @@ namespace arc
         vkDestroyPipelineLayout(arcDevice.device(), pipelineLayout, nullptr);
     }
 
-    void SimpleRenderSystem::createPipelineLayout(VkDescriptorSetLayout globalSetLayout)
+    void SimpleRenderSystem::createPipelineLayout(VkDescriptorSetLayout globalSetLayout, VkDescriptorSetLayout textureSetLayout)
     {
         VkPushConstantRange pushConstantRange{};
         pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
         pushConstantRange.offset = 0;
         pushConstantRange.size = sizeof(SimplePushConstantData);
 
-        std::vector<VkDescriptorSetLayout> descriptorSetLayouts{globalSetLayout};
+        // set 1 holds every texture, objects index it with their push constants
+        std::vector<VkDescriptorSetLayout> descriptorSetLayouts{globalSetLayout, textureSetLayout};
 
         VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
         pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -52,7 +53,7 @@ namespace arc
         }
     }
 
-    void SimpleRenderSystem::createPipeline(VkRenderPass renderPass)
+    void SimpleRenderSystem::createPipeline(VkRenderPass renderPass, const ArcTextureRegistry &textureRegistry)
     {
 
         assert(pipelineLayout != nullptr && "Cannot create pipeline before pipeline layout!");
@@ -63,7 +64,8 @@ namespace arc
         pipelineConfig.multisampleInfo.rasterizationSamples = arcDevice.getMaxUsableSampleCount();
 
         PipelineShaderConfigInfo shaderConfig{};
-        shaderConfig.stageInfo.pSpecializationInfo = nullptr;
+        // sizes the fragment shader's texture array
+        shaderConfig.stageInfo.pSpecializationInfo = &textureRegistry.getSpecializationInfo();
         // pipelineConfig.multisampleInfo.rasterizationSamples = VK_SAMPLE_COUNT_2_BIT;
         arcPipeline = std::make_unique<ArcPipeline>(
             arcDevice,
@@ -71,28 +73,66 @@ namespace arc
             "shaders/simple_shader.frag.spv",
             pipelineConfig,
             shaderConfig);
+
+        pipelineConfig.bindingDescriptions = ArcModel::PackedVertex::getBindingDescriptions();
+        pipelineConfig.attributeDescriptions = ArcModel::PackedVertex::getAttributeDescriptions();
+        packedPipeline = std::make_unique<ArcPipeline>(
+            arcDevice,
+            "shaders/simple_shader_packed.vert.spv",
+            "shaders/simple_shader.frag.spv",
+            pipelineConfig,
+            shaderConfig);
     }
 
     void SimpleRenderSystem::renderGameObjects(FrameInfo &frameInfo)
     {
         arcPipeline->bind(frameInfo.commandBuffer);
 
+        // the textures are bound once for every object of the frame, unless the device can't index them
+        std::array<VkDescriptorSet, 2> descriptorSets{frameInfo.globalDescriptorSet,
+                                                      frameInfo.textureRegistry->getDescriptorSet(frameInfo.frameIndex)};
         vkCmdBindDescriptorSets(
             frameInfo.commandBuffer,
             VK_PIPELINE_BIND_POINT_GRAPHICS,
             pipelineLayout,
-            0, 1,
-            &frameInfo.globalDescriptorSet,
+            0, static_cast<uint32_t>(descriptorSets.size()),
+            descriptorSets.data(),
             0, nullptr);
 
+        renderGameObjects(frameInfo, false);
+
+        // packed models use a different vertex layout, so they get their own pipeline
+        packedPipeline->bind(frameInfo.commandBuffer);
+        renderGameObjects(frameInfo, true);
+    }
+
+    void SimpleRenderSystem::renderGameObjects(FrameInfo &frameInfo, bool packedVertices)
+    {
+        const ArcTextureRegistry &textures = *frameInfo.textureRegistry;
+        // models sharing an arena block share their vertex and index buffers
+        uint32_t boundBlock = ArcGeometryArena::INVALID_BLOCK;
         for (auto &kv : frameInfo.gameObjects)
         {
             auto &obj = kv.second;
-            if (obj.model == nullptr)
+            if (obj.model == nullptr || !obj.model->isReady() || obj.model->hasPackedVertices() != packedVertices)
                 continue;
             SimplePushConstantData push{};
             push.modelMatrix = obj.transform.mat4();
             push.normalMatrix = obj.transform.normalMatrix();
+            // push constants are full, the texture index goes into a row the shaders' mat3 never reads
+            push.normalMatrix[2][3] = static_cast<float>(obj.textureIndex);
+            if (textures.bindsPerObject())
+            {
+                VkDescriptorSet textureSet = textures.getDescriptorSet(frameInfo.frameIndex, obj.textureIndex);
+                vkCmdBindDescriptorSets(
+                    frameInfo.commandBuffer,
+                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    pipelineLayout,
+                    1, 1,
+                    &textureSet,
+                    0, nullptr);
+            }
+            push.normalMatrix[3] = obj.model->getDequantization();
 
             vkCmdPushConstants(frameInfo.commandBuffer,
                                pipelineLayout,
@@ -101,8 +141,12 @@ namespace arc
                                sizeof(SimplePushConstantData),
                                &push);
 
-            obj.model->bind(frameInfo.commandBuffer);
-            obj.model->draw(frameInfo.commandBuffer);
+            if (obj.model->getGeometryBlock() != boundBlock)
+            {
+                obj.model->bind(frameInfo.commandBuffer);
+                boundBlock = obj.model->getGeometryBlock();
+            }
+            obj.model->draw(frameInfo.commandBuffer, obj.selectLod(frameInfo.camera));
         }
     }
 }
\ No newline at end of file
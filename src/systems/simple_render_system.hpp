@@ -3,6 +3,7 @@
 #include "arc_pipeline.hpp"
 #include "arc_device.hpp"
 #include "arc_frame_info.hpp"
+#include "arc_texture_registry.hpp"
 
 // std
 #include <vector>
@@ -12,7 +13,7 @@ namespace arc
     class SimpleRenderSystem
     {
     public:
-        SimpleRenderSystem(ArcDevice &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout);
+        SimpleRenderSystem(ArcDevice &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout, const ArcTextureRegistry &textureRegistry);
         ~SimpleRenderSystem();
 
         SimpleRenderSystem(const SimpleRenderSystem &) = delete;
@@ -21,12 +22,14 @@ namespace arc
         void renderGameObjects(FrameInfo &frameInfo);
 
     private:
-        void createPipelineLayout(VkDescriptorSetLayout globalSetLayout);
-        void createPipeline(VkRenderPass renderPass);
+        void createPipelineLayout(VkDescriptorSetLayout globalSetLayout, VkDescriptorSetLayout textureSetLayout);
+        void createPipeline(VkRenderPass renderPass, const ArcTextureRegistry &textureRegistry);
+        void renderGameObjects(FrameInfo &frameInfo, bool packedVertices);
 
     private:
         ArcDevice &arcDevice;
         std::unique_ptr<ArcPipeline> arcPipeline;
+        std::unique_ptr<ArcPipeline> packedPipeline;
         VkPipelineLayout pipelineLayout;
     };
 } // namespace arc
@@ -1,5 +1,6 @@
 #include "specializationConstants.hpp"
 
+#include <array>
 #include <stdexcept>
 
 namespace arc
@@ -11,11 +12,11 @@ namespace arc
         glm::mat4 normalMatrix{1.0f};
     };
 
-    SpecializationConstantSystem::SpecializationConstantSystem(ArcDevice &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout)
+    SpecializationConstantSystem::SpecializationConstantSystem(ArcDevice &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout, const ArcTextureRegistry &textureRegistry)
         : arcDevice(device)
     {
-        createPipelineLayout(globalSetLayout);
-        createPipeline(renderPass);
+        createPipelineLayout(globalSetLayout, textureRegistry.getDescriptorSetLayout());
+        createPipeline(renderPass, textureRegistry);
     }
 
     void SpecializationConstantSystem::renderGameObjects(FrameInfo &frameInfo)
@@ -36,23 +37,42 @@ namespace arc
         //  pipelines.phong->bind(frameInfo.commandBuffer);
         // pipelines.textured->bind(frameInfo.commandBuffer);
 
+        // the textures are bound once for every object of the frame, unless the device can't index them
+        const ArcTextureRegistry &textures = *frameInfo.textureRegistry;
+        std::array<VkDescriptorSet, 2> descriptorSets{frameInfo.globalDescriptorSet, textures.getDescriptorSet(frameInfo.frameIndex)};
         vkCmdBindDescriptorSets(
             frameInfo.commandBuffer,
             VK_PIPELINE_BIND_POINT_GRAPHICS,
             pipelineLayout,
-            0, 1,
-            &frameInfo.globalDescriptorSet,
+            0, static_cast<uint32_t>(descriptorSets.size()),
+            descriptorSets.data(),
             0, nullptr);
 
+        // models sharing an arena block share their vertex and index buffers
+        uint32_t boundBlock = ArcGeometryArena::INVALID_BLOCK;
         for (auto &kv : frameInfo.gameObjects)
         {
             auto &obj = kv.second;
-            if (obj.model == nullptr)
+            // this system has no pipeline for the packed vertex layout
+            if (obj.model == nullptr || !obj.model->isReady() || obj.model->hasPackedVertices())
                 continue;
 
             SimplePushConstantData push{};
             push.modelMatrix = obj.transform.mat4();
             push.normalMatrix = obj.transform.normalMatrix();
+            // push constants are full, the texture index goes into a row the shaders' mat3 never reads
+            push.normalMatrix[2][3] = static_cast<float>(obj.textureIndex);
+            if (textures.bindsPerObject())
+            {
+                VkDescriptorSet textureSet = textures.getDescriptorSet(frameInfo.frameIndex, obj.textureIndex);
+                vkCmdBindDescriptorSets(
+                    frameInfo.commandBuffer,
+                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    pipelineLayout,
+                    1, 1,
+                    &textureSet,
+                    0, nullptr);
+            }
 
             vkCmdPushConstants(frameInfo.commandBuffer,
                                pipelineLayout,
@@ -61,12 +81,16 @@ namespace arc
                                sizeof(SimplePushConstantData),
                                &push);
 
-            obj.model->bind(frameInfo.commandBuffer);
-            obj.model->draw(frameInfo.commandBuffer);
+            if (obj.model->getGeometryBlock() != boundBlock)
+            {
+                obj.model->bind(frameInfo.commandBuffer);
+                boundBlock = obj.model->getGeometryBlock();
+            }
+            obj.model->draw(frameInfo.commandBuffer, obj.selectLod(frameInfo.camera));
         }
     }
 
-    void SpecializationConstantSystem::createPipelineLayout(VkDescriptorSetLayout globalSetLayout)
+    void SpecializationConstantSystem::createPipelineLayout(VkDescriptorSetLayout globalSetLayout, VkDescriptorSetLayout textureSetLayout)
     {
         // std::vector<VkDescriptorSetLayout> descriptorSetLayouts{globalSetLayout};
 
@@ -78,7 +102,8 @@ namespace arc
         pushConstantRange.offset = 0;
         pushConstantRange.size = sizeof(SimplePushConstantData);
 
-        std::vector<VkDescriptorSetLayout> descriptorSetLayouts{globalSetLayout};
+        // set 1 holds every texture, objects index it with their push constants
+        std::vector<VkDescriptorSetLayout> descriptorSetLayouts{globalSetLayout, textureSetLayout};
 
         VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
         pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -93,7 +118,7 @@ namespace arc
         }
     }
 
-    void SpecializationConstantSystem::createPipeline(VkRenderPass renderPass)
+    void SpecializationConstantSystem::createPipeline(VkRenderPass renderPass, const ArcTextureRegistry &textureRegistry)
     {
         assert(pipelineLayout != nullptr && "Cannot create pipeline without creating pipeline layout first!");
         PipelineConfigInfo pipelineConfig{};
@@ -109,10 +134,15 @@ namespace arc
             uint32_t lightingModel{0};
             // Parameter for the toon shading part of the fragment shader
             float toonDesaturationFactor{0.5f};
+            // Size of the texture array and whether each object binds its own, see ArcTextureRegistry
+            uint32_t textureCount{1};
+            VkBool32 perObjectTextures{VK_FALSE};
         } specializationData;
+        specializationData.textureCount = textureRegistry.getArraySize();
+        specializationData.perObjectTextures = textureRegistry.bindsPerObject() ? VK_TRUE : VK_FALSE;
 
         // Each shader constant of a shader stage corresponds to one map entry
-        std::array<VkSpecializationMapEntry, 2> specializationMapEntries;
+        std::array<VkSpecializationMapEntry, 4> specializationMapEntries;
         // Shader bindings based on specialization constants are marked by the new "constant_id" layout qualifier:
         //      layout (constant_id = 0) const int LIGHTING_MODEL = 0;
         //      layout (constant_id = 1) const float PARAM_TOON_DESATURATION = 0.0f;
@@ -127,6 +157,16 @@ namespace arc
         specializationMapEntries[1].size = sizeof(specializationData.lightingModel);
         specializationMapEntries[1].offset = offsetof(SpecializationData, SpecializationData::toonDesaturationFactor);
 
+        // Map entry for the size of the texture array
+        specializationMapEntries[2].constantID = ArcTextureRegistry::TEXTURE_COUNT_CONSTANT_ID;
+        specializationMapEntries[2].size = sizeof(specializationData.textureCount);
+        specializationMapEntries[2].offset = offsetof(SpecializationData, SpecializationData::textureCount);
+
+        // Map entry for binding the texture set per object
+        specializationMapEntries[3].constantID = ArcTextureRegistry::PER_OBJECT_TEXTURES_CONSTANT_ID;
+        specializationMapEntries[3].size = sizeof(specializationData.perObjectTextures);
+        specializationMapEntries[3].offset = offsetof(SpecializationData, SpecializationData::perObjectTextures);
+
         // Prepare specialization info block for the shader stage
         VkSpecializationInfo specializationInfo{};
         specializationInfo.dataSize = sizeof(specializationData);
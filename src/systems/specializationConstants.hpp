@@ -3,6 +3,7 @@
 #include "arc_pipeline.hpp"
 #include "arc_device.hpp"
 #include "arc_frame_info.hpp"
+#include "arc_texture_registry.hpp"
 
 // std
 #include <vector>
@@ -12,7 +13,7 @@ namespace arc
     class SpecializationConstantSystem
     {
     public:
-        SpecializationConstantSystem(ArcDevice &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout);
+        SpecializationConstantSystem(ArcDevice &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout, const ArcTextureRegistry &textureRegistry);
         ~SpecializationConstantSystem();
 
         SpecializationConstantSystem(const SpecializationConstantSystem &) = delete;
@@ -21,8 +22,8 @@ namespace arc
         void renderGameObjects(FrameInfo &frameInfo);
 
     private:
-        void createPipelineLayout(VkDescriptorSetLayout globalSetLayout);
-        void createPipeline(VkRenderPass renderPass);
+        void createPipelineLayout(VkDescriptorSetLayout globalSetLayout, VkDescriptorSetLayout textureSetLayout);
+        void createPipeline(VkRenderPass renderPass, const ArcTextureRegistry &textureRegistry);
 
     private:
         struct Pipelines
@@ -17,11 +17,32 @@ namespace arc
         glm::mat4 normalMatrix{1.0f};
     };
 
+    namespace
+    {
+        struct PipelineShaders
+        {
+            const char *vertFilePath;
+            const char *fragFilePath;
+        };
+
+        // indexed by StencilSystem::PipelineType
+        const PipelineShaders PIPELINE_SHADERS[] = {
+            {"shaders/toon.vert.spv", "shaders/toon.frag.spv"},
+            {"shaders/toon_packed.vert.spv", "shaders/toon.frag.spv"},
+            {"shaders/outline.vert.spv", "shaders/outline.frag.spv"},
+            {"shaders/outline_packed.vert.spv", "shaders/outline.frag.spv"},
+            {"shaders/outline_positions.vert.spv", "shaders/outline.frag.spv"},
+            {"shaders/outline_positions_packed.vert.spv", "shaders/outline.frag.spv"}};
+    }
+
     StencilSystem::StencilSystem(ArcDevice &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout)
-        : arcDevice(device)
+        : arcDevice(device), renderPass{renderPass}
     {
         createPipelineLayout(globalSetLayout);
-        createPipeline(renderPass);
+        for (int type = 0; type < PIPELINE_TYPE_COUNT; ++type)
+        {
+            pipelines[type] = createPipeline(static_cast<PipelineType>(type));
+        }
     }
 
     void StencilSystem::render(FrameInfo &frameInfo)
@@ -34,44 +55,79 @@ namespace arc
             &frameInfo.globalDescriptorSet,
             0, nullptr);
 
-        stencil->bind(frameInfo.commandBuffer);
+        // each pass draws the full precision models first, then the packed ones with their own vertex layout
+        pipelines[STENCIL]->bind(frameInfo.commandBuffer);
+        renderGameObjects(frameInfo, false, false);
+        pipelines[STENCIL_PACKED]->bind(frameInfo.commandBuffer);
+        renderGameObjects(frameInfo, true, false);
+
+        // the outline only needs positions and normals, models with a position stream fetch just those
+        pipelines[OUTLINE]->bind(frameInfo.commandBuffer);
+        renderGameObjects(frameInfo, false, true);
+        pipelines[OUTLINE_PACKED]->bind(frameInfo.commandBuffer);
+        renderGameObjects(frameInfo, true, true);
+        pipelines[OUTLINE_POSITIONS]->bind(frameInfo.commandBuffer);
+        renderPositionStreams(frameInfo, false);
+        pipelines[OUTLINE_POSITIONS_PACKED]->bind(frameInfo.commandBuffer);
+        renderPositionStreams(frameInfo, true);
+    }
+
+    void StencilSystem::pushConstants(FrameInfo &frameInfo, ArcGameObject &obj)
+    {
+        SimplePushConstantData push{};
+        push.modelMatrix = obj.transform.mat4();
+        push.normalMatrix = obj.transform.normalMatrix();
+        push.normalMatrix[3] = obj.model->getDequantization();
+
+        vkCmdPushConstants(frameInfo.commandBuffer,
+                           pipelineLayout,
+                           VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                           0,
+                           sizeof(SimplePushConstantData),
+                           &push);
+    }
+
+    void StencilSystem::renderGameObjects(FrameInfo &frameInfo, bool packedVertices, bool skipPositionStreams)
+    {
+        // models sharing an arena block share their vertex and index buffers
+        uint32_t boundBlock = ArcGeometryArena::INVALID_BLOCK;
         for (auto &kv : frameInfo.gameObjects)
         {
             auto &obj = kv.second;
-            if (obj.model == nullptr)
+            if (obj.model == nullptr || !obj.model->isReady() || obj.model->hasPackedVertices() != packedVertices ||
+                (skipPositionStreams && obj.model->hasPositionStream()))
                 continue;
-            SimplePushConstantData push{};
-            push.modelMatrix = obj.transform.mat4();
-            push.normalMatrix = obj.transform.normalMatrix();
-
-            vkCmdPushConstants(frameInfo.commandBuffer,
-                               pipelineLayout,
-                               VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                               0,
-                               sizeof(SimplePushConstantData),
-                               &push);
-            obj.model->bind(frameInfo.commandBuffer);
-            obj.model->draw(frameInfo.commandBuffer);
+
+            pushConstants(frameInfo, obj);
+            if (obj.model->getGeometryBlock() != boundBlock)
+            {
+                obj.model->bind(frameInfo.commandBuffer);
+                boundBlock = obj.model->getGeometryBlock();
+            }
+            obj.model->draw(frameInfo.commandBuffer, obj.selectLod(frameInfo.camera));
         }
+    }
 
-        outline->bind(frameInfo.commandBuffer);
+    void StencilSystem::renderPositionStreams(FrameInfo &frameInfo, bool packedVertices)
+    {
+        // position streams sit in vertex only blocks, the indices still come from the geometry block
+        uint32_t boundBlock = ArcGeometryArena::INVALID_BLOCK;
+        uint32_t boundIndexBlock = ArcGeometryArena::INVALID_BLOCK;
         for (auto &kv : frameInfo.gameObjects)
         {
             auto &obj = kv.second;
-            if (obj.model == nullptr)
+            if (obj.model == nullptr || !obj.model->isReady() || obj.model->hasPackedVertices() != packedVertices ||
+                !obj.model->hasPositionStream())
                 continue;
-            SimplePushConstantData push{};
-            push.modelMatrix = obj.transform.mat4();
-            push.normalMatrix = obj.transform.normalMatrix();
-
-            vkCmdPushConstants(frameInfo.commandBuffer,
-                               pipelineLayout,
-                               VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                               0,
-                               sizeof(SimplePushConstantData),
-                               &push);
-            obj.model->bind(frameInfo.commandBuffer);
-            obj.model->draw(frameInfo.commandBuffer);
+
+            pushConstants(frameInfo, obj);
+            if (obj.model->getPositionBlock() != boundBlock || obj.model->getGeometryBlock() != boundIndexBlock)
+            {
+                obj.model->bindPositions(frameInfo.commandBuffer);
+                boundBlock = obj.model->getPositionBlock();
+                boundIndexBlock = obj.model->getGeometryBlock();
+            }
+            obj.model->drawPositions(frameInfo.commandBuffer, obj.selectLod(frameInfo.camera));
         }
     }
 
@@ -97,7 +153,7 @@ namespace arc
         }
     }
 
-    void StencilSystem::createPipeline(VkRenderPass renderPass)
+    std::shared_ptr<ArcPipeline> StencilSystem::createPipeline(PipelineType type) const
     {
         assert(pipelineLayout != nullptr && "Cannot create a pipeline without pipeline layout");
         PipelineConfigInfo pipelineConfigInfo{};
@@ -118,29 +174,60 @@ namespace arc
         pipelineConfigInfo.depthStencilInfo.back.reference = 1;
         pipelineConfigInfo.depthStencilInfo.front = pipelineConfigInfo.depthStencilInfo.back;
 
+        if (type == OUTLINE || type == OUTLINE_PACKED || type == OUTLINE_POSITIONS || type == OUTLINE_POSITIONS_PACKED)
+        {
+            pipelineConfigInfo.depthStencilInfo.back.compareOp = VK_COMPARE_OP_NOT_EQUAL;
+            pipelineConfigInfo.depthStencilInfo.back.failOp = VK_STENCIL_OP_KEEP;
+            pipelineConfigInfo.depthStencilInfo.back.depthFailOp = VK_STENCIL_OP_KEEP;
+            pipelineConfigInfo.depthStencilInfo.back.passOp = VK_STENCIL_OP_REPLACE;
+            pipelineConfigInfo.depthStencilInfo.front = pipelineConfigInfo.depthStencilInfo.back;
+            pipelineConfigInfo.depthStencilInfo.depthTestEnable = VK_FALSE;
+        }
+
+        if (type == STENCIL_PACKED || type == OUTLINE_PACKED)
+        {
+            pipelineConfigInfo.bindingDescriptions = ArcModel::PackedVertex::getBindingDescriptions();
+            pipelineConfigInfo.attributeDescriptions = ArcModel::PackedVertex::getAttributeDescriptions();
+        }
+        else if (type == OUTLINE_POSITIONS)
+        {
+            pipelineConfigInfo.bindingDescriptions = ArcModel::PositionVertex::getBindingDescriptions();
+            pipelineConfigInfo.attributeDescriptions = ArcModel::PositionVertex::getAttributeDescriptions();
+        }
+        else if (type == OUTLINE_POSITIONS_PACKED)
+        {
+            pipelineConfigInfo.bindingDescriptions = ArcModel::PackedPositionVertex::getBindingDescriptions();
+            pipelineConfigInfo.attributeDescriptions = ArcModel::PackedPositionVertex::getAttributeDescriptions();
+        }
+
         PipelineShaderConfigInfo shaderConfig{};
         shaderConfig.stageInfo.pSpecializationInfo = nullptr;
 
-        stencil = std::make_unique<ArcPipeline>(
+        return std::make_shared<ArcPipeline>(
             arcDevice,
-            "shaders/toon.vert.spv",
-            "shaders/toon.frag.spv",
+            PIPELINE_SHADERS[type].vertFilePath,
+            PIPELINE_SHADERS[type].fragFilePath,
             pipelineConfigInfo,
             shaderConfig);
+    }
 
-        pipelineConfigInfo.depthStencilInfo.back.compareOp = VK_COMPARE_OP_NOT_EQUAL;
-        pipelineConfigInfo.depthStencilInfo.back.failOp = VK_STENCIL_OP_KEEP;
-        pipelineConfigInfo.depthStencilInfo.back.depthFailOp = VK_STENCIL_OP_KEEP;
-        pipelineConfigInfo.depthStencilInfo.back.passOp = VK_STENCIL_OP_REPLACE;
-        pipelineConfigInfo.depthStencilInfo.front = pipelineConfigInfo.depthStencilInfo.back;
-        pipelineConfigInfo.depthStencilInfo.depthTestEnable = VK_FALSE;
-
-        outline = std::make_unique<ArcPipeline>(
-            arcDevice,
-            "shaders/outline.vert.spv",
-            "shaders/outline.frag.spv",
-            pipelineConfigInfo,
-            shaderConfig);
+    void StencilSystem::watchShaders(ArcHotReload &hotReload)
+    {
+        for (int type = 0; type < PIPELINE_TYPE_COUNT; ++type)
+        {
+            auto rebuild = [this, &hotReload, type]() -> ArcHotReload::Swap
+            {
+                auto pipeline = createPipeline(static_cast<PipelineType>(type));
+                return [this, &hotReload, type, pipeline]()
+                {
+                    hotReload.retire(std::move(pipelines[type]));
+                    pipelines[type] = pipeline;
+                    return true;
+                };
+            };
+            hotReload.watch(PIPELINE_SHADERS[type].vertFilePath, rebuild);
+            hotReload.watch(PIPELINE_SHADERS[type].fragFilePath, rebuild);
+        }
     }
 
     StencilSystem::~StencilSystem()
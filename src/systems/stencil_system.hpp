@@ -4,8 +4,10 @@
 #include "arc_device.hpp"
 #include "arc_pipeline.hpp"
 #include "arc_frame_info.hpp"
+#include "arc_hot_reload.hpp"
 
 // std
+#include <array>
 #include <memory>
 
 namespace arc
@@ -21,14 +23,34 @@ namespace arc
 
         void render(FrameInfo &frameInfo);
 
+        // rebuilds the pipelines using a SPIR-V file whenever it changes, the system has to outlive hotReload
+        void watchShaders(ArcHotReload &hotReload);
+
     private:
+        // each pass has a pipeline per vertex layout
+        enum PipelineType
+        {
+            STENCIL,
+            STENCIL_PACKED,
+            OUTLINE,
+            OUTLINE_PACKED,
+            // outline of models with a position stream, see ArcModel::PositionVertex
+            OUTLINE_POSITIONS,
+            OUTLINE_POSITIONS_PACKED,
+            PIPELINE_TYPE_COUNT
+        };
+
         void createPipelineLayout(VkDescriptorSetLayout globalSetLayout);
-        void createPipeline(VkRenderPass renderPass);
+        std::shared_ptr<ArcPipeline> createPipeline(PipelineType type) const;
+        // skipPositionStreams leaves out the models renderPositionStreams draws
+        void renderGameObjects(FrameInfo &frameInfo, bool packedVertices, bool skipPositionStreams);
+        void renderPositionStreams(FrameInfo &frameInfo, bool packedVertices);
+        void pushConstants(FrameInfo &frameInfo, ArcGameObject &obj);
 
     private:
         ArcDevice &arcDevice;
-        std::unique_ptr<ArcPipeline> stencil;
-        std::unique_ptr<ArcPipeline> outline;
+        VkRenderPass renderPass;
+        std::array<std::shared_ptr<ArcPipeline>, PIPELINE_TYPE_COUNT> pipelines{};
         VkPipelineLayout pipelineLayout;
     };
 }
@@ -0,0 +1,444 @@
+// Prints post-transform vertex cache statistics for every OBJ in models/,
+// before and after the index/vertex reordering done by ArcModel::Builder,
+// the decode error of the packed vertex layout, the outline pass vertex fetch with and without the position stream,
+// meshlet statistics with a check of the cluster bounds,
+// the triangle count and error of every generated level of detail,
+// the peak resident memory of the tinyobj parse against the streaming parser,
+// and the load time of every OBJ against the same mesh written out as .glb
+
+#include "arc_model.hpp"
+#include "arc_mesh_optimizer.hpp"
+#include "arc_mesh_simplifier.hpp"
+#include "arc_meshlet.hpp"
+#include "arc_vertex_quantization.hpp"
+
+// std
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifndef ENGINE_DIR
+#define ENGINE_DIR "../"
+#endif
+
+namespace
+{
+    struct ParseResult
+    {
+        size_t vertices = 0;
+        size_t triangles = 0;
+        long peakRssKb = -1; // growth of the resident set while parsing, -1 where it can't be measured
+    };
+
+#ifdef __linux__
+    long readStatusKb(const char *field)
+    {
+        std::ifstream status{"/proc/self/status"};
+        std::string line{};
+        while (std::getline(status, line))
+        {
+            if (line.rfind(field, 0) == 0)
+                return std::atol(line.c_str() + std::strlen(field) + 1);
+        }
+        return -1;
+    }
+#endif
+
+    // one mesh, one primitive, float attributes and 32-bit indices, all in the BIN chunk
+    void writeGlb(const std::string &path, const std::vector<arc::ArcModel::Vertex> &vertices, const std::vector<uint32_t> &indices)
+    {
+        const size_t count = vertices.size();
+        std::vector<uint8_t> bin{};
+        auto append = [&](const void *data, size_t size)
+        {
+            size_t offset = bin.size();
+            bin.resize(offset + size);
+            std::memcpy(bin.data() + offset, data, size);
+            return offset;
+        };
+
+        // interleaved like ArcModel::Vertex, every attribute reads through the same strided view
+        size_t vertexOffset = append(vertices.data(), count * sizeof(arc::ArcModel::Vertex));
+        size_t indexOffset = append(indices.data(), indices.size() * sizeof(uint32_t));
+
+        glm::vec3 minPosition{vertices.empty() ? glm::vec3{0.0f} : vertices[0].position};
+        glm::vec3 maxPosition = minPosition;
+        for (const auto &vertex : vertices)
+        {
+            minPosition = glm::min(minPosition, vertex.position);
+            maxPosition = glm::max(maxPosition, vertex.position);
+        }
+
+        char json[2048];
+        std::snprintf(json, sizeof(json),
+                      "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"mesh\":0}],"
+                      "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"COLOR_0\":1,\"NORMAL\":2,\"TEXCOORD_0\":3},\"indices\":4}]}],"
+                      "\"buffers\":[{\"byteLength\":%zu}],"
+                      "\"bufferViews\":[{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu,\"byteStride\":%zu},"
+                      "{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu}],"
+                      "\"accessors\":[{\"bufferView\":0,\"byteOffset\":%zu,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC3\","
+                      "\"min\":[%g,%g,%g],\"max\":[%g,%g,%g]},"
+                      "{\"bufferView\":0,\"byteOffset\":%zu,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC3\"},"
+                      "{\"bufferView\":0,\"byteOffset\":%zu,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC3\"},"
+                      "{\"bufferView\":0,\"byteOffset\":%zu,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC2\"},"
+                      "{\"bufferView\":1,\"componentType\":5125,\"count\":%zu,\"type\":\"SCALAR\"}]}",
+                      bin.size(),
+                      vertexOffset, count * sizeof(arc::ArcModel::Vertex), sizeof(arc::ArcModel::Vertex),
+                      indexOffset, indices.size() * sizeof(uint32_t),
+                      offsetof(arc::ArcModel::Vertex, position), count,
+                      minPosition.x, minPosition.y, minPosition.z, maxPosition.x, maxPosition.y, maxPosition.z,
+                      offsetof(arc::ArcModel::Vertex, color), count,
+                      offsetof(arc::ArcModel::Vertex, normal), count,
+                      offsetof(arc::ArcModel::Vertex, uv), count,
+                      indices.size());
+
+        // chunks are 4-byte aligned, JSON padded with spaces and BIN with zeros
+        std::string jsonChunk{json};
+        jsonChunk.resize((jsonChunk.size() + 3) & ~size_t{3}, ' ');
+        bin.resize((bin.size() + 3) & ~size_t{3}, 0);
+
+        uint32_t header[3] = {0x46546c67, 2, static_cast<uint32_t>(12 + 8 + jsonChunk.size() + 8 + bin.size())};
+        uint32_t jsonHeader[2] = {static_cast<uint32_t>(jsonChunk.size()), 0x4e4f534a};
+        uint32_t binHeader[2] = {static_cast<uint32_t>(bin.size()), 0x004e4942};
+
+        std::ofstream file{path, std::ios::binary};
+        file.write(reinterpret_cast<const char *>(header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(jsonHeader), sizeof(jsonHeader));
+        file.write(jsonChunk.data(), jsonChunk.size());
+        file.write(reinterpret_cast<const char *>(binHeader), sizeof(binHeader));
+        file.write(reinterpret_cast<const char *>(bin.data()), bin.size());
+    }
+
+    // best of a few uncached loads, without the mesh optimization or lods that both formats share
+    double measureLoad(const std::string &model, size_t &vertices, size_t &triangles)
+    {
+        double best = 0.0;
+        for (int run = 0; run < 3; ++run)
+        {
+            arc::ArcModel::Builder builder{};
+            builder.useCache = false;
+            builder.optimizeMesh = false;
+            builder.lodSettings.clear();
+
+            auto start = std::chrono::high_resolution_clock::now();
+            builder.loadModel(model);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+            best = run == 0 ? ms : std::min(best, ms);
+
+            vertices = builder.vertices.size();
+            triangles = builder.indices.size() / 3;
+        }
+        return best;
+    }
+
+    // parses in a child process, so every parser starts from the same resident set
+    ParseResult measureParse(const std::string &model, bool streamObj)
+    {
+        ParseResult result{};
+#ifdef __linux__
+        int channel[2];
+        if (pipe(channel) != 0)
+            return result;
+
+        pid_t child = fork();
+        if (child == 0)
+        {
+            close(channel[0]);
+            std::cout.setstate(std::ios::failbit);
+
+            // restart the high water mark from the current resident set
+            long baseline = readStatusKb("VmRSS:");
+            std::ofstream{"/proc/self/clear_refs"} << "5";
+
+            arc::ArcModel::Builder builder{};
+            builder.useCache = false;
+            builder.optimizeMesh = false;
+            builder.lodSettings.clear();
+            builder.streamObj = streamObj;
+            builder.loadModel(model);
+
+            ParseResult childResult{builder.vertices.size(), builder.indices.size() / 3, readStatusKb("VmHWM:") - baseline};
+            ssize_t written = write(channel[1], &childResult, sizeof(childResult));
+            _exit(written == sizeof(childResult) ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+
+        close(channel[1]);
+        if (child > 0 && read(channel[0], &result, sizeof(result)) != sizeof(result))
+        {
+            result = ParseResult{};
+        }
+        close(channel[0]);
+        if (child > 0)
+            waitpid(child, nullptr, 0);
+#else
+        arc::ArcModel::Builder builder{};
+        builder.useCache = false;
+        builder.optimizeMesh = false;
+        builder.lodSettings.clear();
+        builder.streamObj = streamObj;
+        builder.loadModel(model);
+        result.vertices = builder.vertices.size();
+        result.triangles = builder.indices.size() / 3;
+#endif
+        return result;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    // model directory relative to ENGINE_DIR, like every other asset path
+    std::string modelDir = argc > 1 ? argv[1] : "models";
+
+    std::vector<std::string> models{};
+    for (const auto &entry : std::filesystem::directory_iterator(std::string(ENGINE_DIR) + modelDir))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".obj")
+        {
+            models.push_back(modelDir + "/" + entry.path().filename().string());
+        }
+    }
+    std::sort(models.begin(), models.end());
+
+    std::printf("%-32s %10s %10s %16s %16s\n", "model", "triangles", "vertices", "ACMR", "ATVR");
+    std::vector<arc::ArcModel::Builder> builders(models.size());
+    for (size_t i = 0; i < models.size(); ++i)
+    {
+        const auto &model = models[i];
+        auto &builder = builders[i];
+        try
+        {
+            builder.useCache = false;
+            builder.optimizeMesh = false;
+            builder.lodSettings.clear();
+            builder.loadModel(model);
+
+            arc::VertexCacheStats before = arc::analyzeVertexCache(builder.indices, builder.vertices.size());
+            arc::optimizeVertexCache(builder.indices, builder.vertices.size());
+            arc::optimizeVertexFetch(builder.vertices, builder.indices);
+            arc::VertexCacheStats after = arc::analyzeVertexCache(builder.indices, builder.vertices.size());
+
+            std::printf("%-32s %10zu %10zu %7.3f -> %5.3f %7.3f -> %5.3f\n",
+                        model.c_str(), builder.indices.size() / 3, builder.vertices.size(),
+                        before.acmr, after.acmr, before.atvr, after.atvr);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << model << ": " << e.what() << '\n';
+        }
+    }
+
+    std::printf("\npacked vertices (%zu -> %zu bytes), max decode error\n",
+                sizeof(arc::ArcModel::Vertex), sizeof(arc::ArcModel::PackedVertex));
+    std::printf("%-32s %12s %10s %10s %10s %10s\n", "model", "position", "% extent", "normal", "color", "uv");
+    for (size_t i = 0; i < models.size(); ++i)
+    {
+        const auto &vertices = builders[i].vertices;
+        if (vertices.empty())
+            continue;
+
+        arc::VertexQuantization quantization = arc::computeVertexQuantization(vertices);
+        auto packed = arc::packVertices(vertices, quantization);
+        arc::VertexQuantizationError error = arc::measureQuantizationError(vertices, packed, quantization);
+
+        std::printf("%-32s %12.3g %9.5f%% %7.4f deg %10.4f %10.3g\n",
+                    models[i].c_str(), error.position, 100.0f * error.position / quantization.scale,
+                    error.normalDegrees, error.color, error.uv);
+    }
+
+    // the outline pass only reads position and normal, from the whole vertex or from the position stream
+    std::printf("\noutline pass vertex fetch (KB, after optimization)\n");
+    std::printf("%-32s %10s %10s %8s %10s %10s %8s\n", "model", "vertex", "positions", "saved", "packed", "positions", "saved");
+    for (size_t i = 0; i < models.size(); ++i)
+    {
+        const auto &indices = builders[i].indices;
+        size_t vertexCount = builders[i].vertices.size();
+        if (indices.empty())
+            continue;
+
+        auto fetchedKb = [&](size_t stride)
+        {
+            return arc::analyzeVertexFetch(indices, vertexCount, static_cast<uint32_t>(stride)).bytesFetched / 1024.0;
+        };
+        double full = fetchedKb(sizeof(arc::ArcModel::Vertex));
+        double positions = fetchedKb(sizeof(arc::ArcModel::PositionVertex));
+        double packed = fetchedKb(sizeof(arc::ArcModel::PackedVertex));
+        double packedPositions = fetchedKb(sizeof(arc::ArcModel::PackedPositionVertex));
+
+        std::printf("%-32s %10.1f %10.1f %7.1f%% %10.1f %10.1f %7.1f%%\n", models[i].c_str(),
+                    full, positions, 100.0 * (1.0 - positions / full),
+                    packed, packedPositions, 100.0 * (1.0 - packedPositions / packed));
+    }
+
+    std::printf("\nmeshlets (max %u vertices, %u triangles)\n", arc::MESHLET_MAX_VERTICES, arc::MESHLET_MAX_TRIANGLES);
+    std::printf("%-32s %10s %10s %10s %12s %8s\n", "model", "meshlets", "avg verts", "avg tris", "cone culls", "bounds");
+    bool allBoundsValid = true;
+    for (size_t i = 0; i < models.size(); ++i)
+    {
+        const auto &vertices = builders[i].vertices;
+        const auto &indices = builders[i].indices;
+        if (indices.empty())
+            continue;
+
+        arc::MeshletData data{};
+        arc::buildMeshlets(data, indices, &vertices[0].position.x, sizeof(arc::ArcModel::Vertex));
+
+        // every triangle must come back exactly once, every vertex must sit in the sphere
+        // and every non-degenerate triangle normal must sit inside the normal cone
+        bool valid = true;
+        std::vector<std::array<uint32_t, 3>> expected(indices.size() / 3);
+        std::vector<std::array<uint32_t, 3>> rebuilt{};
+        for (size_t t = 0; t < expected.size(); ++t)
+        {
+            expected[t] = {indices[3 * t + 0], indices[3 * t + 1], indices[3 * t + 2]};
+        }
+        size_t coneCullable = 0;
+        size_t totalVertices = 0;
+        for (size_t m = 0; m < data.meshlets.size(); ++m)
+        {
+            const arc::Meshlet &meshlet = data.meshlets[m];
+            const arc::MeshletBounds &bounds = data.bounds[m];
+            totalVertices += meshlet.vertexCount;
+            valid = valid && meshlet.vertexCount <= arc::MESHLET_MAX_VERTICES &&
+                    meshlet.triangleCount <= arc::MESHLET_MAX_TRIANGLES &&
+                    meshlet.triangleOffset % 4 == 0;
+
+            float tolerance = 1e-4f * std::max(bounds.radius, 1.0f);
+            for (uint32_t v = 0; v < meshlet.vertexCount; ++v)
+            {
+                glm::vec3 p = vertices[data.vertices[meshlet.vertexOffset + v]].position;
+                valid = valid && glm::length(p - bounds.center) <= bounds.radius + tolerance;
+            }
+
+            if (bounds.coneCutoff < 1.0f)
+                coneCullable++;
+            float minDot = std::sqrt(1.0f - bounds.coneCutoff * bounds.coneCutoff);
+            for (uint32_t t = 0; t < meshlet.triangleCount; ++t)
+            {
+                std::array<uint32_t, 3> corner{};
+                for (int k = 0; k < 3; ++k)
+                {
+                    uint8_t local = data.triangles[meshlet.triangleOffset + 3 * t + k];
+                    valid = valid && local < meshlet.vertexCount;
+                    corner[k] = data.vertices[meshlet.vertexOffset + local];
+                }
+                rebuilt.push_back(corner);
+
+                glm::vec3 p0 = vertices[corner[0]].position;
+                glm::vec3 normal = glm::cross(vertices[corner[1]].position - p0, vertices[corner[2]].position - p0);
+                float area = glm::length(normal);
+                if (bounds.coneCutoff < 1.0f && area > 0.0f)
+                {
+                    valid = valid && glm::dot(normal / area, bounds.coneAxis) >= minDot - 1e-4f;
+                }
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+        std::sort(rebuilt.begin(), rebuilt.end());
+        valid = valid && expected == rebuilt;
+        allBoundsValid = allBoundsValid && valid;
+
+        std::printf("%-32s %10zu %10.1f %10.1f %11.1f%% %8s\n",
+                    models[i].c_str(), data.meshlets.size(),
+                    float(totalVertices) / float(data.meshlets.size()),
+                    float(indices.size() / 3) / float(data.meshlets.size()),
+                    100.0f * float(coneCullable) / float(data.meshlets.size()),
+                    valid ? "ok" : "FAILED");
+    }
+
+    // same settings as the loader, errors relative to the bounding box diagonal
+    const auto lodSettings = arc::ArcModel::Builder{}.lodSettings;
+    std::printf("\nlevels of detail (triangles, error)\n");
+    std::printf("%-32s %10s", "model", "lod 0");
+    for (size_t l = 0; l < lodSettings.size(); ++l)
+    {
+        std::printf("   lod %zu (%3.0f%%, %.3f)", l + 1, 100.0f * lodSettings[l].triangleRatio, lodSettings[l].maxError);
+    }
+    std::printf("\n");
+    for (size_t i = 0; i < models.size(); ++i)
+    {
+        const auto &vertices = builders[i].vertices;
+        const auto &indices = builders[i].indices;
+        if (indices.empty())
+            continue;
+
+        std::printf("%-32s %10zu", models[i].c_str(), indices.size() / 3);
+        for (const auto &settings : lodSettings)
+        {
+            size_t targetIndexCount = static_cast<size_t>(indices.size() / 3 * settings.triangleRatio) * 3;
+            float error = 0.0f;
+            auto lod = arc::simplifyMesh(indices, &vertices[0].position.x, sizeof(arc::ArcModel::Vertex),
+                                         vertices.size(), targetIndexCount, settings.maxError, &error);
+            std::printf(" %10zu %12.5f", lod.size() / 3, error);
+        }
+        std::printf("\n");
+    }
+
+    // the streaming parser welds by v/vt/vn indices, so its vertex count may be slightly higher
+    std::printf("\nobj parsers (vertices, triangles, peak RSS growth)\n");
+    std::printf("%-32s %10s %10s %12s %10s %10s %12s\n", "model", "tinyobj", "", "", "stream", "", "");
+    for (const auto &model : models)
+    {
+        ParseResult tinyobj = measureParse(model, false);
+        ParseResult stream = measureParse(model, true);
+        std::printf("%-32s %10zu %10zu %9ld KB %10zu %10zu %9ld KB\n", model.c_str(),
+                    tinyobj.vertices, tinyobj.triangles, tinyobj.peakRssKb,
+                    stream.vertices, stream.triangles, stream.peakRssKb);
+    }
+
+    // the glb holds the welded mesh the OBJ path produced, written next to the source and removed afterwards
+    std::printf("\nload time, obj against glb (vertices, triangles, ms)\n");
+    std::cout.setstate(std::ios::failbit);
+    std::vector<std::string> loadRows{};
+    for (size_t i = 0; i < models.size(); ++i)
+    {
+        if (builders[i].indices.empty())
+            continue;
+
+        std::string glbModel = models[i].substr(0, models[i].size() - 4) + ".report.glb";
+        std::string glbPath = std::string(ENGINE_DIR) + glbModel;
+        writeGlb(glbPath, builders[i].vertices, builders[i].indices);
+
+        size_t objVertices = 0, objTriangles = 0, glbVertices = 0, glbTriangles = 0;
+        double objMs = measureLoad(models[i], objVertices, objTriangles);
+        double glbMs = 0.0;
+        try
+        {
+            glbMs = measureLoad(glbModel, glbVertices, glbTriangles);
+        }
+        catch (const std::exception &e)
+        {
+            std::fprintf(stderr, "%s: %s\n", glbModel.c_str(), e.what());
+        }
+        std::filesystem::remove(glbPath);
+
+        char row[256];
+        std::snprintf(row, sizeof(row), "%-32s %10zu %10zu %10.2f %10zu %10zu %10.2f %8.1fx",
+                      models[i].c_str(), objVertices, objTriangles, objMs, glbVertices, glbTriangles, glbMs,
+                      glbMs > 0.0 ? objMs / glbMs : 0.0);
+        loadRows.push_back(row);
+    }
+    std::cout.clear();
+    std::printf("%-32s %10s %10s %10s %10s %10s %10s %9s\n", "model", "obj", "", "", "glb", "", "", "speedup");
+    for (const auto &row : loadRows)
+    {
+        std::printf("%s\n", row.c_str());
+    }
+
+    return allBoundsValid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
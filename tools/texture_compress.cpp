@@ -0,0 +1,135 @@
+// Compresses an image into a BC1, BC3 or BC7 KTX2 file with a full mip chain, written next to the source
+// usage: TextureCompress <image relative to ENGINE_DIR> [bc1|bc3|bc7] [--linear]
+// BC7 is the default, --linear marks data textures such as normal maps that aren't sRGB encoded
+// prints the size against RGBA8 and the PSNR of every level
+
+#include "arc_block_compression.hpp"
+#include "arc_ktx2.hpp"
+#include "arc_mip_chain.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef ENGINE_DIR
+#define ENGINE_DIR "../"
+#endif
+
+namespace
+{
+    // over the channels the format stores, BC1 has no alpha
+    double psnr(const uint8_t *reference, const std::vector<uint8_t> &decoded, int channels)
+    {
+        double squaredError = 0.0;
+        size_t count = 0;
+        for (size_t i = 0; i < decoded.size(); ++i)
+        {
+            if (static_cast<int>(i % 4) >= channels)
+                continue;
+            double d = static_cast<double>(decoded[i]) - reference[i];
+            squaredError += d * d;
+            count++;
+        }
+        if (squaredError == 0.0)
+            return INFINITY;
+        return 10.0 * std::log10(255.0 * 255.0 * count / squaredError);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s <image> [bc1|bc3|bc7] [--linear]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::string imagepath = argv[1];
+    arc::BlockFormat format = arc::BlockFormat::BC7;
+    bool srgb = true;
+    for (int i = 2; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "bc1") == 0)
+            format = arc::BlockFormat::BC1;
+        else if (std::strcmp(argv[i], "bc3") == 0)
+            format = arc::BlockFormat::BC3;
+        else if (std::strcmp(argv[i], "bc7") == 0)
+            format = arc::BlockFormat::BC7;
+        else if (std::strcmp(argv[i], "--linear") == 0)
+            srgb = false;
+        else
+        {
+            std::fprintf(stderr, "unknown argument %s\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::string enginePath = ENGINE_DIR + imagepath;
+    int texWidth, texHeight, texChannels;
+    stbi_uc *pixels = stbi_load(enginePath.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+    if (!pixels)
+    {
+        std::fprintf(stderr, "failed to load %s\n", enginePath.c_str());
+        return EXIT_FAILURE;
+    }
+
+    uint32_t width = static_cast<uint32_t>(texWidth);
+    uint32_t height = static_cast<uint32_t>(texHeight);
+    uint32_t mipLevels = arc::mipLevelCount(width, height);
+    std::vector<uint64_t> levelOffsets{};
+    std::vector<uint8_t> chain = arc::buildMipChain(pixels, width, height, mipLevels, srgb, levelOffsets);
+    stbi_image_free(pixels);
+
+    const char *formatNames[] = {"BC1", "BC3", "BC7"};
+    int channels = format == arc::BlockFormat::BC1 ? 3 : 4;
+    std::printf("%s: %ux%u, %u levels, %s %s\n", imagepath.c_str(), width, height, mipLevels,
+                formatNames[static_cast<int>(format)], srgb ? "sRGB" : "linear");
+    std::printf("%6s %12s %10s %10s %10s\n", "level", "size", "KB", "ms", "PSNR");
+
+    std::vector<std::vector<uint8_t>> levels{};
+    size_t compressedBytes = 0;
+    for (uint32_t level = 0; level < mipLevels; ++level)
+    {
+        uint32_t levelWidth = std::max(width >> level, 1u);
+        uint32_t levelHeight = std::max(height >> level, 1u);
+        const uint8_t *texels = chain.data() + levelOffsets[level];
+
+        auto startTime = std::chrono::steady_clock::now();
+        levels.push_back(arc::compressBlocks(texels, levelWidth, levelHeight, format));
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        compressedBytes += levels.back().size();
+
+        std::vector<uint8_t> decoded = arc::decompressBlocks(levels.back().data(), levelWidth, levelHeight, format);
+        char size[32];
+        std::snprintf(size, sizeof(size), "%ux%u", levelWidth, levelHeight);
+        std::printf("%6u %12s %10.1f %10.2f %10.2f\n", level, size, levels.back().size() / 1024.0, milliseconds,
+                    psnr(texels, decoded, channels));
+    }
+
+    std::string outputPath = std::filesystem::path{enginePath}.replace_extension(".ktx2").string();
+    try
+    {
+        arc::writeKtx2(outputPath, format, srgb, width, height, levels);
+    }
+    catch (const std::exception &e)
+    {
+        std::fprintf(stderr, "%s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    std::printf("wrote %s, %.1f KB against %.1f KB as RGBA8 (%.1fx smaller)\n", outputPath.c_str(),
+                compressedBytes / 1024.0, chain.size() / 1024.0, static_cast<double>(chain.size()) / compressedBytes);
+    return EXIT_SUCCESS;
+}